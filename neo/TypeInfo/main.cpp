@@ -276,6 +276,20 @@ void			Sys_LeaveCriticalSection( int index ) {}
 void			Sys_WaitForEvent( int index ) {}
 void			Sys_TriggerEvent( int index ) {}
 
+void			Sys_StartJobThreads( int numThreads ) {}
+void			Sys_ShutdownJobThreads() {}
+int				Sys_NumJobThreads()
+{
+	return 0;
+}
+void			Sys_RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs )
+{
+	for( int i = 0; i < numJobs; i++ )
+	{
+		function( ( byte* )parms + i * parmSize );
+	}
+}
+
 /*
 ==============
 idSysLocal stub
@@ -363,6 +377,15 @@ void			idSysLocal::StartProcess( const char* exeName, bool quit ) { }
 
 void			idSysLocal::FPU_EnableExceptions( int exceptions ) { }
 
+int				idSysLocal::NumJobThreads()
+{
+	return Sys_NumJobThreads();
+}
+void			idSysLocal::RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs )
+{
+	Sys_RunJobs( function, parms, parmSize, numJobs );
+}
+
 idSysLocal		sysLocal;
 idSys* 			sys = &sysLocal;
 
@@ -72,6 +72,7 @@ idCVar com_asyncInput( "com_asyncInput", "0", CVAR_BOOL | CVAR_SYSTEM, "sample i
 #else
 	idCVar com_asyncSound( "com_asyncSound", "1", CVAR_INTEGER | CVAR_SYSTEM, ASYNCSOUND_INFO, 0, 1 );
 #endif
+idCVar com_jobThreads( "com_jobThreads", "-1", CVAR_INTEGER | CVAR_SYSTEM | CVAR_INIT, "number of worker threads for parallel jobs, -1 = one less than the number of processors", -1, MAX_JOB_THREADS );
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "force generic platform independent SIMD" );
 idCVar com_developer( "developer", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "developer mode" );
 idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "allow toggling console with the tilde key" );
@@ -3207,6 +3208,9 @@ void idCommonLocal::Init( int argc, const char** argv, const char* cmdline )
 		// initialize processor specific SIMD implementation
 		InitSIMD();
 
+		// start the worker threads for parallel jobs
+		Sys_StartJobThreads( com_jobThreads.GetInteger() );
+
 		// init commands
 		InitCommands();
 
@@ -3269,6 +3273,9 @@ void idCommonLocal::Shutdown()
 	// game specific shut down
 	ShutdownGame( false );
 
+	// stop the worker threads for parallel jobs
+	Sys_ShutdownJobThreads();
+
 	// shut down non-portable system services
 	Sys_Shutdown();
 
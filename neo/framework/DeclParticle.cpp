@@ -1532,6 +1532,210 @@ int idParticleStage::CreateParticle( particleGen_t* g, idDrawVert* verts ) const
 	return numVerts * 2;
 }
 
+/*
+================
+idParticleStage::CreateParticles
+
+Works through the gens in batches, evaluating the colors, origins and
+view oriented quads of a whole batch at a time, with the entity and view
+dependent vectors calculated once. Every particle still consumes its own
+random numbers in the same order CreateParticle does, so the result is
+identical.
+================
+*/
+int idParticleStage::CreateParticles( particleGen_t* gens, int numGens, idDrawVert* verts ) const
+{
+	const int	PARTICLE_BATCH = 64;
+	float		fade[PARTICLE_BATCH];
+	byte		colors[PARTICLE_BATCH][4];
+	int			live[PARTICLE_BATCH];
+	idVec3		origins[PARTICLE_BATCH];
+	float		width[PARTICLE_BATCH];
+	float		height[PARTICLE_BATCH];
+	float		sins[PARTICLE_BATCH];
+	float		coss[PARTICLE_BATCH];
+	idVec3		entityLeft, entityUp;
+	int			i, j, numLive, numVerts;
+
+	if( numGens <= 0 )
+	{
+		return 0;
+	}
+
+	// every live particle creates the same number of verts
+	const int particleVerts = 4 * NumQuadsPerParticle();
+	const bool viewOriented = ( orientation != POR_AIMED && orientation != POR_X && orientation != POR_Y && orientation != POR_Z );
+
+	if( viewOriented )
+	{
+		gens[0].renderEnt->axis.ProjectVector( gens[0].renderView->viewaxis[1], entityLeft );
+		gens[0].renderEnt->axis.ProjectVector( gens[0].renderView->viewaxis[2], entityUp );
+	}
+
+	numVerts = 0;
+
+	for( int first = 0 ; first < numGens ; first += PARTICLE_BATCH )
+	{
+		const int batch = Min( numGens - first, PARTICLE_BATCH );
+		particleGen_t* batchGens = gens + first;
+
+		// fade fractions, the same way ParticleColors calculates them
+		for( i = 0 ; i < batch ; i++ )
+		{
+			const particleGen_t* g = &batchGens[i];
+			float fadeFraction = 1.0f;
+
+			if( g->frac < fadeInFraction )
+			{
+				fadeFraction *= ( g->frac / fadeInFraction );
+			}
+			if( 1.0f - g->frac < fadeOutFraction )
+			{
+				fadeFraction *= ( ( 1.0f - g->frac ) / fadeOutFraction );
+			}
+			if( fadeIndexFraction )
+			{
+				float	indexFrac = ( totalParticles - g->index ) / ( float )totalParticles;
+				if( indexFrac < fadeIndexFraction )
+				{
+					fadeFraction *= indexFrac / fadeIndexFraction;
+				}
+			}
+			fade[i] = fadeFraction;
+		}
+
+		// colors, and drop the particles that are completely faded out
+		numLive = 0;
+		for( i = 0 ; i < batch ; i++ )
+		{
+			for( j = 0 ; j < 4 ; j++ )
+			{
+				float	fcolor = ( ( entityColor ) ? batchGens[i].renderEnt->shaderParms[j] : color[j] ) * fade[i] + fadeColor[j] * ( 1.0f - fade[i] );
+				int		icolor = idMath::FtoiFast( fcolor * 255.0f );
+				if( icolor < 0 )
+				{
+					icolor = 0;
+				}
+				else if( icolor > 255 )
+				{
+					icolor = 255;
+				}
+				colors[numLive][j] = icolor;
+			}
+			if( colors[numLive][0] | colors[numLive][1] | colors[numLive][2] | colors[numLive][3] )
+			{
+				live[numLive++] = i;
+			}
+		}
+
+		// origins
+		for( i = 0 ; i < numLive ; i++ )
+		{
+			ParticleOrigin( &batchGens[live[i]], origins[i] );
+		}
+
+		for( i = 0 ; i < numLive ; i++ )
+		{
+			idDrawVert* v = verts + numVerts + i * particleVerts;
+
+			v[0].Clear();
+			v[1].Clear();
+			v[2].Clear();
+			v[3].Clear();
+
+			for( j = 0 ; j < 4 ; j++ )
+			{
+				v[0].color[j] = v[1].color[j] = v[2].color[j] = v[3].color[j] = colors[i][j];
+			}
+
+			ParticleTexCoords( &batchGens[live[i]], v );
+		}
+
+		if( viewOriented )
+		{
+			// the random angles have to be taken after the origins of each particle
+			for( i = 0 ; i < numLive ; i++ )
+			{
+				particleGen_t* g = &batchGens[live[i]];
+
+				width[i] = size.Eval( g->frac, g->random );
+				height[i] = width[i] * aspect.Eval( g->frac, g->random );
+
+				float angle = ( initialAngle ) ? initialAngle : 360 * g->random.RandomFloat();
+				float angleMove = rotationSpeed.Integrate( g->frac, g->random ) * particleLife;
+				if( g->index & 1 )
+				{
+					angle += angleMove;
+				}
+				else
+				{
+					angle -= angleMove;
+				}
+				angle = angle / 180 * idMath::PI;
+				coss[i] = idMath::Cos16( angle );
+				sins[i] = idMath::Sin16( angle );
+			}
+
+			for( i = 0 ; i < numLive ; i++ )
+			{
+				idDrawVert* v = verts + numVerts + i * particleVerts;
+				idVec3 left = entityLeft * coss[i] + entityUp * sins[i];
+				idVec3 up = entityUp * coss[i] - entityLeft * sins[i];
+
+				left *= width[i];
+				up *= height[i];
+
+				v[0].xyz = origins[i] - left + up;
+				v[1].xyz = origins[i] + left + up;
+				v[2].xyz = origins[i] - left - up;
+				v[3].xyz = origins[i] + left - up;
+			}
+		}
+		else
+		{
+			for( i = 0 ; i < numLive ; i++ )
+			{
+				ParticleVerts( &batchGens[live[i]], origins[i], verts + numVerts + i * particleVerts );
+			}
+		}
+
+		// if we are doing strip-animation, we need to double the quads and cross fade them
+		if( animationFrames > 1 )
+		{
+			float	frameWidth = 1.0f / animationFrames;
+			int		quadVerts = particleVerts / 2;
+
+			for( i = 0 ; i < numLive ; i++ )
+			{
+				idDrawVert* v = verts + numVerts + i * particleVerts;
+				float	frac = batchGens[live[i]].animationFrameFrac;
+				float	iFrac = 1.0f - frac;
+
+				for( j = 0 ; j < quadVerts ; j++ )
+				{
+					v[quadVerts + j] = v[j];
+
+					v[quadVerts + j].st[0] += frameWidth;
+
+					v[quadVerts + j].color[0] *= frac;
+					v[quadVerts + j].color[1] *= frac;
+					v[quadVerts + j].color[2] *= frac;
+					v[quadVerts + j].color[3] *= frac;
+
+					v[j].color[0] *= iFrac;
+					v[j].color[1] *= iFrac;
+					v[j].color[2] *= iFrac;
+					v[j].color[3] *= iFrac;
+				}
+			}
+		}
+
+		numVerts += numLive * particleVerts;
+	}
+
+	return numVerts;
+}
+
 /*
 ==================
 idParticleStage::GetCustomPathName
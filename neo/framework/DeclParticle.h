@@ -121,6 +121,9 @@ public:
 	virtual int				NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	virtual int				CreateParticle( particleGen_t* g, idDrawVert* verts ) const;
+	// creates the particles for a whole list of gens that share the renderEnt and renderView,
+	// with exactly the same result as calling CreateParticle for each of them in order
+	virtual int				CreateParticles( particleGen_t* gens, int numGens, idDrawVert* verts ) const;
 
 	void					ParticleOrigin( particleGen_t* g, idVec3& origin ) const;
 	int						ParticleVerts( particleGen_t* g, const idVec3 origin, idDrawVert* verts ) const;
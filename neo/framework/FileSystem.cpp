@@ -4188,6 +4188,9 @@ dword BackgroundDownloadThread( void* parms )
 
 		if( bgl->opcode == DLTYPE_FILE )
 		{
+			// honor the position, several reads can be queued on the same file
+			fseek( static_cast<idFile_Permanent*>( bgl->f )->GetFilePtr(), bgl->file.position, SEEK_SET );
+
 			// use the low level read function, because fread may allocate memory
 #if 0 // RB FIXME defined(WIN32)
 			_read( static_cast<idFile_Permanent*>( bgl->f )->GetFilePtr()->_file, bgl->file.buffer, bgl->file.length );
@@ -1624,8 +1624,6 @@ idActor::CanSee
 */
 bool idActor::CanSee( idEntity* ent, bool useFov ) const
 {
-	trace_t		tr;
-	idVec3		eye;
 	idVec3		toPos;
 
 	if( ent->IsHidden() )
@@ -1647,15 +1645,7 @@ bool idActor::CanSee( idEntity* ent, bool useFov ) const
 		return false;
 	}
 
-	eye = GetEyePosition();
-
-	gameLocal.clip.TracePoint( tr, eye, toPos, MASK_OPAQUE, this );
-	if( tr.fraction >= 1.0f || ( gameLocal.GetTraceEntity( tr ) == ent ) )
-	{
-		return true;
-	}
-
-	return false;
+	return gameLocal.CanSee( this, GetEyePosition(), ent, toPos );
 }
 
 /*
@@ -1619,7 +1619,7 @@ bool idEntity::UpdateRenderEntity( renderEntity_s* renderEntity, const renderVie
 	idAnimator* animator = GetAnimator();
 	if( animator )
 	{
-		return animator->CreateFrame( gameLocal.time, false );
+		return animator->CreateFrame( gameLocal.time, false, renderView );
 	}
 
 	return false;
@@ -221,6 +221,10 @@ void idGameLocal::Clear()
 	gravity.Set( 0, 0, -1 );
 	playerPVS.h = ( unsigned int ) - 1;
 	playerConnectedAreas.h = ( unsigned int ) - 1;
+	sightQueryHash.Clear( 256, MAX_SIGHT_QUERIES );
+	numSightQueries = 0;
+	memset( sightStats, 0, sizeof( sightStats ) );
+	sightStatsTime = 0;
 	gamestate = GAMESTATE_UNINITIALIZED;
 	skipCinematic = false;
 	influenceActive = false;
@@ -988,6 +992,7 @@ void idGameLocal::LoadMap( const char* mapName, int randseed )
 	pvs.Init();
 	playerPVS.i = -1;
 	playerConnectedAreas.i = -1;
+	ClearSightQueries();
 
 	// load navigation system for all the different monster sizes
 	for( i = 0; i < aasNames.Num(); i++ )
@@ -2323,6 +2328,160 @@ const idVec3& idGameLocal::GetGravity() const
 	return gravity;
 }
 
+/*
+================
+idGameLocal::ClearSightQueries
+================
+*/
+void idGameLocal::ClearSightQueries()
+{
+	sightQueryHash.Clear();
+	numSightQueries = 0;
+}
+
+/*
+================
+idGameLocal::ShowSightStats
+
+prints the line of sight counters once a second
+================
+*/
+void idGameLocal::ShowSightStats()
+{
+	if( ( time >= sightStatsTime ) && ( time - sightStatsTime < 1000 ) )
+	{
+		return;
+	}
+
+	if( ai_showSightStats.GetBool() && ( time > sightStatsTime ) )
+	{
+		float scale = 1000.0f / ( time - sightStatsTime );
+		Printf( "sight tests/sec: %4.0f traced, %4.0f shared, %4.0f culled by PVS\n",
+				sightStats[ SIGHT_TRACED ] * scale, sightStats[ SIGHT_SHARED ] * scale, sightStats[ SIGHT_CULLED ] * scale );
+	}
+
+	memset( sightStats, 0, sizeof( sightStats ) );
+	sightStatsTime = time;
+}
+
+/*
+================
+idGameLocal::CanSee
+
+  Tests of the same viewer and target from the same positions share the first result
+  within a frame, AI scripts usually test the enemy again after UpdateEnemyPosition did.
+  The trace is skipped when neither the target position nor the target bounds are in
+  the PVS of the eye, a trace can't pass from one area to another outside the PVS.
+================
+*/
+bool idGameLocal::CanSee( const idEntity* viewer, const idVec3& eye, const idEntity* target, const idVec3& targetPos )
+{
+	int			i, hash, eyeArea, numAreas;
+	int			areas[ idEntity::MAX_PVS_AREAS + 1 ];
+	bool		visible;
+	trace_t		tr;
+
+	if( !ai_sightCache.GetBool() )
+	{
+		clip.TracePoint( tr, eye, targetPos, MASK_OPAQUE, viewer );
+		return ( tr.fraction >= 1.0f || ( GetTraceEntity( tr ) == target ) );
+	}
+
+	hash = sightQueryHash.GenerateKey( viewer->entityNumber, target->entityNumber );
+	for( i = sightQueryHash.First( hash ); i != -1; i = sightQueryHash.Next( i ) )
+	{
+		const sightQuery_t& query = sightQueries[ i ];
+		if( query.viewerNum == viewer->entityNumber && query.targetNum == target->entityNumber &&
+				query.eye.Compare( eye ) && query.target.Compare( targetPos ) )
+		{
+			sightStats[ SIGHT_SHARED ]++;
+			return query.visible;
+		}
+	}
+
+	visible = true;
+	eyeArea = pvs.GetPVSArea( eye );
+	// the trace can stop on the target before it reaches the target position
+	numAreas = pvs.GetPVSAreas( target->GetPhysics()->GetAbsBounds(), areas, idEntity::MAX_PVS_AREAS );
+	if( eyeArea >= 0 && numAreas < idEntity::MAX_PVS_AREAS )
+	{
+		areas[ numAreas++ ] = pvs.GetPVSArea( targetPos );
+		for( i = 0; i < numAreas; i++ )
+		{
+			if( areas[ i ] < 0 || pvs.InAreaPVS( eyeArea, areas[ i ] ) )
+			{
+				break;
+			}
+		}
+		visible = ( i < numAreas );
+	}
+
+	if( visible )
+	{
+		clip.TracePoint( tr, eye, targetPos, MASK_OPAQUE, viewer );
+		visible = ( tr.fraction >= 1.0f || ( GetTraceEntity( tr ) == target ) );
+		sightStats[ SIGHT_TRACED ]++;
+	}
+	else
+	{
+		sightStats[ SIGHT_CULLED ]++;
+	}
+
+	if( numSightQueries < MAX_SIGHT_QUERIES )
+	{
+		sightQuery_t& query = sightQueries[ numSightQueries ];
+		query.viewerNum = viewer->entityNumber;
+		query.targetNum = target->entityNumber;
+		query.eye = eye;
+		query.target = targetPos;
+		query.visible = visible;
+		sightQueryHash.Add( hash, numSightQueries );
+		numSightQueries++;
+	}
+
+	return visible;
+}
+
+/*
+================
+idGameLocal::CalculateAIRoutes
+
+  Calculates the routes of the AI moving towards a goal area on the job threads
+  before they think, so the routing caches are up to date when they path.
+================
+*/
+void idGameLocal::CalculateAIRoutes()
+{
+	int					i;
+	idEntity* 			ent;
+	aasRoute_t			route;
+	idList<aasRoute_t>	routes;
+
+	if( aas_parallelRouting.GetInteger() <= 0 || !sys->NumJobThreads() )
+	{
+		return;
+	}
+
+	routes.SetGranularity( 64 );
+	for( i = 0; i < aasList.Num(); i++ )
+	{
+		routes.SetNum( 0, false );
+		for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() )
+		{
+			if( ent->IsType( idAI::Type ) && static_cast<idAI*>( ent )->GetMoveRoute( route ) == aasList[i] )
+			{
+				routes.Append( route );
+			}
+		}
+
+		// not worth it when the routes won't be split over the job threads
+		if( routes.Num() >= aas_parallelRouting.GetInteger() * 2 )
+		{
+			aasList[i]->RoutesToGoalAreas( routes.Ptr(), routes.Num() );
+		}
+	}
+}
+
 /*
 ================
 idGameLocal::SortActiveEntityList
@@ -2493,9 +2652,15 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t* clientCmds )
 			// create a merged pvs for all players
 			SetupPlayerPVS();
 
+			// line of sight tests are only shared within a frame
+			ClearSightQueries();
+
 			// sort the active entity list
 			SortActiveEntityList();
 
+			// route the moving AI together
+			CalculateAIRoutes();
+
 			timer_think.Clear();
 			timer_think.Start();
 
@@ -2593,6 +2758,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t* clientCmds )
 						timer_think.Milliseconds(), timer_events.Milliseconds(), num );
 			}
 
+			animationLib.ShowFrameStats( time );
+			ShowSightStats();
+
 			// build the return value
 			ret.consistencyHash = 0;
 			ret.sessionCommand[0] = 0;
@@ -254,6 +254,28 @@ private:
 
 //============================================================================
 
+// line of sight test shared by all tests of the same viewer and positions within a frame
+typedef struct
+{
+	int						viewerNum;
+	int						targetNum;
+	idVec3					eye;
+	idVec3					target;
+	bool					visible;
+} sightQuery_t;
+
+const int MAX_SIGHT_QUERIES = 1024;
+
+typedef enum
+{
+	SIGHT_TRACED,
+	SIGHT_SHARED,
+	SIGHT_CULLED,
+	SIGHT_NUM_STATS
+} sightStat_t;
+
+//============================================================================
+
 class idGameLocal : public idGame
 {
 public:
@@ -479,6 +501,8 @@ public:
 	idEntity* 				SelectInitialSpawnPoint( idPlayer* player );
 
 	void					SetPortalState( qhandle_t portal, int blockingBits );
+	// line of sight from the eye to the target position, true if nothing blocks it or the target entity is hit first
+	bool					CanSee( const idEntity* viewer, const idVec3& eye, const idEntity* target, const idVec3& targetPos );
 	void					SaveEntityNetworkEvent( const idEntity* ent, int event, const idBitMsg* msg );
 	void					ServerSendChatMessage( int to, const char* name, const char* text );
 	int						ServerRemapDecl( int clientNum, declType_t type, int index );
@@ -524,6 +548,12 @@ private:
 	pvsHandle_t				playerPVS;				// merged pvs of all players
 	pvsHandle_t				playerConnectedAreas;	// all areas connected to any player area
 
+	sightQuery_t			sightQueries[MAX_SIGHT_QUERIES];	// line of sight tests of the current frame
+	idHashIndex				sightQueryHash;			// hash on the viewer and target entity numbers
+	int						numSightQueries;
+	int						sightStats[SIGHT_NUM_STATS];
+	int						sightStatsTime;
+
 	idVec3					gravity;				// global gravity vector
 	gameState_t				gamestate;				// keeps track of whether we're spawning, shutting down, or normal gameplay
 	bool					influenceActive;		// true when a phantasm is happening
@@ -564,6 +594,9 @@ private:
 	void					FreePlayerPVS();
 	void					UpdateGravity();
 	void					SortActiveEntityList();
+	void					CalculateAIRoutes();
+	void					ClearSightQueries();
+	void					ShowSightStats();
 	void					ShowTargets();
 	void					RunDebugInfo();
 
@@ -1362,6 +1362,21 @@ bool idPVS::InCurrentPVS( const pvsHandle_t handle, const int targetArea ) const
 	return ( ( currentPVS[handle.i].pvs[targetArea >> 3] & ( 1 << ( targetArea & 7 ) ) ) != 0 );
 }
 
+/*
+================
+idPVS::InAreaPVS
+================
+*/
+bool idPVS::InAreaPVS( const int sourceArea, const int targetArea ) const
+{
+	if( sourceArea < 0 || sourceArea >= numAreas || targetArea < 0 || targetArea >= numAreas )
+	{
+		return false;
+	}
+
+	return ( ( areaPVS[sourceArea * areaVisBytes + ( targetArea >> 3 )] & ( 1 << ( targetArea & 7 ) ) ) != 0 );
+}
+
 /*
 ================
 idPVS::InCurrentPVS
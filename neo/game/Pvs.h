@@ -86,6 +86,8 @@ public:
 	bool				InCurrentPVS( const pvsHandle_t handle, const idBounds& target ) const;
 	bool				InCurrentPVS( const pvsHandle_t handle, const int targetArea ) const;
 	bool				InCurrentPVS( const pvsHandle_t handle, const int* targetAreas, int numTargetAreas ) const;
+	// returns true if the target area is within the PVS of the source area with all portals open
+	bool				InAreaPVS( const int sourceArea, const int targetArea ) const;
 	// draw all portals that are within the PVS of the source
 	void				DrawPVS( const idVec3& source, const pvsType_t type = PVS_NORMAL ) const;
 	void				DrawPVS( const idBounds& source, const pvsType_t type = PVS_NORMAL ) const;
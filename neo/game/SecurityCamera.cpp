@@ -301,7 +301,6 @@ bool idSecurityCamera::CanSeePlayer()
 	int i;
 	float dist;
 	idPlayer* ent;
-	trace_t tr;
 	idVec3 dir;
 	pvsHandle_t handle;
 
@@ -339,8 +338,7 @@ bool idSecurityCamera::CanSeePlayer()
 
 		eye = ent->EyeOffset();
 
-		gameLocal.clip.TracePoint( tr, GetPhysics()->GetOrigin(), ent->GetPhysics()->GetOrigin() + eye, MASK_OPAQUE, this );
-		if( tr.fraction == 1.0 || ( gameLocal.GetTraceEntity( tr ) == ent ) )
+		if( gameLocal.CanSee( this, GetPhysics()->GetOrigin(), ent, ent->GetPhysics()->GetOrigin() + eye ) )
 		{
 			gameLocal.pvs.FreeCurrentPVS( handle );
 			return true;
@@ -62,6 +62,18 @@ typedef struct aasGoal_s
 } aasGoal_t;
 
 
+typedef struct aasRoute_s
+{
+	int							areaNum;		// area to route from
+	idVec3						origin;			// position in the area
+	int							goalAreaNum;	// area to route to
+	int							travelFlags;
+	bool						reachable;		// set by RoutesToGoalAreas
+	int							travelTime;
+	idReachability* 			reach;
+} aasRoute_t;
+
+
 typedef struct aasObstacle_s
 {
 	idBounds					absBounds;		// absolute bounds of obstacle
@@ -128,6 +140,8 @@ public:
 	virtual int					TravelTimeToGoalArea( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags ) const = 0;
 	// Get the travel time and first reachability to be used towards the goal, returns true if there is a path.
 	virtual bool				RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach ) const = 0;
+	// Routes a batch of queries, on the job threads when there are enough of them. The routing caches are left updated for later queries.
+	virtual void				RoutesToGoalAreas( aasRoute_t* routes, int numRoutes ) const = 0;
 	// Creates a walk path towards the goal.
 	virtual bool				WalkPathToGoal( aasPath_t& path, int areaNum, const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin, int travelFlags ) const = 0;
 	// Returns true if one can walk along a straight line from the origin to the goal origin.
@@ -75,6 +75,16 @@ private:
 };
 
 
+// update lists used while calculating routing caches, every thread routing at the same time has its own
+typedef struct
+{
+	idRoutingUpdate* 			areaUpdate;				// memory used to update the area routing cache
+	idRoutingUpdate* 			portalUpdate;			// memory used to update the portal routing cache
+} routingScratch_t;
+
+const int MAX_ROUTING_SCRATCH = MAX_JOB_THREADS + 1;
+
+
 class idRoutingObstacle
 {
 	friend class idAASLocal;
@@ -115,6 +125,7 @@ public:
 	virtual void				RemoveAllObstacles();
 	virtual int					TravelTimeToGoalArea( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags ) const;
 	virtual bool				RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach ) const;
+	virtual void				RoutesToGoalAreas( aasRoute_t* routes, int numRoutes ) const;
 	virtual bool				WalkPathToGoal( aasPath_t& path, int areaNum, const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin, int travelFlags ) const;
 	virtual bool				WalkPathValid( int areaNum, const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin, int travelFlags, idVec3& endPos, int& endAreaNum ) const;
 	virtual bool				FlyPathToGoal( aasPath_t& path, int areaNum, const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin, int travelFlags ) const;
@@ -132,8 +143,9 @@ private:	// routing data
 	int							areaCacheIndexSize;		// number of area cache entries
 	idRoutingCache** 			portalCacheIndex;		// for each area in the world the travel times from each portal
 	int							portalCacheIndexSize;	// number of portal cache entries
-	idRoutingUpdate* 			areaUpdate;				// memory used to update the area routing cache
-	idRoutingUpdate* 			portalUpdate;			// memory used to update the portal routing cache
+	mutable routingScratch_t	routingScratch[MAX_ROUTING_SCRATCH];	// the first is used by the main thread
+	mutable volatile long		cacheLock;				// guards the cache index and list while routing on the job threads
+	mutable bool				routingJobs;			// routing on the job threads, caches may not be deleted
 	unsigned short* 			goalAreaTravelTimes;	// travel times to goal areas
 	unsigned short* 			areaTravelTimes;		// travel times through the areas
 	int							numAreaTravelTimes;		// number of area travel times
@@ -141,6 +153,12 @@ private:	// routing data
 	mutable idRoutingCache* 	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle*>	obstacleList;			// list with obstacles
+	int							portalTableTravelFlags;	// travel flags the portal table is calculated for
+	unsigned short* 			portalTable;			// for both sides of every portal the travel times from all portals towards it
+	byte* 						portalTableReach;		// reachabilities used to leave the portals
+	mutable bool* 				portalTableValid;		// rows calculated for the current area states
+	mutable unsigned int* 		portalTableClusters;	// for every row a bit for each cluster its flood went through
+	int							portalTableClusterWords;	// size of the cluster bits of a row
 
 private:	// routing
 	bool						SetupRouting();
@@ -158,10 +176,24 @@ private:	// routing
 	void						DeleteOldestCache() const;
 	idReachability* 			GetAreaReachability( int areaNum, int reachabilityNum ) const;
 	int							ClusterAreaNum( int clusterNum, int areaNum ) const;
-	void						UpdateAreaRoutingCache( idRoutingCache* areaCache ) const;
-	idRoutingCache* 			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
-	void						UpdatePortalRoutingCache( idRoutingCache* portalCache ) const;
-	idRoutingCache* 			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
+	void						AllocRoutingScratch( int num ) const;
+	void						UpdateAreaRoutingCache( idRoutingCache* areaCache, const routingScratch_t& scratch ) const;
+	idRoutingCache* 			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags, const routingScratch_t& scratch ) const;
+	void						UpdatePortalRoutingCache( idRoutingCache* portalCache, const routingScratch_t& scratch ) const;
+	idRoutingCache* 			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags, const routingScratch_t& scratch ) const;
+	idRoutingCache* 			FindRoutingCache( idRoutingCache* list, int travelFlags ) const;
+	bool						CalcRouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach, const routingScratch_t& scratch ) const;
+	static void					RouteJob( void* data );
+	void						SetupPortalTable();
+	void						ShutdownPortalTable();
+	void						InvalidatePortalTable( int clusterNum );
+	unsigned int				PortalTableChecksum() const;
+	bool						LoadPortalTable();
+	void						WritePortalTable() const;
+	void						SetPortalTableRowClusters( int row ) const;
+	void						CalcPortalTableRow( int portalNum, int side, unsigned short* travelTimes, byte* reachabilities, const routingScratch_t& scratch ) const;
+	const unsigned short* 		GetPortalTableRow( int portalNum, int side, const byte** reachabilities, const routingScratch_t& scratch ) const;
+	void						UpdatePortalRoutingCacheFromTable( idRoutingCache* portalCache, const routingScratch_t& scratch ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
 	void						DisableArea( int areaNum );
 	void						EnableArea( int areaNum );
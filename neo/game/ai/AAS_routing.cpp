@@ -39,6 +39,10 @@ If you have questions concerning this license or the applicable additional terms
 
 #define LEDGE_TRAVELTIME_PANALTY	250
 
+#define PORTAL_TABLE_IDENT			( ( 'L' << 24 ) + ( 'B' << 16 ) + ( 'T' << 8 ) + 'P' )
+#define PORTAL_TABLE_VERSION		2
+#define MAX_PORTAL_TABLE_PORTALS	1024
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -231,8 +235,10 @@ void idAASLocal::SetupRoutingCache()
 	portalCacheIndexSize = file->GetNumAreas();
 	portalCacheIndex = ( idRoutingCache** ) Mem_ClearedAlloc( portalCacheIndexSize * sizeof( idRoutingCache* ) );
 
-	areaUpdate = ( idRoutingUpdate* ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( idRoutingUpdate ) );
-	portalUpdate = ( idRoutingUpdate* ) Mem_ClearedAlloc( ( file->GetNumPortals() + 1 ) * sizeof( idRoutingUpdate ) );
+	memset( routingScratch, 0, sizeof( routingScratch ) );
+	AllocRoutingScratch( 1 );
+	cacheLock = 0;
+	routingJobs = false;
 
 	goalAreaTravelTimes = ( unsigned short* ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( unsigned short ) );
 
@@ -240,6 +246,27 @@ void idAASLocal::SetupRoutingCache()
 	totalCacheMemory = 0;
 }
 
+/*
+============
+idAASLocal::AllocRoutingScratch
+
+  makes sure the first num threads routing at the same time have their own update lists
+============
+*/
+void idAASLocal::AllocRoutingScratch( int num ) const
+{
+	int i;
+
+	for( i = 0; i < num; i++ )
+	{
+		if( !routingScratch[i].areaUpdate )
+		{
+			routingScratch[i].areaUpdate = ( idRoutingUpdate* ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( idRoutingUpdate ) );
+			routingScratch[i].portalUpdate = ( idRoutingUpdate* ) Mem_ClearedAlloc( ( file->GetNumPortals() + 1 ) * sizeof( idRoutingUpdate ) );
+		}
+	}
+}
+
 /*
 ============
 idAASLocal::DeleteClusterCache
@@ -304,10 +331,12 @@ void idAASLocal::ShutdownRoutingCache()
 	Mem_Free( portalCacheIndex );
 	portalCacheIndex = NULL;
 	portalCacheIndexSize = 0;
-	Mem_Free( areaUpdate );
-	areaUpdate = NULL;
-	Mem_Free( portalUpdate );
-	portalUpdate = NULL;
+	for( i = 0; i < MAX_ROUTING_SCRATCH; i++ )
+	{
+		Mem_Free( routingScratch[i].areaUpdate );
+		Mem_Free( routingScratch[i].portalUpdate );
+	}
+	memset( routingScratch, 0, sizeof( routingScratch ) );
 	Mem_Free( goalAreaTravelTimes );
 	goalAreaTravelTimes = NULL;
 
@@ -324,6 +353,7 @@ bool idAASLocal::SetupRouting()
 {
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	SetupPortalTable();
 	return true;
 }
 
@@ -334,6 +364,7 @@ idAASLocal::ShutdownRouting
 */
 void idAASLocal::ShutdownRouting()
 {
+	ShutdownPortalTable();
 	DeleteAreaTravelTimes();
 	ShutdownRoutingCache();
 }
@@ -371,6 +402,19 @@ void idAASLocal::RoutingStats() const
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache* ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache* ) ) >> 10 );
+	if( portalTable )
+	{
+		int numRows = file->GetNumPortals() * 2;
+		int numValid = 0;
+		for( int i = 0; i < numRows; i++ )
+		{
+			if( portalTableValid[i] )
+			{
+				numValid++;
+			}
+		}
+		gameLocal.Printf( "%6d of %d portal table rows valid (%d KB)\n", numValid, numRows, ( int )( ( numRows * file->GetNumPortals() * ( sizeof( unsigned short ) + sizeof( byte ) ) ) >> 10 ) );
+	}
 }
 
 /*
@@ -387,12 +431,15 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum )
 	{
 		// remove all the cache in the cluster the area is in
 		DeleteClusterCache( clusterNum );
+		InvalidatePortalTable( clusterNum );
 	}
 	else
 	{
 		// if this is a portal remove all cache in both the front and back cluster
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[0] );
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
+		InvalidatePortalTable( file->GetPortal( -clusterNum ).clusters[0] );
+		InvalidatePortalTable( file->GetPortal( -clusterNum ).clusters[1] );
 	}
 	DeletePortalCache();
 }
@@ -816,7 +863,7 @@ ID_INLINE int idAASLocal::ClusterAreaNum( int clusterNum, int areaNum ) const
 idAASLocal::UpdateAreaRoutingCache
 ============
 */
-void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache ) const
+void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache, const routingScratch_t& scratch ) const
 {
 	int i, nextAreaNum, cluster, badTravelFlags, clusterAreaNum, numReachableAreas;
 	unsigned short t, startAreaTravelTimes[MAX_REACH_PER_AREA];
@@ -839,7 +886,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache ) const
 	memset( startAreaTravelTimes, 0, sizeof( startAreaTravelTimes ) );
 
 	// initialize first update
-	curUpdate = &areaUpdate[clusterAreaNum];
+	curUpdate = &scratch.areaUpdate[clusterAreaNum];
 	curUpdate->areaNum = areaCache->areaNum;
 	curUpdate->areaTravelTimes = startAreaTravelTimes;
 	curUpdate->tmpTravelTime = areaCache->startTravelTime;
@@ -910,7 +957,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache ) const
 
 				areaCache->travelTimes[clusterAreaNum] = t;
 				areaCache->reachabilities[clusterAreaNum] = reach->number; // reversed reachability used to get into this area
-				nextUpdate = &areaUpdate[clusterAreaNum];
+				nextUpdate = &scratch.areaUpdate[clusterAreaNum];
 				nextUpdate->areaNum = nextAreaNum;
 				nextUpdate->tmpTravelTime = t;
 				nextUpdate->areaTravelTimes = reach->areaTravelTimes;
@@ -945,47 +992,82 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache ) const
 	}
 }
 
+/*
+============
+idAASLocal::FindRoutingCache
+============
+*/
+idRoutingCache* idAASLocal::FindRoutingCache( idRoutingCache* list, int travelFlags ) const
+{
+	idRoutingCache* cache;
+
+	for( cache = list; cache; cache = cache->next )
+	{
+		if( cache->travelFlags == travelFlags )
+		{
+			break;
+		}
+	}
+	return cache;
+}
+
 /*
 ============
 idAASLocal::GetAreaRoutingCache
+
+  A missing cache is calculated without holding the cache lock and only added
+  to the index once complete, so other threads never see partial travel times.
+  If another thread added the same cache in the mean time that one is used.
 ============
 */
-idRoutingCache* idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const
+idRoutingCache* idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags, const routingScratch_t& scratch ) const
 {
 	int clusterAreaNum;
 	idRoutingCache* cache, *clusterCache;
 
 	// number of the area in the cluster
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
+
+	// check if cache without undesired travel flags already exists
+	Mem_LockAllocator( cacheLock );
+	cache = FindRoutingCache( areaCacheIndex[clusterNum][clusterAreaNum], travelFlags );
+	if( cache )
+	{
+		LinkCache( cache );
+		Mem_UnlockAllocator( cacheLock );
+		return cache;
+	}
+	Mem_UnlockAllocator( cacheLock );
+
+	cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
+	cache->type = CACHETYPE_AREA;
+	cache->cluster = clusterNum;
+	cache->areaNum = areaNum;
+	cache->startTravelTime = 1;
+	cache->travelFlags = travelFlags;
+	UpdateAreaRoutingCache( cache, scratch );
+
+	Mem_LockAllocator( cacheLock );
 	// pointer to the cache for the area in the cluster
 	clusterCache = areaCacheIndex[clusterNum][clusterAreaNum];
-	// check if cache without undesired travel flags already exists
-	for( cache = clusterCache; cache; cache = cache->next )
+	idRoutingCache* existing = FindRoutingCache( clusterCache, travelFlags );
+	if( existing )
 	{
-		if( cache->travelFlags == travelFlags )
-		{
-			break;
-		}
+		LinkCache( existing );
+		Mem_UnlockAllocator( cacheLock );
+		delete cache;
+		return existing;
 	}
-	// if no cache found
-	if( !cache )
-	{
-		cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
-		cache->type = CACHETYPE_AREA;
-		cache->cluster = clusterNum;
-		cache->areaNum = areaNum;
-		cache->startTravelTime = 1;
-		cache->travelFlags = travelFlags;
-		cache->prev = NULL;
-		cache->next = clusterCache;
-		if( clusterCache )
-		{
-			clusterCache->prev = cache;
-		}
-		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
-		UpdateAreaRoutingCache( cache );
+	cache->prev = NULL;
+	cache->next = clusterCache;
+	if( clusterCache )
+	{
+		clusterCache->prev = cache;
 	}
+	areaCacheIndex[clusterNum][clusterAreaNum] = cache;
 	LinkCache( cache );
+	Mem_UnlockAllocator( cacheLock );
+
 	return cache;
 }
 
@@ -994,7 +1076,7 @@ idRoutingCache* idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 idAASLocal::UpdatePortalRoutingCache
 ============
 */
-void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
+void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache, const routingScratch_t& scratch ) const
 {
 	int i, portalNum, clusterAreaNum;
 	unsigned short t;
@@ -1003,7 +1085,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
 	idRoutingCache* cache;
 	idRoutingUpdate* updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
 
-	curUpdate = &portalUpdate[ file->GetNumPortals() ];
+	curUpdate = &scratch.portalUpdate[ file->GetNumPortals() ];
 	curUpdate->cluster = portalCache->cluster;
 	curUpdate->areaNum = portalCache->areaNum;
 	curUpdate->tmpTravelTime = portalCache->startTravelTime;
@@ -1033,7 +1115,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
 		curUpdate->isInList = false;
 
 		cluster = &file->GetCluster( curUpdate->cluster );
-		cache = GetAreaRoutingCache( curUpdate->cluster, curUpdate->areaNum, portalCache->travelFlags );
+		cache = GetAreaRoutingCache( curUpdate->cluster, curUpdate->areaNum, portalCache->travelFlags, scratch );
 
 		// take all portals of the cluster
 		for( i = 0; i < cluster->numPortals; i++ )
@@ -1060,7 +1142,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
 
 				portalCache->travelTimes[portalNum] = t;
 				portalCache->reachabilities[portalNum] = cache->reachabilities[clusterAreaNum];
-				nextUpdate = &portalUpdate[portalNum];
+				nextUpdate = &scratch.portalUpdate[portalNum];
 				if( portal->clusters[0] == curUpdate->cluster )
 				{
 					nextUpdate->cluster = portal->clusters[1];
@@ -1097,40 +1179,494 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
 /*
 ============
 idAASLocal::GetPortalRoutingCache
+
+  see GetAreaRoutingCache
 ============
 */
-idRoutingCache* idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const
+idRoutingCache* idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags, const routingScratch_t& scratch ) const
 {
 	idRoutingCache* cache;
 
 	// check if cache without undesired travel flags already exists
-	for( cache = portalCacheIndex[areaNum]; cache; cache = cache->next )
+	Mem_LockAllocator( cacheLock );
+	cache = FindRoutingCache( portalCacheIndex[areaNum], travelFlags );
+	if( cache )
 	{
-		if( cache->travelFlags == travelFlags )
+		LinkCache( cache );
+		Mem_UnlockAllocator( cacheLock );
+		return cache;
+	}
+	Mem_UnlockAllocator( cacheLock );
+
+	cache = new idRoutingCache( file->GetNumPortals() );
+	cache->type = CACHETYPE_PORTAL;
+	cache->cluster = clusterNum;
+	cache->areaNum = areaNum;
+	cache->startTravelTime = 1;
+	cache->travelFlags = travelFlags;
+	if( portalTable && travelFlags == portalTableTravelFlags )
+	{
+		UpdatePortalRoutingCacheFromTable( cache, scratch );
+	}
+	else
+	{
+		UpdatePortalRoutingCache( cache, scratch );
+	}
+
+	Mem_LockAllocator( cacheLock );
+	idRoutingCache* existing = FindRoutingCache( portalCacheIndex[areaNum], travelFlags );
+	if( existing )
+	{
+		LinkCache( existing );
+		Mem_UnlockAllocator( cacheLock );
+		delete cache;
+		return existing;
+	}
+	cache->prev = NULL;
+	cache->next = portalCacheIndex[areaNum];
+	if( portalCacheIndex[areaNum] )
+	{
+		portalCacheIndex[areaNum]->prev = cache;
+	}
+	portalCacheIndex[areaNum] = cache;
+	LinkCache( cache );
+	Mem_UnlockAllocator( cacheLock );
+
+	return cache;
+}
+
+/*
+============
+idAASLocal::SetupPortalTable
+
+  The portal table has a row for both sides of every portal with the travel times
+  from all portals towards that portal, flooding out of the cluster on that side.
+  Portal caches for the default travel flags are combined from the rows of the
+  portals of the goal cluster instead of flooding through the whole portal graph.
+============
+*/
+void idAASLocal::SetupPortalTable()
+{
+	int i, numPortals;
+
+	portalTableTravelFlags = TFL_WALK | TFL_AIR;
+	portalTable = NULL;
+	portalTableReach = NULL;
+	portalTableValid = NULL;
+	portalTableClusters = NULL;
+	portalTableClusterWords = 0;
+
+	numPortals = file->GetNumPortals();
+	if( aas_portalTable.GetInteger() <= 0 || numPortals <= 1 || numPortals > MAX_PORTAL_TABLE_PORTALS )
+	{
+		return;
+	}
+
+	portalTable = ( unsigned short* ) Mem_ClearedAlloc( numPortals * 2 * numPortals * sizeof( unsigned short ) );
+	portalTableReach = ( byte* ) Mem_ClearedAlloc( numPortals * 2 * numPortals * sizeof( byte ) );
+	portalTableValid = ( bool* ) Mem_ClearedAlloc( numPortals * 2 * sizeof( bool ) );
+	portalTableClusterWords = ( file->GetNumClusters() + 31 ) >> 5;
+	portalTableClusters = ( unsigned int* ) Mem_ClearedAlloc( numPortals * 2 * portalTableClusterWords * sizeof( unsigned int ) );
+
+	if( LoadPortalTable() )
+	{
+		return;
+	}
+
+	if( aas_portalTable.GetInteger() > 1 )
+	{
+		const byte* reach;
+
+		// portal 0 is not used
+		portalTableValid[0] = portalTableValid[1] = true;
+		for( i = 1; i < numPortals; i++ )
 		{
-			break;
+			GetPortalTableRow( i, 0, &reach, routingScratch[0] );
+			GetPortalTableRow( i, 1, &reach, routingScratch[0] );
 		}
+		WritePortalTable();
+	}
+}
+
+/*
+============
+idAASLocal::ShutdownPortalTable
+============
+*/
+void idAASLocal::ShutdownPortalTable()
+{
+	Mem_Free( portalTable );
+	portalTable = NULL;
+	Mem_Free( portalTableReach );
+	portalTableReach = NULL;
+	Mem_Free( portalTableValid );
+	portalTableValid = NULL;
+	Mem_Free( portalTableClusters );
+	portalTableClusters = NULL;
+	portalTableClusterWords = 0;
+}
+
+/*
+============
+idAASLocal::InvalidatePortalTable
+
+  Only the rows that flooded through the cluster can change. They are
+  calculated again one at a time when the routing next needs them.
+============
+*/
+void idAASLocal::InvalidatePortalTable( int clusterNum )
+{
+	int i, numRows, word;
+	unsigned int bit;
+
+	assert( !routingJobs );
+
+	if( !portalTable || clusterNum <= 0 )
+	{
+		return;
 	}
-	// if no cache found
-	if( !cache )
-	{
-		cache = new idRoutingCache( file->GetNumPortals() );
-		cache->type = CACHETYPE_PORTAL;
-		cache->cluster = clusterNum;
-		cache->areaNum = areaNum;
-		cache->startTravelTime = 1;
-		cache->travelFlags = travelFlags;
-		cache->prev = NULL;
-		cache->next = portalCacheIndex[areaNum];
-		if( portalCacheIndex[areaNum] )
+
+	numRows = file->GetNumPortals() * 2;
+	word = clusterNum >> 5;
+	bit = 1u << ( clusterNum & 31 );
+	for( i = 0; i < numRows; i++ )
+	{
+		if( portalTableClusters[i * portalTableClusterWords + word] & bit )
 		{
-			portalCacheIndex[areaNum]->prev = cache;
+			portalTableValid[i] = false;
+		}
+	}
+}
+
+/*
+============
+idAASLocal::SetPortalTableRowClusters
+
+  The flood of a row starts in the cluster on its side of the portal and goes
+  through both clusters of every portal it reaches.
+============
+*/
+void idAASLocal::SetPortalTableRowClusters( int row ) const
+{
+	int i, numPortals, cluster;
+	const unsigned short* travelTimes;
+	unsigned int* bits;
+
+	numPortals = file->GetNumPortals();
+	travelTimes = portalTable + row * numPortals;
+	bits = portalTableClusters + row * portalTableClusterWords;
+
+	memset( bits, 0, portalTableClusterWords * sizeof( unsigned int ) );
+
+	cluster = file->GetPortal( row >> 1 ).clusters[row & 1];
+	if( cluster <= 0 )
+	{
+		return;
+	}
+	bits[cluster >> 5] |= 1u << ( cluster & 31 );
+
+	for( i = 0; i < numPortals; i++ )
+	{
+		if( travelTimes[i] == 0 )
+		{
+			continue;
+		}
+		const aasPortal_t& portal = file->GetPortal( i );
+		bits[portal.clusters[0] >> 5] |= 1u << ( portal.clusters[0] & 31 );
+		bits[portal.clusters[1] >> 5] |= 1u << ( portal.clusters[1] & 31 );
+	}
+}
+
+/*
+============
+idAASLocal::PortalTableChecksum
+
+  checksum of the routing data the rows are calculated from, the AAS file CRC
+  doesn't cover the area travel times calculated from the file at load time
+============
+*/
+unsigned int idAASLocal::PortalTableChecksum() const
+{
+	int i, data[3];
+	unsigned short travelTime;
+	unsigned long crc;
+	const idReachability* reach;
+
+	CRC32_InitChecksum( crc );
+
+	for( i = 0; i < numAreaTravelTimes; i++ )
+	{
+		travelTime = LittleShort( areaTravelTimes[i] );
+		CRC32_UpdateChecksum( crc, &travelTime, sizeof( travelTime ) );
+	}
+
+	for( i = 0; i < file->GetNumAreas(); i++ )
+	{
+		const aasArea_t& area = file->GetArea( i );
+
+		data[0] = LittleLong( area.cluster );
+		data[1] = LittleLong( area.clusterAreaNum );
+		data[2] = LittleLong( area.travelFlags );
+		CRC32_UpdateChecksum( crc, data, sizeof( data ) );
+
+		for( reach = area.reach; reach; reach = reach->next )
+		{
+			data[0] = LittleLong( reach->toAreaNum );
+			data[1] = LittleLong( reach->travelType );
+			data[2] = LittleLong( reach->travelTime );
+			CRC32_UpdateChecksum( crc, data, sizeof( data ) );
+		}
+	}
+
+	CRC32_FinishChecksum( crc );
+
+	return ( unsigned int )crc;
+}
+
+/*
+============
+idAASLocal::LoadPortalTable
+
+  the table is stored as <aas file>.portals and only used when it was written for the same AAS file
+  and routing data
+============
+*/
+bool idAASLocal::LoadPortalTable()
+{
+	int i, ident, version, numAreas, numPortals, travelFlags, size;
+	unsigned int crc, checksum;
+	idFile* fp;
+
+	fp = fileSystem->OpenFileRead( va( "%s.portals", file->GetName() ) );
+	if( !fp )
+	{
+		return false;
+	}
+
+	fp->ReadInt( ident );
+	fp->ReadInt( version );
+	fp->ReadUnsignedInt( crc );
+	fp->ReadInt( numAreas );
+	fp->ReadInt( numPortals );
+	fp->ReadInt( travelFlags );
+	fp->ReadUnsignedInt( checksum );
+	if( ident != PORTAL_TABLE_IDENT || version != PORTAL_TABLE_VERSION || crc != file->GetCRC() ||
+			numAreas != file->GetNumAreas() || numPortals != file->GetNumPortals() || travelFlags != portalTableTravelFlags ||
+			checksum != PortalTableChecksum() )
+	{
+		common->Warning( "%s is out of date", fp->GetName() );
+		fileSystem->CloseFile( fp );
+		return false;
+	}
+
+	size = numPortals * 2 * numPortals;
+	if( fp->Read( portalTable, size * sizeof( unsigned short ) ) != size * ( int )sizeof( unsigned short ) ||
+			fp->Read( portalTableReach, size * sizeof( byte ) ) != size * ( int )sizeof( byte ) )
+	{
+		common->Warning( "%s is truncated", fp->GetName() );
+		fileSystem->CloseFile( fp );
+		memset( portalTable, 0, size * sizeof( unsigned short ) );
+		memset( portalTableReach, 0, size * sizeof( byte ) );
+		return false;
+	}
+	fileSystem->CloseFile( fp );
+
+	for( i = 0; i < size; i++ )
+	{
+		portalTable[i] = LittleShort( portalTable[i] );
+	}
+	for( i = 0; i < numPortals * 2; i++ )
+	{
+		SetPortalTableRowClusters( i );
+	}
+	memset( portalTableValid, 1, numPortals * 2 * sizeof( bool ) );
+
+	return true;
+}
+
+/*
+============
+idAASLocal::WritePortalTable
+============
+*/
+void idAASLocal::WritePortalTable() const
+{
+	int i, j, numPortals;
+	unsigned short* travelTimes;
+	idFile* fp;
+
+	fp = fileSystem->OpenFileWrite( va( "%s.portals", file->GetName() ) );
+	if( !fp )
+	{
+		common->Warning( "couldn't write %s.portals", file->GetName() );
+		return;
+	}
+
+	numPortals = file->GetNumPortals();
+
+	fp->WriteInt( PORTAL_TABLE_IDENT );
+	fp->WriteInt( PORTAL_TABLE_VERSION );
+	fp->WriteUnsignedInt( file->GetCRC() );
+	fp->WriteInt( file->GetNumAreas() );
+	fp->WriteInt( numPortals );
+	fp->WriteInt( portalTableTravelFlags );
+	fp->WriteUnsignedInt( PortalTableChecksum() );
+
+	travelTimes = ( unsigned short* ) _alloca16( numPortals * sizeof( unsigned short ) );
+	for( i = 0; i < numPortals * 2; i++ )
+	{
+		for( j = 0; j < numPortals; j++ )
+		{
+			travelTimes[j] = LittleShort( portalTable[i * numPortals + j] );
+		}
+		fp->Write( travelTimes, numPortals * sizeof( unsigned short ) );
+	}
+	fp->Write( portalTableReach, numPortals * 2 * numPortals * sizeof( byte ) );
+
+	common->Printf( "Writing %s\n", fp->GetName() );
+	fileSystem->CloseFile( fp );
+}
+
+/*
+============
+idAASLocal::CalcPortalTableRow
+
+  floods the portals from one side of the portal, the travel times do not include a start travel time
+============
+*/
+void idAASLocal::CalcPortalTableRow( int portalNum, int side, unsigned short* travelTimes, byte* reachabilities, const routingScratch_t& scratch ) const
+{
+	const aasPortal_t* portal;
+	idRoutingCache cache( file->GetNumPortals() );
+
+	portal = &file->GetPortal( portalNum );
+	if( portal->clusters[side] > 0 )
+	{
+		cache.type = CACHETYPE_PORTAL;
+		cache.cluster = portal->clusters[side];
+		cache.areaNum = portal->areaNum;
+		cache.startTravelTime = 0;
+		cache.travelFlags = portalTableTravelFlags;
+		// don't flood back through the portal itself
+		cache.travelTimes[portalNum] = 1;
+		UpdatePortalRoutingCache( &cache, scratch );
+		cache.travelTimes[portalNum] = 0;
+	}
+
+	memcpy( travelTimes, cache.travelTimes, file->GetNumPortals() * sizeof( unsigned short ) );
+	memcpy( reachabilities, cache.reachabilities, file->GetNumPortals() * sizeof( byte ) );
+}
+
+/*
+============
+idAASLocal::GetPortalTableRow
+
+  A row that is no longer valid is calculated without holding the cache lock, same as the routing cache.
+============
+*/
+const unsigned short* idAASLocal::GetPortalTableRow( int portalNum, int side, const byte** reachabilities, const routingScratch_t& scratch ) const
+{
+	int row, numPortals;
+	bool valid;
+	unsigned short* travelTimes;
+	byte* reach;
+
+	numPortals = file->GetNumPortals();
+	row = portalNum * 2 + side;
+
+	Mem_LockAllocator( cacheLock );
+	valid = portalTableValid[row];
+	Mem_UnlockAllocator( cacheLock );
+
+	if( !valid )
+	{
+		travelTimes = ( unsigned short* ) _alloca16( numPortals * sizeof( unsigned short ) );
+		reach = ( byte* ) _alloca16( numPortals * sizeof( byte ) );
+		CalcPortalTableRow( portalNum, side, travelTimes, reach, scratch );
+
+		Mem_LockAllocator( cacheLock );
+		if( !portalTableValid[row] )
+		{
+			memcpy( portalTable + row * numPortals, travelTimes, numPortals * sizeof( unsigned short ) );
+			memcpy( portalTableReach + row * numPortals, reach, numPortals * sizeof( byte ) );
+			SetPortalTableRowClusters( row );
+			portalTableValid[row] = true;
+		}
+		Mem_UnlockAllocator( cacheLock );
+	}
+
+	*reachabilities = portalTableReach + row * numPortals;
+	return portalTable + row * numPortals;
+}
+
+/*
+============
+idAASLocal::UpdatePortalRoutingCacheFromTable
+
+  Gives the same travel times as UpdatePortalRoutingCache. Every route towards the goal
+  area leaves the goal cluster through one of its portals, so the travel time from a
+  portal is the best over the portals of the goal cluster of the travel time within the
+  goal cluster plus the table travel time from the other side of that portal.
+============
+*/
+void idAASLocal::UpdatePortalRoutingCacheFromTable( idRoutingCache* portalCache, const routingScratch_t& scratch ) const
+{
+	int i, j, portalNum, clusterAreaNum, numPortals;
+	unsigned short t, startTravelTime;
+	const aasPortal_t* portal;
+	const aasCluster_t* cluster;
+	const unsigned short* travelTimes;
+	const byte* reachabilities;
+	idRoutingCache* cache;
+
+	numPortals = file->GetNumPortals();
+	cluster = &file->GetCluster( portalCache->cluster );
+	cache = GetAreaRoutingCache( portalCache->cluster, portalCache->areaNum, portalCache->travelFlags, scratch );
+
+	// take all portals of the goal cluster
+	for( i = 0; i < cluster->numPortals; i++ )
+	{
+		portalNum = file->GetPortalIndex( cluster->firstPortal + i );
+		assert( portalNum < portalCache->size );
+		portal = &file->GetPortal( portalNum );
+
+		clusterAreaNum = ClusterAreaNum( portalCache->cluster, portal->areaNum );
+		if( clusterAreaNum >= cluster->numReachableAreas )
+		{
+			continue;
+		}
+
+		t = cache->travelTimes[clusterAreaNum];
+		if( t == 0 )
+		{
+			continue;
+		}
+		t += portalCache->startTravelTime;
+
+		if( !portalCache->travelTimes[portalNum] || t < portalCache->travelTimes[portalNum] )
+		{
+			portalCache->travelTimes[portalNum] = t;
+			portalCache->reachabilities[portalNum] = cache->reachabilities[clusterAreaNum];
+		}
+
+		// travel times from all portals reaching this portal from the other cluster
+		travelTimes = GetPortalTableRow( portalNum, ( portal->clusters[0] == portalCache->cluster ), &reachabilities, scratch );
+		startTravelTime = t + portal->maxAreaTravelTime;
+
+		for( j = 0; j < numPortals; j++ )
+		{
+			if( travelTimes[j] == 0 )
+			{
+				continue;
+			}
+			t = startTravelTime + travelTimes[j];
+			if( !portalCache->travelTimes[j] || t < portalCache->travelTimes[j] )
+			{
+				portalCache->travelTimes[j] = t;
+				portalCache->reachabilities[j] = reachabilities[j];
+			}
 		}
-		portalCacheIndex[areaNum] = cache;
-		UpdatePortalRoutingCache( cache );
 	}
-	LinkCache( cache );
-	return cache;
 }
 
 /*
@@ -1139,6 +1675,18 @@ idAASLocal::RouteToGoalArea
 ============
 */
 bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach ) const
+{
+	return CalcRouteToGoalArea( areaNum, origin, goalAreaNum, travelFlags, travelTime, reach, routingScratch[0] );
+}
+
+/*
+============
+idAASLocal::CalcRouteToGoalArea
+
+  thread safe as long as the area numbers are valid, which is checked before routing on the job threads
+============
+*/
+bool idAASLocal::CalcRouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach, const routingScratch_t& scratch ) const
 {
 	int clusterNum, goalClusterNum, portalNum, i, clusterAreaNum;
 	unsigned short int t, bestTime;
@@ -1171,7 +1719,8 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		return false;
 	}
 
-	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY )
+	// other threads may be using the oldest caches
+	while( !routingJobs && totalCacheMemory > MAX_ROUTING_CACHE_MEMORY )
 	{
 		DeleteOldestCache();
 	}
@@ -1190,7 +1739,7 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 			goalClusterNum = portal->clusters[0];
 		}
 		// get the portal routing cache
-		portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
+		portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags, scratch );
 		*reach = GetAreaReachability( areaNum, portalCache->reachabilities[-clusterNum] );
 		travelTime = portalCache->travelTimes[-clusterNum] + AreaTravelTime( areaNum, origin, ( *reach )->start );
 		return true;
@@ -1212,7 +1761,7 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 	// if both areas are in the same cluster
 	if( clusterNum > 0 && goalClusterNum > 0 && clusterNum == goalClusterNum )
 	{
-		clusterCache = GetAreaRoutingCache( clusterNum, goalAreaNum, travelFlags );
+		clusterCache = GetAreaRoutingCache( clusterNum, goalAreaNum, travelFlags, scratch );
 		clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
 		if( clusterCache->travelTimes[clusterAreaNum] )
 		{
@@ -1240,7 +1789,7 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		goalClusterNum = portal->clusters[0];
 	}
 	// get the portal routing cache
-	portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
+	portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags, scratch );
 
 	// the cluster the area is in
 	cluster = &file->GetCluster( clusterNum );
@@ -1265,7 +1814,7 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 
 		portal = &file->GetPortal( portalNum );
 		// get the cache of the portal area
-		areaCache = GetAreaRoutingCache( clusterNum, portal->areaNum, travelFlags );
+		areaCache = GetAreaRoutingCache( clusterNum, portal->areaNum, travelFlags, scratch );
 		// if the portal is not reachable from this area
 		if( !areaCache->travelTimes[clusterAreaNum] )
 		{
@@ -1312,6 +1861,104 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 	return true;
 }
 
+/*
+============
+idAASLocal::RouteJob
+============
+*/
+typedef struct
+{
+	const idAASLocal* 			aas;
+	aasRoute_t* 				routes;
+	int							numRoutes;
+	const routingScratch_t* 	scratch;
+} routeJob_t;
+
+void idAASLocal::RouteJob( void* data )
+{
+	int i;
+	routeJob_t* job = ( routeJob_t* )data;
+	const idAASFile* file = job->aas->file;
+
+	for( i = 0; i < job->numRoutes; i++ )
+	{
+		aasRoute_t& route = job->routes[i];
+
+		// out of range areas were already handled on the main thread
+		if( route.areaNum <= 0 || route.areaNum >= file->GetNumAreas() || route.goalAreaNum <= 0 || route.goalAreaNum >= file->GetNumAreas() )
+		{
+			continue;
+		}
+		route.reachable = job->aas->CalcRouteToGoalArea( route.areaNum, route.origin, route.goalAreaNum, route.travelFlags, route.travelTime, &route.reach, *job->scratch );
+	}
+}
+
+/*
+============
+idAASLocal::RoutesToGoalAreas
+
+  Splits the routes over the job threads, each with its own update lists.
+  Caches are only deleted to stay within the memory budget outside of the jobs.
+============
+*/
+void idAASLocal::RoutesToGoalAreas( aasRoute_t* routes, int numRoutes ) const
+{
+	int i, numJobs, first;
+	routeJob_t jobs[MAX_ROUTING_SCRATCH];
+
+	numJobs = 1;
+	if( file && aas_parallelRouting.GetInteger() > 0 )
+	{
+		numJobs = idMath::ClampInt( 1, MAX_ROUTING_SCRATCH, Min( sys->NumJobThreads() + 1, numRoutes / aas_parallelRouting.GetInteger() ) );
+	}
+
+	if( numJobs <= 1 )
+	{
+		for( i = 0; i < numRoutes; i++ )
+		{
+			routes[i].reachable = RouteToGoalArea( routes[i].areaNum, routes[i].origin, routes[i].goalAreaNum, routes[i].travelFlags, routes[i].travelTime, &routes[i].reach );
+		}
+		return;
+	}
+
+	for( i = 0; i < numRoutes; i++ )
+	{
+		routes[i].reachable = false;
+		routes[i].travelTime = 0;
+		routes[i].reach = NULL;
+
+		// let the serial path report out of range areas
+		if( routes[i].areaNum <= 0 || routes[i].areaNum >= file->GetNumAreas() || routes[i].goalAreaNum <= 0 || routes[i].goalAreaNum >= file->GetNumAreas() )
+		{
+			routes[i].reachable = RouteToGoalArea( routes[i].areaNum, routes[i].origin, routes[i].goalAreaNum, routes[i].travelFlags, routes[i].travelTime, &routes[i].reach );
+		}
+	}
+
+	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY )
+	{
+		DeleteOldestCache();
+	}
+
+	AllocRoutingScratch( numJobs );
+
+	for( i = 0, first = 0; i < numJobs; i++ )
+	{
+		jobs[i].aas = this;
+		jobs[i].routes = routes + first;
+		jobs[i].numRoutes = ( numRoutes * ( i + 1 ) ) / numJobs - first;
+		jobs[i].scratch = &routingScratch[i];
+		first += jobs[i].numRoutes;
+	}
+
+	Mem_BeginThreadSafeAllocs();
+	routingJobs = true;
+
+	sys->RunJobs( RouteJob, jobs, sizeof( jobs[0] ), numJobs );
+
+	routingJobs = false;
+	Mem_EndThreadSafeAllocs();
+}
+
 /*
 ============
 idAASLocal::TravelTimeToGoalArea
@@ -1377,7 +2024,7 @@ bool idAASLocal::FindNearestGoal( aasGoal_t& goal, int areaNum, const idVec3 ori
 	targetDist = ( target - origin ).Length();
 
 	// initialize first update
-	curUpdate = &areaUpdate[areaNum];
+	curUpdate = &routingScratch[0].areaUpdate[areaNum];
 	curUpdate->areaNum = areaNum;
 	curUpdate->tmpTravelTime = 0;
 	curUpdate->start = origin;
@@ -1492,7 +2139,7 @@ bool idAASLocal::FindNearestGoal( aasGoal_t& goal, int areaNum, const idVec3 ori
 			}
 
 			goalAreaTravelTimes[nextAreaNum] = t;
-			nextUpdate = &areaUpdate[nextAreaNum];
+			nextUpdate = &routingScratch[0].areaUpdate[nextAreaNum];
 			nextUpdate->areaNum = nextAreaNum;
 			nextUpdate->tmpTravelTime = t;
 			nextUpdate->start = reach->end;
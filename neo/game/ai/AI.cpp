@@ -1565,6 +1565,34 @@ bool idAI::PathToGoal( aasPath_t& path, int areaNum, const idVec3& origin, int g
 	}
 }
 
+/*
+=====================
+idAI::GetMoveRoute
+
+  returns the area system and the route the AI will path along when moving towards its goal area
+=====================
+*/
+idAAS* idAI::GetMoveRoute( aasRoute_t& route ) const
+{
+	if( !aas || !move.toAreaNum || ( move.moveCommand < NUM_NONMOVING_COMMANDS ) )
+	{
+		return NULL;
+	}
+
+	route.areaNum = PointReachableAreaNum( physicsObj.GetOrigin() );
+	if( !route.areaNum || route.areaNum == move.toAreaNum )
+	{
+		return NULL;
+	}
+
+	route.origin = physicsObj.GetOrigin();
+	aas->PushPointIntoAreaNum( route.areaNum, route.origin );
+	route.goalAreaNum = move.toAreaNum;
+	route.travelFlags = travelFlags;
+
+	return aas;
+}
+
 /*
 =====================
 idAI::TravelDistance
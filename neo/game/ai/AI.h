@@ -284,6 +284,9 @@ public:
 	// Finds the best collision free trajectory for a clip model.
 	static bool				PredictTrajectory( const idVec3& firePos, const idVec3& target, float projectileSpeed, const idVec3& projGravity, const idClipModel* clip, int clipmask, float max_height, const idEntity* ignore, const idEntity* targetEntity, int drawtime, idVec3& aimDir );
 
+	// Returns the area system and the route to the move goal area, NULL when not moving towards an area.
+	idAAS* 					GetMoveRoute( aasRoute_t& route ) const;
+
 protected:
 	// navigation
 	idAAS* 					aas;
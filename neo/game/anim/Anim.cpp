@@ -51,6 +51,10 @@ idMD5Anim::idMD5Anim()
 	numJoints	= 0;
 	frameRate	= 24;
 	animLength	= 0;
+	numAnimatedComponents	= 0;
+	numAnimatedJoints		= 0;
+	numRootComponents		= 0;
+	numQuantizedComponents	= 0;
 	totaldelta.Zero();
 }
 
@@ -77,11 +81,24 @@ void idMD5Anim::Free()
 	animLength	= 0;
 	name		= "";
 
+	numAnimatedComponents	= 0;
+	numAnimatedJoints		= 0;
+	numRootComponents		= 0;
+	numQuantizedComponents	= 0;
+
 	totaldelta.Zero();
 
 	jointInfo.Clear();
 	bounds.Clear();
-	componentFrames.Clear();
+	baseFrame.Clear();
+	jointValues.Clear();
+	constantValues.Clear();
+	rootFrames.Clear();
+	rootValues.Clear();
+	quantizedFrames.Clear();
+	componentScale.Clear();
+	componentBias.Clear();
+	componentValues.Clear();
 }
 
 /*
@@ -156,10 +173,35 @@ idMD5Anim::Allocated
 */
 size_t idMD5Anim::Allocated() const
 {
-	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size_t	size = bounds.Allocated() + jointInfo.Allocated() + baseFrame.Allocated() + name.Allocated();
+	size += jointValues.Allocated() + constantValues.Allocated() + rootValues.Allocated();
+	size += componentScale.Allocated() + componentBias.Allocated() + componentValues.Allocated();
+	size += FrameDataSize();
 	return size;
 }
 
+/*
+====================
+idMD5Anim::FrameDataSize
+====================
+*/
+size_t idMD5Anim::FrameDataSize() const
+{
+	return rootFrames.Allocated() + quantizedFrames.Allocated();
+}
+
+/*
+====================
+idMD5Anim::UncompressedFrameDataSize
+
+what the frames would take as plain floats
+====================
+*/
+size_t idMD5Anim::UncompressedFrameDataSize() const
+{
+	return numFrames * numAnimatedComponents * sizeof( float );
+}
+
 /*
 ====================
 idMD5Anim::LoadAnim
@@ -172,6 +214,7 @@ bool idMD5Anim::LoadAnim( const char* filename )
 	idToken	token;
 	int		i, j;
 	int		num;
+	idList<float> componentFrames;
 
 	if( !parser.LoadFile( filename ) )
 	{
@@ -362,6 +405,8 @@ bool idMD5Anim::LoadAnim( const char* filename )
 	}
 	baseFrame[ 0 ].t.Zero();
 
+	QuantizeFrames( componentFrames );
+
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
@@ -369,6 +414,166 @@ bool idMD5Anim::LoadAnim( const char* filename )
 	return true;
 }
 
+/*
+====================
+idMD5Anim::QuantizeFrames
+
+Every animated joint decodes to six values, tx ty tz qx qy qz, that start out
+as the base frame and have the joint's animated components written over them.
+The origin joint's components are kept as floats since they drive movement
+deltas.  All other components are stored as 16 bits over their range in the
+anim, so a frame takes half the memory and decodes without looking at animBits.
+====================
+*/
+void idMD5Anim::QuantizeFrames( const idList<float>& componentFrames )
+{
+	int i, j, k, c;
+
+	// lay out the decoded values
+	numAnimatedJoints = 0;
+	jointValues.SetGranularity( 1 );
+	jointValues.SetNum( numJoints );
+	for( i = 0; i < numJoints; i++ )
+	{
+		jointValues[ i ] = jointInfo[ i ].animBits ? numAnimatedJoints++ * 6 : -1;
+	}
+
+	constantValues.SetGranularity( 1 );
+	constantValues.SetNum( numAnimatedJoints * 6 );
+	for( i = 0; i < numJoints; i++ )
+	{
+		if( jointValues[ i ] >= 0 )
+		{
+			float* values = &constantValues[ jointValues[ i ] ];
+			values[ 0 ] = baseFrame[ i ].t.x;
+			values[ 1 ] = baseFrame[ i ].t.y;
+			values[ 2 ] = baseFrame[ i ].t.z;
+			values[ 3 ] = baseFrame[ i ].q.x;
+			values[ 4 ] = baseFrame[ i ].q.y;
+			values[ 5 ] = baseFrame[ i ].q.z;
+		}
+	}
+
+	// find the value each component decodes to
+	int* valueForComponent = ( int* )_alloca16( ( numAnimatedComponents + 1 ) * sizeof( int ) );
+	bool* rootComponent = ( bool* )_alloca16( ( numAnimatedComponents + 1 ) * sizeof( bool ) );
+	memset( valueForComponent, 0, numAnimatedComponents * sizeof( int ) );
+	memset( rootComponent, 0, numAnimatedComponents * sizeof( bool ) );
+	for( i = 0; i < numJoints; i++ )
+	{
+		c = jointInfo[ i ].firstComponent;
+		for( k = 0; k < 6; k++ )
+		{
+			if( jointInfo[ i ].animBits & BIT( k ) )
+			{
+				if( c >= numAnimatedComponents )
+				{
+					gameLocal.Error( "%s: too many components on joint %d", name.c_str(), i );
+				}
+				valueForComponent[ c ] = jointValues[ i ] + k;
+				rootComponent[ c ] = ( i == 0 );
+				c++;
+			}
+		}
+	}
+
+	numRootComponents = 0;
+	numQuantizedComponents = 0;
+	for( c = 0; c < numAnimatedComponents; c++ )
+	{
+		if( rootComponent[ c ] )
+		{
+			numRootComponents++;
+		}
+		else
+		{
+			numQuantizedComponents++;
+		}
+	}
+
+	rootValues.SetGranularity( 1 );
+	rootValues.SetNum( numRootComponents );
+	componentValues.SetGranularity( 1 );
+	componentValues.SetNum( numQuantizedComponents );
+	componentScale.SetGranularity( 1 );
+	componentScale.SetNum( numQuantizedComponents );
+	componentBias.SetGranularity( 1 );
+	componentBias.SetNum( numQuantizedComponents );
+	rootFrames.SetGranularity( 1 );
+	rootFrames.SetNum( numRootComponents * numFrames );
+	quantizedFrames.SetGranularity( 1 );
+	quantizedFrames.SetNum( numQuantizedComponents * numFrames );
+
+	for( c = 0, j = 0, k = 0; c < numAnimatedComponents; c++ )
+	{
+		if( rootComponent[ c ] )
+		{
+			rootValues[ j ] = valueForComponent[ c ];
+			for( i = 0; i < numFrames; i++ )
+			{
+				rootFrames[ i * numRootComponents + j ] = componentFrames[ i * numAnimatedComponents + c ];
+			}
+			j++;
+			continue;
+		}
+
+		float minValue = idMath::INFINITY;
+		float maxValue = -idMath::INFINITY;
+		for( i = 0; i < numFrames; i++ )
+		{
+			float value = componentFrames[ i * numAnimatedComponents + c ];
+			minValue = Min( minValue, value );
+			maxValue = Max( maxValue, value );
+		}
+
+		float scale = ( maxValue - minValue ) / 65535.0f;
+		componentValues[ k ] = valueForComponent[ c ];
+		componentScale[ k ] = scale;
+		componentBias[ k ] = minValue;
+		for( i = 0; i < numFrames; i++ )
+		{
+			int q = 0;
+			if( scale > 0.0f )
+			{
+				q = idMath::FtoiFast( ( componentFrames[ i * numAnimatedComponents + c ] - minValue ) / scale );
+				q = idMath::ClampInt( 0, 65535, q );
+			}
+			quantizedFrames[ i * numQuantizedComponents + k ] = ( unsigned short )q;
+		}
+		k++;
+	}
+}
+
+/*
+====================
+idMD5Anim::DecodeFrame
+
+fills in the six values of every animated joint for a frame
+====================
+*/
+void idMD5Anim::DecodeFrame( int framenum, float* values ) const
+{
+	int i;
+
+	SIMDProcessor->Memcpy( values, constantValues.Ptr(), constantValues.Num() * sizeof( float ) );
+
+	const float* root = rootFrames.Ptr() + framenum * numRootComponents;
+	const int* rootValue = rootValues.Ptr();
+	for( i = 0; i < numRootComponents; i++ )
+	{
+		values[ rootValue[ i ] ] = root[ i ];
+	}
+
+	const unsigned short* quantized = quantizedFrames.Ptr() + framenum * numQuantizedComponents;
+	const float* scale = componentScale.Ptr();
+	const float* bias = componentBias.Ptr();
+	const int* value = componentValues.Ptr();
+	for( i = 0; i < numQuantizedComponents; i++ )
+	{
+		values[ value[ i ] ] = quantized[ i ] * scale[ i ] + bias[ i ];
+	}
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -498,8 +703,8 @@ void idMD5Anim::GetOrigin( idVec3& offset, int time, int cyclecount ) const
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float* componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float* componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	const float* componentPtr1 = &rootFrames[ numRootComponents * frame.frame1 ];
+	const float* componentPtr2 = &rootFrames[ numRootComponents * frame.frame2 ];
 
 	if( jointInfo[ 0 ].animBits & ANIM_TX )
 	{
@@ -546,8 +751,8 @@ void idMD5Anim::GetOriginRotation( idQuat& rotation, int time, int cyclecount )
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float*	jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float*	jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	const float*	jointframe1 = &rootFrames[ numRootComponents * frame.frame1 ];
+	const float*	jointframe2 = &rootFrames[ numRootComponents * frame.frame2 ];
 
 	if( animBits & ANIM_TX )
 	{
@@ -666,8 +871,8 @@ void idMD5Anim::GetBounds( idBounds& bnds, int time, int cyclecount ) const
 	offset = baseFrame[ 0 ].t;
 	if( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) )
 	{
-		const float* componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float* componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		const float* componentPtr1 = &rootFrames[ numRootComponents * frame.frame1 ];
+		const float* componentPtr2 = &rootFrames[ numRootComponents * frame.frame2 ];
 
 		if( jointInfo[ 0 ].animBits & ANIM_TX )
 		{
@@ -701,12 +906,10 @@ idMD5Anim::GetInterpolatedFrame
 void idMD5Anim::GetInterpolatedFrame( frameBlend_t& frame, idJointQuat* joints, const int* index, int numIndexes ) const
 {
 	int						i, numLerpJoints;
-	const float*				frame1;
-	const float*				frame2;
-	const float*				jointframe1;
-	const float*				jointframe2;
-	const jointAnimInfo_t*	infoPtr;
-	int						animBits;
+	float*					values1;
+	float*					values2;
+	const float*			jointvalues1;
+	const float*			jointvalues2;
 	idJointQuat*				blendJoints;
 	idJointQuat*				jointPtr;
 	idJointQuat*				blendPtr;
@@ -725,161 +928,38 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t& frame, idJointQuat* joints,
 	lerpIndex = ( int* )_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 	numLerpJoints = 0;
 
-	frame1 = &componentFrames[ frame.frame1 * numAnimatedComponents ];
-	frame2 = &componentFrames[ frame.frame2 * numAnimatedComponents ];
+	values1 = ( float* )_alloca16( numAnimatedJoints * 6 * sizeof( values1[ 0 ] ) );
+	values2 = ( float* )_alloca16( numAnimatedJoints * 6 * sizeof( values2[ 0 ] ) );
+	DecodeFrame( frame.frame1, values1 );
+	DecodeFrame( frame.frame2, values2 );
 
 	for( i = 0; i < numIndexes; i++ )
 	{
 		int j = index[i];
-		jointPtr = &joints[j];
-		blendPtr = &blendJoints[j];
-		infoPtr = &jointInfo[j];
-
-		animBits = infoPtr->animBits;
-		if( animBits )
+		int first = jointValues[j];
+		if( first < 0 )
 		{
+			continue;
+		}
 
-			lerpIndex[numLerpJoints++] = j;
-
-			jointframe1 = frame1 + infoPtr->firstComponent;
-			jointframe2 = frame2 + infoPtr->firstComponent;
+		lerpIndex[numLerpJoints++] = j;
 
-			switch( animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) )
-			{
-				case 0:
-					blendPtr->t = jointPtr->t;
-					break;
-				case ANIM_TX:
-					jointPtr->t.x = jointframe1[0];
-					blendPtr->t.x = jointframe2[0];
-					blendPtr->t.y = jointPtr->t.y;
-					blendPtr->t.z = jointPtr->t.z;
-					jointframe1++;
-					jointframe2++;
-					break;
-				case ANIM_TY:
-					jointPtr->t.y = jointframe1[0];
-					blendPtr->t.y = jointframe2[0];
-					blendPtr->t.x = jointPtr->t.x;
-					blendPtr->t.z = jointPtr->t.z;
-					jointframe1++;
-					jointframe2++;
-					break;
-				case ANIM_TZ:
-					jointPtr->t.z = jointframe1[0];
-					blendPtr->t.z = jointframe2[0];
-					blendPtr->t.x = jointPtr->t.x;
-					blendPtr->t.y = jointPtr->t.y;
-					jointframe1++;
-					jointframe2++;
-					break;
-				case ANIM_TX|ANIM_TY:
-					jointPtr->t.x = jointframe1[0];
-					jointPtr->t.y = jointframe1[1];
-					blendPtr->t.x = jointframe2[0];
-					blendPtr->t.y = jointframe2[1];
-					blendPtr->t.z = jointPtr->t.z;
-					jointframe1 += 2;
-					jointframe2 += 2;
-					break;
-				case ANIM_TX|ANIM_TZ:
-					jointPtr->t.x = jointframe1[0];
-					jointPtr->t.z = jointframe1[1];
-					blendPtr->t.x = jointframe2[0];
-					blendPtr->t.z = jointframe2[1];
-					blendPtr->t.y = jointPtr->t.y;
-					jointframe1 += 2;
-					jointframe2 += 2;
-					break;
-				case ANIM_TY|ANIM_TZ:
-					jointPtr->t.y = jointframe1[0];
-					jointPtr->t.z = jointframe1[1];
-					blendPtr->t.y = jointframe2[0];
-					blendPtr->t.z = jointframe2[1];
-					blendPtr->t.x = jointPtr->t.x;
-					jointframe1 += 2;
-					jointframe2 += 2;
-					break;
-				case ANIM_TX|ANIM_TY|ANIM_TZ:
-					jointPtr->t.x = jointframe1[0];
-					jointPtr->t.y = jointframe1[1];
-					jointPtr->t.z = jointframe1[2];
-					blendPtr->t.x = jointframe2[0];
-					blendPtr->t.y = jointframe2[1];
-					blendPtr->t.z = jointframe2[2];
-					jointframe1 += 3;
-					jointframe2 += 3;
-					break;
-			}
-
-			switch( animBits & ( ANIM_QX | ANIM_QY | ANIM_QZ ) )
-			{
-				case 0:
-					blendPtr->q = jointPtr->q;
-					break;
-				case ANIM_QX:
-					jointPtr->q.x = jointframe1[0];
-					blendPtr->q.x = jointframe2[0];
-					blendPtr->q.y = jointPtr->q.y;
-					blendPtr->q.z = jointPtr->q.z;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QY:
-					jointPtr->q.y = jointframe1[0];
-					blendPtr->q.y = jointframe2[0];
-					blendPtr->q.x = jointPtr->q.x;
-					blendPtr->q.z = jointPtr->q.z;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QZ:
-					jointPtr->q.z = jointframe1[0];
-					blendPtr->q.z = jointframe2[0];
-					blendPtr->q.x = jointPtr->q.x;
-					blendPtr->q.y = jointPtr->q.y;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QX|ANIM_QY:
-					jointPtr->q.x = jointframe1[0];
-					jointPtr->q.y = jointframe1[1];
-					blendPtr->q.x = jointframe2[0];
-					blendPtr->q.y = jointframe2[1];
-					blendPtr->q.z = jointPtr->q.z;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QX|ANIM_QZ:
-					jointPtr->q.x = jointframe1[0];
-					jointPtr->q.z = jointframe1[1];
-					blendPtr->q.x = jointframe2[0];
-					blendPtr->q.z = jointframe2[1];
-					blendPtr->q.y = jointPtr->q.y;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QY|ANIM_QZ:
-					jointPtr->q.y = jointframe1[0];
-					jointPtr->q.z = jointframe1[1];
-					blendPtr->q.y = jointframe2[0];
-					blendPtr->q.z = jointframe2[1];
-					blendPtr->q.x = jointPtr->q.x;
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-				case ANIM_QX|ANIM_QY|ANIM_QZ:
-					jointPtr->q.x = jointframe1[0];
-					jointPtr->q.y = jointframe1[1];
-					jointPtr->q.z = jointframe1[2];
-					blendPtr->q.x = jointframe2[0];
-					blendPtr->q.y = jointframe2[1];
-					blendPtr->q.z = jointframe2[2];
-					jointPtr->q.w = jointPtr->q.CalcW();
-					blendPtr->q.w = blendPtr->q.CalcW();
-					break;
-			}
-		}
+		jointPtr = &joints[j];
+		blendPtr = &blendJoints[j];
+		jointvalues1 = values1 + first;
+		jointvalues2 = values2 + first;
+
+		jointPtr->t.Set( jointvalues1[0], jointvalues1[1], jointvalues1[2] );
+		jointPtr->q.x = jointvalues1[3];
+		jointPtr->q.y = jointvalues1[4];
+		jointPtr->q.z = jointvalues1[5];
+		jointPtr->q.w = jointPtr->q.CalcW();
+
+		blendPtr->t.Set( jointvalues2[0], jointvalues2[1], jointvalues2[2] );
+		blendPtr->q.x = jointvalues2[3];
+		blendPtr->q.y = jointvalues2[4];
+		blendPtr->q.z = jointvalues2[5];
+		blendPtr->q.w = blendPtr->q.CalcW();
 	}
 
 	SIMDProcessor->BlendJoints( joints, blendJoints, frame.backlerp, lerpIndex, numLerpJoints );
@@ -898,11 +978,9 @@ idMD5Anim::GetSingleFrame
 void idMD5Anim::GetSingleFrame( int framenum, idJointQuat* joints, const int* index, int numIndexes ) const
 {
 	int						i;
-	const float*				frame;
-	const float*				jointframe;
-	int						animBits;
+	float*					values;
+	const float*			jointvalues;
 	idJointQuat*				jointPtr;
-	const jointAnimInfo_t*	infoPtr;
 
 	// copy the baseframe
 	SIMDProcessor->Memcpy( joints, baseFrame.Ptr(), baseFrame.Num() * sizeof( baseFrame[ 0 ] ) );
@@ -913,60 +991,26 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat* joints, const int* in
 		return;
 	}
 
-	frame = &componentFrames[ framenum * numAnimatedComponents ];
+	values = ( float* )_alloca16( numAnimatedJoints * 6 * sizeof( values[ 0 ] ) );
+	DecodeFrame( framenum, values );
 
 	for( i = 0; i < numIndexes; i++ )
 	{
 		int j = index[i];
-		jointPtr = &joints[j];
-		infoPtr = &jointInfo[j];
-
-		animBits = infoPtr->animBits;
-		if( animBits )
+		int first = jointValues[j];
+		if( first < 0 )
 		{
+			continue;
+		}
 
-			jointframe = frame + infoPtr->firstComponent;
-
-			if( animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) )
-			{
-
-				if( animBits & ANIM_TX )
-				{
-					jointPtr->t.x = *jointframe++;
-				}
-
-				if( animBits & ANIM_TY )
-				{
-					jointPtr->t.y = *jointframe++;
-				}
-
-				if( animBits & ANIM_TZ )
-				{
-					jointPtr->t.z = *jointframe++;
-				}
-			}
-
-			if( animBits & ( ANIM_QX | ANIM_QY | ANIM_QZ ) )
-			{
-
-				if( animBits & ANIM_QX )
-				{
-					jointPtr->q.x = *jointframe++;
-				}
-
-				if( animBits & ANIM_QY )
-				{
-					jointPtr->q.y = *jointframe++;
-				}
-
-				if( animBits & ANIM_QZ )
-				{
-					jointPtr->q.z = *jointframe;
-				}
+		jointPtr = &joints[j];
+		jointvalues = values + first;
 
-				jointPtr->q.w = jointPtr->q.CalcW();
-			}
-		}
+		jointPtr->t.Set( jointvalues[0], jointvalues[1], jointvalues[2] );
+		jointPtr->q.x = jointvalues[3];
+		jointPtr->q.y = jointvalues[4];
+		jointPtr->q.z = jointvalues[5];
+		jointPtr->q.w = jointPtr->q.CalcW();
 	}
 }
 
@@ -1022,6 +1066,9 @@ idAnimManager::idAnimManager
 */
 idAnimManager::idAnimManager()
 {
+	poseTime = -1;
+	memset( frameStats, 0, sizeof( frameStats ) );
+	frameStatsTime = 0;
 }
 
 /*
@@ -1044,6 +1091,10 @@ void idAnimManager::Shutdown()
 	animations.DeleteContents();
 	jointnames.Clear();
 	jointnamesHash.Free();
+	ClearPoses();
+	poses.Clear();
+	poseJoints.Clear();
+	poseHash.Free();
 }
 
 /*
@@ -1152,10 +1203,14 @@ void idAnimManager::ListAnims() const
 	size_t		size;
 	size_t		s;
 	size_t		namesize;
+	size_t		framesize;
+	size_t		floatsize;
 	int			num;
 
 	num = 0;
 	size = 0;
+	framesize = 0;
+	floatsize = 0;
 	for( i = 0; i < animations.Num(); i++ )
 	{
 		animptr = animations.GetIndex( i );
@@ -1163,8 +1218,10 @@ void idAnimManager::ListAnims() const
 		{
 			anim = *animptr;
 			s = anim->Size();
-			gameLocal.Printf( "%8d bytes : %2d refs : %s\n", s, anim->NumRefs(), anim->Name() );
+			gameLocal.Printf( "%8d bytes : %8d frame data (%8d as floats) : %2d refs : %s\n", s, ( int )anim->FrameDataSize(), ( int )anim->UncompressedFrameDataSize(), anim->NumRefs(), anim->Name() );
 			size += s;
+			framesize += anim->FrameDataSize();
+			floatsize += anim->UncompressedFrameDataSize();
 			num++;
 		}
 	}
@@ -1176,6 +1233,7 @@ void idAnimManager::ListAnims() const
 	}
 
 	gameLocal.Printf( "\n%d memory used in %d anims\n", size, num );
+	gameLocal.Printf( "%d memory used in frame data, %d as floats\n", ( int )framesize, ( int )floatsize );
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
@@ -1207,4 +1265,114 @@ void idAnimManager::FlushUnusedAnims()
 		animations.Remove( removeAnims[ i ]->Name() );
 		delete removeAnims[ i ];
 	}
+
+	// model defs may have been reloaded
+	ClearPoses();
+}
+
+/*
+================
+idAnimManager::FindPose
+
+copies the joints another animator created with the same key this frame
+================
+*/
+bool idAnimManager::FindPose( int time, const animPoseKey_t& key, idJointMat* joints, int numJoints )
+{
+	int i;
+
+	if( time != poseTime )
+	{
+		return false;
+	}
+
+	int hash = poseHash.GenerateKey( key.animNum + key.time, key.frame + key.cycle );
+	for( i = poseHash.First( hash ); i != -1; i = poseHash.Next( i ) )
+	{
+		const animPoseKey_t& k = poses[ i ].key;
+		if( k.modelDef == key.modelDef && k.animNum == key.animNum && k.time == key.time && k.frame == key.frame && k.cycle == key.cycle &&
+				k.removeOrigin == key.removeOrigin && k.allowMove == key.allowMove )
+		{
+			SIMDProcessor->Memcpy( joints, &poseJoints[ poses[ i ].firstJoint ], numJoints * sizeof( joints[ 0 ] ) );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+================
+idAnimManager::StorePose
+================
+*/
+void idAnimManager::StorePose( int time, const animPoseKey_t& key, const idJointMat* joints, int numJoints )
+{
+	if( time != poseTime )
+	{
+		ClearPoses();
+		poseTime = time;
+	}
+
+	if( poses.Num() >= ANIM_MaxCachedPoses )
+	{
+		return;
+	}
+
+	animPose_t& pose = poses.Alloc();
+	pose.key = key;
+	pose.firstJoint = poseJoints.Num();
+
+	poseJoints.SetNum( pose.firstJoint + numJoints, false );
+	SIMDProcessor->Memcpy( &poseJoints[ pose.firstJoint ], joints, numJoints * sizeof( joints[ 0 ] ) );
+
+	poseHash.Add( poseHash.GenerateKey( key.animNum + key.time, key.frame + key.cycle ), poses.Num() - 1 );
+}
+
+/*
+================
+idAnimManager::ClearPoses
+================
+*/
+void idAnimManager::ClearPoses()
+{
+	poseTime = -1;
+	poses.SetNum( 0, false );
+	poseJoints.SetNum( 0, false );
+	poseHash.Clear();
+}
+
+/*
+================
+idAnimManager::CountFrame
+================
+*/
+void idAnimManager::CountFrame( animFrameStat_t stat )
+{
+	frameStats[ stat ]++;
+}
+
+/*
+================
+idAnimManager::ShowFrameStats
+
+prints the animation frame counters once a second
+================
+*/
+void idAnimManager::ShowFrameStats( int time )
+{
+	if( ( time >= frameStatsTime ) && ( time - frameStatsTime < 1000 ) )
+	{
+		return;
+	}
+
+	if( g_showAnimFrames.GetBool() && ( time > frameStatsTime ) )
+	{
+		float scale = 1000.0f / ( time - frameStatsTime );
+		gameLocal.Printf( "anim frames/sec: %4.0f built, %4.0f shared, %4.0f skipped by LOD\n",
+						  frameStats[ ANIMFRAME_BUILT ] * scale, frameStats[ ANIMFRAME_SHARED ] * scale, frameStats[ ANIMFRAME_SKIPPED ] * scale );
+	}
+
+	memset( frameStats, 0, sizeof( frameStats ) );
+	frameStatsTime = time;
 }
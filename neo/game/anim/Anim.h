@@ -34,6 +34,7 @@ If you have questions concerning this license or the applicable additional terms
 const int ANIM_NumAnimChannels		= 5;
 const int ANIM_MaxAnimsPerChannel	= 3;
 const int ANIM_MaxSyncedAnims		= 3;
+const int ANIM_MaxCachedPoses		= 128;		// poses shared between animators per game frame
 
 //
 // animation channels.  make sure to change script/doom_defs.script if you add any channels, or change their order
@@ -75,6 +76,32 @@ typedef struct
 	int						firstComponent;
 } jointAnimInfo_t;
 
+// everything a pose depends on when a single anim drives the whole model
+typedef struct
+{
+	const class idDeclModelDef*	modelDef;
+	int						animNum;
+	int						time;
+	int						frame;
+	int						cycle;
+	bool					removeOrigin;		// the animator's, also turns anim_turn anims
+	bool					allowMove;			// the blend's, only zeroes the origin with removeOrigin
+} animPoseKey_t;
+
+typedef struct
+{
+	animPoseKey_t			key;
+	int						firstJoint;
+} animPose_t;
+
+typedef enum
+{
+	ANIMFRAME_BUILT,		// joints created from the anims
+	ANIMFRAME_SHARED,		// joints copied from the pose cache
+	ANIMFRAME_SKIPPED,		// update skipped by the animation LOD
+	ANIMFRAME_NUM
+} animFrameStat_t;
+
 typedef struct
 {
 	jointHandle_t			num;
@@ -240,11 +267,24 @@ private:
 	idList<idBounds>		bounds;
 	idList<jointAnimInfo_t>	jointInfo;
 	idList<idJointQuat>		baseFrame;
-	idList<float>			componentFrames;
+	int						numAnimatedJoints;
+	idList<int>				jointValues;		// first of the six decoded values of each joint, -1 when it isn't animated
+	idList<float>			constantValues;		// tx ty tz qx qy qz of every animated joint from the base frame
+	int						numRootComponents;
+	idList<float>			rootFrames;			// animated components of the origin joint, kept at full precision
+	idList<int>				rootValues;			// decoded value written by each origin component
+	int						numQuantizedComponents;
+	idList<unsigned short>	quantizedFrames;	// animated components of the other joints, frame after frame
+	idList<float>			componentScale;		// value = quantized * scale + bias
+	idList<float>			componentBias;
+	idList<int>				componentValues;	// decoded value written by each quantized component
 	idStr					name;
 	idVec3					totaldelta;
 	mutable int				ref_count;
 
+	void					QuantizeFrames( const idList<float>& componentFrames );
+	void					DecodeFrame( int framenum, float* values ) const;
+
 public:
 	idMD5Anim();
 	~idMD5Anim();
@@ -256,6 +296,8 @@ public:
 	{
 		return sizeof( *this ) + Allocated();
 	};
+	size_t					FrameDataSize() const;
+	size_t					UncompressedFrameDataSize() const;
 	bool					LoadAnim( const char* filename );
 
 	void					IncreaseRefs() const;
@@ -537,7 +579,7 @@ public:
 
 	void						ForceUpdate();
 	void						ClearForceUpdate();
-	bool						CreateFrame( int animtime, bool force );
+	bool						CreateFrame( int animtime, bool force, const renderView_t* renderView = NULL );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3& delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3& delta ) const;
@@ -585,6 +627,8 @@ public:
 private:
 	void						FreeData();
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						UseLOD( const renderView_t* renderView ) const;
+	bool						GetPoseKey( int currentTime, bool lod, animPoseKey_t& key ) const;
 
 private:
 	const idDeclModelDef* 		modelDef;
@@ -636,10 +680,25 @@ public:
 	void						ClearAnimsInUse();
 	void						FlushUnusedAnims();
 
+	bool						FindPose( int time, const animPoseKey_t& key, idJointMat* joints, int numJoints );
+	void						StorePose( int time, const animPoseKey_t& key, const idJointMat* joints, int numJoints );
+	void						ClearPoses();
+
+	void						CountFrame( animFrameStat_t stat );
+	void						ShowFrameStats( int time );
+
 private:
 	idHashTable<idMD5Anim*>	animations;
 	idStrList					jointnames;
 	idHashIndex					jointnamesHash;
+
+	int							poseTime;				// game time the cached poses are for
+	idList<animPose_t>			poses;
+	idList<idJointMat>			poseJoints;
+	idHashIndex					poseHash;
+
+	int							frameStats[ ANIMFRAME_NUM ];
+	int							frameStatsTime;
 };
 
 #endif /* !__ANIM_H__ */
@@ -5037,13 +5037,16 @@ bool idAnimator::FrameHasChanged( int currentTime ) const
 idAnimator::CreateFrame
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force )
+bool idAnimator::CreateFrame( int currentTime, bool force, const renderView_t* renderView )
 {
 	int					i, j;
 	int					numJoints;
 	int					parentNum;
 	bool				hasAnim;
 	bool				debugInfo;
+	bool				lod;
+	bool				cachePose;
+	animPoseKey_t		poseKey;
 	float				baseBlend;
 	float				blendWeight;
 	const idAnimBlend* 	blend;
@@ -5075,6 +5078,14 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 		}
 	}
 
+	// distant actors are updated less often and without their eyelids
+	lod = !force && !r_showSkel.GetInteger() && UseLOD( renderView );
+	if( lod && ( lastTransformTime != -1 ) && !stoppedAnimatingUpdate && ( currentTime >= lastTransformTime ) && ( currentTime - lastTransformTime < g_animLODInterval.GetInteger() ) )
+	{
+		animationLib.CountFrame( ANIMFRAME_SKIPPED );
+		return false;
+	}
+
 	lastTransformTime = currentTime;
 	stoppedAnimatingUpdate = false;
 
@@ -5107,6 +5118,15 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 	}
 
 	numJoints = modelDef->Joints().Num();
+
+	// animators playing the same anim at the same time share the pose
+	cachePose = !debugInfo && g_animPoseCache.GetBool() && GetPoseKey( currentTime, lod, poseKey );
+	if( cachePose && animationLib.FindPose( currentTime, poseKey, joints, numJoints ) )
+	{
+		animationLib.CountFrame( ANIMFRAME_SHARED );
+		return true;
+	}
+
 	idJointQuat* jointFrame = ( idJointQuat* )_alloca16( numJoints * sizeof( jointFrame[0] ) );
 	SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
 
@@ -5164,7 +5184,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 	}
 
 	// blend in the eyelids
-	if( modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) )
+	if( !lod && modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) )
 	{
 		blend = channels[ ANIMCHANNEL_EYELIDS ];
 		blendWeight = baseBlend;
@@ -5312,6 +5332,83 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 	// transform the rest of the hierarchy
 	SIMDProcessor->TransformJoints( joints, jointParent, i, numJoints - 1 );
 
+	if( cachePose )
+	{
+		animationLib.StorePose( currentTime, poseKey, joints, numJoints );
+	}
+	animationLib.CountFrame( ANIMFRAME_BUILT );
+
+	return true;
+}
+
+/*
+=====================
+idAnimator::UseLOD
+
+true when the entity is far enough from the view being rendered to animate at a reduced rate
+=====================
+*/
+bool idAnimator::UseLOD( const renderView_t* renderView ) const
+{
+	if( !renderView || !entity )
+	{
+		return false;
+	}
+
+	float distance = g_animLODDistance.GetFloat();
+	if( distance <= 0.0f )
+	{
+		return false;
+	}
+
+	return ( entity->GetPhysics()->GetOrigin() - renderView->vieworg ).LengthSqr() > Square( distance );
+}
+
+/*
+=====================
+idAnimator::GetPoseKey
+
+The pose can be shared when the first anim on the all channel is fully blended
+in, which keeps every other channel from being blended, and nothing else
+modifies the joints.
+=====================
+*/
+bool idAnimator::GetPoseKey( int currentTime, bool lod, animPoseKey_t& key ) const
+{
+	int i;
+
+	if( jointMods.Num() || AFPoseJoints.Num() )
+	{
+		return false;
+	}
+
+	const idAnimBlend* blend = &channels[ ANIMCHANNEL_ALL ][ 0 ];
+	const idAnim* anim = blend->Anim();
+	if( !anim || ( anim->NumAnims() != 1 ) || ( blend->GetWeight( currentTime ) < 1.0f ) )
+	{
+		return false;
+	}
+
+	// eyelids blend over the all channel
+	if( !lod && modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) )
+	{
+		for( i = 0; i < ANIM_MaxAnimsPerChannel; i++ )
+		{
+			if( channels[ ANIMCHANNEL_EYELIDS ][ i ].Anim() )
+			{
+				return false;
+			}
+		}
+	}
+
+	key.modelDef		= modelDef;
+	key.animNum			= blend->animNum;
+	key.time			= blend->AnimTime( currentTime );
+	key.frame			= blend->frame;
+	key.cycle			= blend->cycle;
+	key.removeOrigin	= removeOriginOffset;
+	key.allowMove		= blend->allowMove;
+
 	return true;
 }
 
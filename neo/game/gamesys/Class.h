@@ -296,6 +296,9 @@ private:
 
 	void						Event_SafeRemove();
 
+	friend class idEvent;
+	idLinkList<idEvent>			pendingEvents;				// maintained by idEvent, so cancelling only visits our own
+
 	static bool					initialized;
 	static idList<idTypeInfo*>	types;
 	static idList<idTypeInfo*>	typenums;
@@ -87,40 +87,52 @@ idEventDef::idEventDef( const char* command, const char* formatspec, char return
 	}
 
 	// make sure the format for the args is valid, calculate the formatspecindex, and the offsets for each arg
+	// both in the event data and in the parms pushed by a script call, so the interpreter doesn't have to
+	// walk the format string to find them
 	bits = 0;
 	argsize = 0;
+	scriptArgSize = 0;
 	memset( argOffset, 0, sizeof( argOffset ) );
+	memset( scriptArgOffset, 0, sizeof( scriptArgOffset ) );
 	for( i = 0; i < numargs; i++ )
 	{
 		argOffset[ i ] = argsize;
+		scriptArgOffset[ i ] = scriptArgSize;
 		switch( formatspec[ i ] )
 		{
 			case D_EVENT_FLOAT :
 				bits |= 1 << i;
 				argsize += sizeof( float );
+				scriptArgSize += sizeof( float );
 				break;
 
 			case D_EVENT_INTEGER :
 				argsize += sizeof( int );
+				scriptArgSize += sizeof( float );
 				break;
 
 			case D_EVENT_VECTOR :
 				argsize += sizeof( idVec3 );
+				scriptArgSize += sizeof( idVec3 );
 				break;
 
 			case D_EVENT_STRING :
 				argsize += MAX_STRING_LEN;
+				scriptArgSize += MAX_STRING_LEN;
 				break;
 
 			case D_EVENT_ENTITY :
 				argsize += sizeof( idEntityPtr<idEntity> );
+				scriptArgSize += sizeof( int* );
 				break;
 
 			case D_EVENT_ENTITY_NULL :
 				argsize += sizeof( idEntityPtr<idEntity> );
+				scriptArgSize += sizeof( int* );
 				break;
 
 			case D_EVENT_TRACE :
+				// not available from script
 				argsize += sizeof( trace_t ) + MAX_STRING_LEN + sizeof( bool );
 				break;
 
@@ -135,6 +147,9 @@ idEventDef::idEventDef( const char* command, const char* formatspec, char return
 	// calculate the formatspecindex
 	formatspecIndex = ( 1 << ( numargs + D_EVENT_MAXARGS ) ) | bits;
 
+	// a script call to an event that only takes floats pushes its parms exactly as the event expects them
+	scriptArgsAreFloats = ( bits == ( 1u << numargs ) - 1 );
+
 	// go through the list of defined events and check for duplicates
 	// and mismatched format strings
 	eventnum = numEventDefs;
@@ -229,13 +244,31 @@ const idEventDef* idEventDef::FindEvent( const char* name )
 ***********************************************************************/
 
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
+static idEvent* EventQueue[ MAX_EVENTS ];		// binary heap, the next event to run is first
+static int NumQueuedEvents;
+static unsigned int EventSequence;
 static idEvent EventPool[ MAX_EVENTS ];
 
 bool idEvent::initialized = false;
 
 idDynamicBlockAlloc<byte, 16 * 1024, 256>	idEvent::eventDataAllocator;
 
+/*
+================
+idEvent::idEvent
+================
+*/
+idEvent::idEvent()
+{
+	eventdef = NULL;
+	data = NULL;
+	time = 0;
+	object = NULL;
+	typeinfo = NULL;
+	queueIndex = -1;
+	sequence = 0;
+}
+
 /*
 ================
 idEvent::~idEvent()
@@ -246,6 +279,148 @@ idEvent::~idEvent()
 	Free();
 }
 
+/*
+================
+idEvent::RunsBefore
+================
+*/
+ID_INLINE bool idEvent::RunsBefore( const idEvent* other ) const
+{
+	if( time != other->time )
+	{
+		return ( time < other->time );
+	}
+	return ( ( int )( sequence - other->sequence ) < 0 );
+}
+
+/*
+================
+idEvent::MoveUp
+================
+*/
+void idEvent::MoveUp( int index )
+{
+	idEvent* event = EventQueue[ index ];
+
+	while( index > 0 )
+	{
+		int parent = ( index - 1 ) >> 1;
+		if( !event->RunsBefore( EventQueue[ parent ] ) )
+		{
+			break;
+		}
+		EventQueue[ index ] = EventQueue[ parent ];
+		EventQueue[ index ]->queueIndex = index;
+		index = parent;
+	}
+	EventQueue[ index ] = event;
+	event->queueIndex = index;
+}
+
+/*
+================
+idEvent::MoveDown
+================
+*/
+void idEvent::MoveDown( int index )
+{
+	idEvent* event = EventQueue[ index ];
+
+	while( 1 )
+	{
+		int child = index * 2 + 1;
+		if( child >= NumQueuedEvents )
+		{
+			break;
+		}
+		if( child + 1 < NumQueuedEvents && EventQueue[ child + 1 ]->RunsBefore( EventQueue[ child ] ) )
+		{
+			child++;
+		}
+		if( !EventQueue[ child ]->RunsBefore( event ) )
+		{
+			break;
+		}
+		EventQueue[ index ] = EventQueue[ child ];
+		EventQueue[ index ]->queueIndex = index;
+		index = child;
+	}
+	EventQueue[ index ] = event;
+	event->queueIndex = index;
+}
+
+/*
+================
+idEvent::AddToQueue
+
+Adds the event to the queue and the pending events of its object, after
+every event already scheduled for the same time
+================
+*/
+void idEvent::AddToQueue()
+{
+	sequence = EventSequence++;
+
+	EventQueue[ NumQueuedEvents ] = this;
+	MoveUp( NumQueuedEvents++ );
+
+	if( object )
+	{
+		objectNode.SetOwner( this );
+		objectNode.AddToEnd( object->pendingEvents );
+	}
+}
+
+/*
+================
+idEvent::RemoveFromQueue
+================
+*/
+void idEvent::RemoveFromQueue()
+{
+	objectNode.Remove();
+
+	if( queueIndex < 0 )
+	{
+		return;
+	}
+
+	int index = queueIndex;
+	queueIndex = -1;
+
+	NumQueuedEvents--;
+	if( index == NumQueuedEvents )
+	{
+		return;
+	}
+
+	// fill the hole with the last event and put it where it belongs
+	EventQueue[ index ] = EventQueue[ NumQueuedEvents ];
+	EventQueue[ index ]->queueIndex = index;
+	if( index > 0 && EventQueue[ index ]->RunsBefore( EventQueue[ ( index - 1 ) >> 1 ] ) )
+	{
+		MoveUp( index );
+	}
+	else
+	{
+		MoveDown( index );
+	}
+}
+
+/*
+================
+idEvent::SortBySchedule
+================
+*/
+int idEvent::SortBySchedule( idEvent* const* a, idEvent* const* b )
+{
+	if( ( *a )->RunsBefore( *b ) )
+	{
+		return -1;
+	}
+	return ( *b )->RunsBefore( *a ) ? 1 : 0;
+}
+
 /*
 ================
 idEvent::Alloc
@@ -398,6 +573,8 @@ idEvent::Free
 */
 void idEvent::Free()
 {
+	RemoveFromQueue();
+
 	if( data )
 	{
 		eventDataAllocator.Free( data );
@@ -420,8 +597,6 @@ idEvent::Schedule
 */
 void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 {
-	idEvent* event;
-
 	assert( initialized );
 	if( !initialized )
 	{
@@ -435,21 +610,8 @@ void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 	this->time = gameLocal.time + time;
 
 	eventNode.Remove();
-
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) )
-	{
-		event = event->eventNode.Next();
-	}
-
-	if( event )
-	{
-		eventNode.InsertBefore( event->eventNode );
-	}
-	else
-	{
-		eventNode.AddToEnd( EventQueue );
-	}
+	RemoveFromQueue();
+	AddToQueue();
 }
 
 /*
@@ -467,15 +629,14 @@ void idEvent::CancelEvents( const idClass* obj, const idEventDef* evdef )
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next )
+	// only the events of this object have to be looked at
+	for( event = obj->pendingEvents.Next(); event != NULL; event = next )
 	{
-		next = event->eventNode.Next();
-		if( event->object == obj )
+		next = event->objectNode.Next();
+		assert( event->object == obj );
+		if( !evdef || ( evdef == event->eventdef ) )
 		{
-			if( !evdef || ( evdef == event->eventdef ) )
-			{
-				event->Free();
-			}
+			event->Free();
 		}
 	}
 }
@@ -493,13 +654,15 @@ void idEvent::ClearEventList()
 	// initialize lists
 	//
 	FreeEvents.Clear();
-	EventQueue.Clear();
+	NumQueuedEvents = 0;
+	EventSequence = 0;
 
 	//
 	// add the events to the free list
 	//
 	for( i = 0; i < MAX_EVENTS; i++ )
 	{
+		EventPool[ i ].queueIndex = -1;
 		EventPool[ i ].Free();
 	}
 }
@@ -524,9 +687,9 @@ void idEvent::ServiceEvents()
 	const char*  materialName;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() )
+	while( NumQueuedEvents > 0 )
 	{
-		event = EventQueue.Next();
+		event = EventQueue[ 0 ];
 		assert( event );
 
 		if( event->time > gameLocal.time )
@@ -586,9 +749,9 @@ void idEvent::ServiceEvents()
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from the queue so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		event->RemoveFromQueue();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -688,11 +851,20 @@ void idEvent::Save( idSaveGame* savefile )
 	bool validTrace;
 	const char*	format;
 
-	savefile->WriteInt( EventQueue.Num() );
+	savefile->WriteInt( NumQueuedEvents );
+
+	// written in the order they will run, like the old sorted list
+	idList<idEvent*> sorted;
+	sorted.SetNum( NumQueuedEvents );
+	for( i = 0; i < NumQueuedEvents; i++ )
+	{
+		sorted[ i ] = EventQueue[ i ];
+	}
+	sorted.Sort( SortBySchedule );
 
-	event = EventQueue.Next();
-	while( event != NULL )
+	for( int e = 0; e < sorted.Num(); e++ )
 	{
+		event = sorted[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -740,7 +912,6 @@ void idEvent::Save( idSaveGame* savefile )
 			}
 		}
 		assert( size == event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 }
 
@@ -769,7 +940,6 @@ void idEvent::Restore( idRestoreGame* savefile )
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -791,6 +961,9 @@ void idEvent::Restore( idRestoreGame* savefile )
 
 		savefile->ReadObject( event->object );
 
+		// they were saved in order, so they keep it
+		event->AddToQueue();
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if( argsize != event->eventdef->GetArgSize() )
@@ -60,6 +60,9 @@ private:
 	int							numargs;
 	size_t						argsize;
 	int							argOffset[ D_EVENT_MAXARGS ];
+	int							scriptArgOffset[ D_EVENT_MAXARGS ];	// where each arg is on the script stack
+	int							scriptArgSize;
+	bool						scriptArgsAreFloats;				// script args can be copied straight into the event data
 	int							eventnum;
 	const idEventDef* 			next;
 
@@ -77,6 +80,9 @@ public:
 	int							GetNumArgs() const;
 	size_t						GetArgSize() const;
 	int							GetArgOffset( int arg ) const;
+	int							GetScriptArgOffset( int arg ) const;
+	int							GetScriptArgSize() const;
+	bool						ScriptArgsAreFloats() const;
 
 	static int					NumEventCommands();
 	static const idEventDef*		GetEventCommand( int eventnum );
@@ -95,14 +101,24 @@ private:
 	idClass*						object;
 	const idTypeInfo*			typeinfo;
 
-	idLinkList<idEvent>			eventNode;
+	idLinkList<idEvent>			eventNode;			// in the free list
+	idLinkList<idEvent>			objectNode;			// in the pending events of the object
+	int							queueIndex;			// in the event queue heap, -1 if not scheduled
+	unsigned int				sequence;			// events with the same time are run in the order they were scheduled
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
+	bool						RunsBefore( const idEvent* other ) const;
+	void						AddToQueue();
+	void						RemoveFromQueue();
+	static void					MoveUp( int index );
+	static void					MoveDown( int index );
+	static int					SortBySchedule( idEvent* const* a, idEvent* const* b );
 
 public:
 	static bool					initialized;
 
+	idEvent();
 	~idEvent();
 
 	static idEvent*				Alloc( const idEventDef* evdef, int numargs, va_list args );
@@ -207,6 +223,37 @@ ID_INLINE int idEventDef::GetArgOffset( int arg ) const
 	return argOffset[ arg ];
 }
 
+/*
+================
+idEventDef::GetScriptArgOffset
+================
+*/
+ID_INLINE int idEventDef::GetScriptArgOffset( int arg ) const
+{
+	assert( ( arg >= 0 ) && ( arg < D_EVENT_MAXARGS ) );
+	return scriptArgOffset[ arg ];
+}
+
+/*
+================
+idEventDef::GetScriptArgSize
+================
+*/
+ID_INLINE int idEventDef::GetScriptArgSize() const
+{
+	return scriptArgSize;
+}
+
+/*
+================
+idEventDef::ScriptArgsAreFloats
+================
+*/
+ID_INLINE bool idEventDef::ScriptArgsAreFloats() const
+{
+	return scriptArgsAreFloats;
+}
+
 /*
 ================
 idEventDef::GetEventNum
@@ -111,13 +111,19 @@ idCVar g_gravity(	"g_gravity",		DEFAULT_GRAVITY_STRING, CVAR_GAME | CVAR_FLOAT,
 idCVar g_skipFX(	"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_skipParticles(	"g_skipParticles",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 
+idCVar g_scriptCache(	"g_scriptCache",			"1",			CVAR_GAME | CVAR_BOOL, "load the default script from a compiled image when its sources haven't changed, and write the image after compiling" );
 idCVar g_disasm(	"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
 idCVar g_debugBounds(	"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
+idCVar g_animLODDistance(	"g_animLODDistance",		"2048",			CVAR_GAME | CVAR_FLOAT, "actors further than this from the view are animated at a reduced rate and without eyelids, 0 disables" );
+idCVar g_animLODInterval(	"g_animLODInterval",		"50",			CVAR_GAME | CVAR_INTEGER, "msec between animation updates of actors beyond g_animLODDistance" );
+idCVar g_animPoseCache(	"g_animPoseCache",			"1",			CVAR_GAME | CVAR_BOOL, "share the pose of actors playing the same anim at the same time" );
+idCVar g_showAnimFrames(	"g_showAnimFrames",			"0",			CVAR_GAME | CVAR_BOOL, "prints how many animation frames are built, shared and skipped each second" );
 idCVar g_debugAnim(	"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
 idCVar g_debugMove(	"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugDamage(	"g_debugDamage",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugWeapon(	"g_debugWeapon",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugScript(	"g_debugScript",			"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_scriptProfile(	"g_scriptProfile",			"0",			CVAR_GAME | CVAR_BOOL, "records instructions and time per script function, event call and thread, see scriptProfile" );
 idCVar g_debugMover(	"g_debugMover",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugTriggers(	"g_debugTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugCinematic(	"g_debugCinematic",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -157,6 +163,8 @@ idCVar ai_showCombatNodes(	"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL,
 idCVar ai_showPaths(	"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
 idCVar ai_blockedFailSafe(	"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
+idCVar ai_sightCache(	"ai_sightCache",			"1",			CVAR_GAME | CVAR_BOOL, "share line of sight tests of monsters and cameras within a frame and skip the ones outside the PVS" );
+idCVar ai_showSightStats(	"ai_showSightStats",		"0",			CVAR_GAME | CVAR_BOOL, "prints how many line of sight tests are traced, shared and culled by the PVS each second" );
 
 idCVar g_dvTime(	"g_dvTime",					"1",			CVAR_GAME | CVAR_FLOAT, "" );
 idCVar g_dvAmplitude(	"g_dvAmplitude",			"0.001",		CVAR_GAME | CVAR_FLOAT, "" );
@@ -308,6 +316,8 @@ idCVar aas_pullPlayer(	"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "" )
 idCVar aas_randomPullPlayer(	"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(	"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(	"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_parallelRouting(	"aas_parallelRouting",		"4",			CVAR_GAME | CVAR_INTEGER, "minimum number of routes per job when the routes of moving AI are calculated on the job threads, 0 = never" );
+idCVar aas_portalTable(	"aas_portalTable",			"1",			CVAR_GAME | CVAR_INTEGER, "portal to portal travel times for routing with the default travel flags, 0 = off, 1 = load the .portals file next to the .aas file or calculate travel times when needed, 2 = also write missing .portals files when the AAS is loaded" );
 
 idCVar g_password(	"g_password",				"",				CVAR_GAME | CVAR_ARCHIVE, "game password" );
 idCVar password(	"password",					"",				CVAR_GAME | CVAR_NOCHEAT, "client password used when connecting" );
@@ -49,12 +49,18 @@ extern idCVar	g_doubleVision;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_scriptCache;
 extern idCVar	g_debugBounds;
+extern idCVar	g_animLODDistance;
+extern idCVar	g_animLODInterval;
+extern idCVar	g_animPoseCache;
+extern idCVar	g_showAnimFrames;
 extern idCVar	g_debugAnim;
 extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
 extern idCVar	g_debugScript;
+extern idCVar	g_scriptProfile;
 extern idCVar	g_debugMover;
 extern idCVar	g_debugTriggers;
 extern idCVar	g_debugCinematic;
@@ -92,6 +98,8 @@ extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
 extern idCVar	ai_blockedFailSafe;
+extern idCVar	ai_sightCache;
+extern idCVar	ai_showSightStats;
 
 extern idCVar	g_dvTime;
 extern idCVar	g_dvAmplitude;
@@ -232,6 +240,8 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_parallelRouting;
+extern idCVar	aas_portalTable;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -200,9 +200,44 @@ opcode_t idCompiler::opcodes[] =
 	{ "<BREAK>", "BREAK", -1, false, &def_float, &def_void, &def_void },
 	{ "<CONTINUE>", "CONTINUE", -1, false, &def_float, &def_void, &def_void },
 
+	{ "<IFNOT>", "EQ_F_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "EQ_E_IFNOT", -1, false, &def_entity, &def_entity, &def_float },
+	{ "<IFNOT>", "NE_F_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "NE_E_IFNOT", -1, false, &def_entity, &def_entity, &def_float },
+	{ "<IFNOT>", "LE_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "GE_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "LT_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "GT_IFNOT", -1, false, &def_float, &def_float, &def_float },
+	{ "<IFNOT>", "INDIRECT_F_IFNOT", -1, false, &def_object, &def_field, &def_float },
+	{ "<IFNOT>", "INDIRECT_BOOL_IFNOT", -1, false, &def_object, &def_field, &def_boolean },
+	{ "<IFNOT>", "NOT_BOOL_IFNOT", -1, false, &def_boolean, &def_void, &def_float },
+	{ "<IFNOT>", "NOT_F_IFNOT", -1, false, &def_float, &def_void, &def_float },
+
 	{ NULL }
 };
 
+// conditions that are merged with the OP_IFNOT testing their result
+static const struct
+{
+	int		op;
+	int		fusedOp;
+} fusedOpcodes[] =
+{
+	{ OP_EQ_F,			OP_EQ_F_IFNOT },
+	{ OP_EQ_E,			OP_EQ_E_IFNOT },
+	{ OP_NE_F,			OP_NE_F_IFNOT },
+	{ OP_NE_E,			OP_NE_E_IFNOT },
+	{ OP_LE,			OP_LE_IFNOT },
+	{ OP_GE,			OP_GE_IFNOT },
+	{ OP_LT,			OP_LT_IFNOT },
+	{ OP_GT,			OP_GT_IFNOT },
+	{ OP_INDIRECT_F,	OP_INDIRECT_F_IFNOT },
+	{ OP_INDIRECT_BOOL,	OP_INDIRECT_BOOL_IFNOT },
+	{ OP_NOT_BOOL,		OP_NOT_BOOL_IFNOT },
+	{ OP_NOT_F,			OP_NOT_F_IFNOT },
+	{ -1,				-1 }
+};
+
 /*
 ================
 idCompiler::idCompiler()
@@ -2074,6 +2109,65 @@ void idCompiler::PatchLoop( int start, int continuePos )
 	}
 }
 
+/*
+================
+idCompiler::FuseStatements
+
+Replaces a condition that is immediately tested by an OP_IFNOT with a single
+opcode that does both, so the interpreter dispatches once instead of twice.
+The OP_IFNOT is kept so any jump that lands on it still works.  Must be called
+once all the jumps in the range have been patched.
+================
+*/
+void idCompiler::FuseStatements( int start, int end )
+{
+	int			i, j;
+	statement_t*	pos;
+	statement_t*	next;
+
+	for( i = start; i < end - 1; i++ )
+	{
+		pos = &gameLocal.program.GetStatement( i );
+		next = &gameLocal.program.GetStatement( i + 1 );
+		if( ( next->op != OP_IFNOT ) || !pos->c || ( next->a != pos->c ) )
+		{
+			continue;
+		}
+
+		for( j = 0; fusedOpcodes[ j ].op >= 0; j++ )
+		{
+			if( fusedOpcodes[ j ].op == pos->op )
+			{
+				pos->op = fusedOpcodes[ j ].fusedOp;
+				break;
+			}
+		}
+	}
+}
+
+/*
+================
+idCompiler::UnfusedOpcode
+
+Returns the opcode the compiler originally emitted, so the program checksum
+doesn't depend on which statements were fused.
+================
+*/
+int idCompiler::UnfusedOpcode( int op )
+{
+	int j;
+
+	for( j = 0; fusedOpcodes[ j ].op >= 0; j++ )
+	{
+		if( fusedOpcodes[ j ].fusedOp == op )
+		{
+			return fusedOpcodes[ j ].op;
+		}
+	}
+
+	return op;
+}
+
 /*
 ================
 idCompiler::ParseReturnStatement
@@ -2743,6 +2837,9 @@ void idCompiler::ParseFunctionDef( idTypeDef* returnType, const char* name )
 	EmitOpcode( OP_RETURN, 0, 0 );
 #endif
 
+	// all jumps are final now
+	FuseStatements( func->firstStatement, gameLocal.program.NumStatements() );
+
 	// record the number of statements in the function
 	func->numStatements = gameLocal.program.NumStatements() - func->firstStatement;
 
@@ -3221,6 +3318,14 @@ void idCompiler::CompileFile( const char* text, const char* filename, bool toCon
 		throw idCompileError( error );
 	}
 
+	// an included file with only defines in it never produces a token for
+	// NextToken to number, but the compiled program cache has to check it too
+	const idList<idStr>& includedFiles = parser.GetIncludedFiles();
+	for( int i = 0; i < includedFiles.Num(); i++ )
+	{
+		gameLocal.program.GetFilenum( includedFiles[ i ] );
+	}
+
 	parser.FreeSource();
 
 	compile_time.Stop();
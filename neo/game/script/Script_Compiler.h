@@ -193,6 +193,21 @@ enum
 	OP_BREAK,			// placeholder op.  not used in final code
 	OP_CONTINUE,		// placeholder op.  not used in final code
 
+	// superinstructions that replace a condition followed by an OP_IFNOT on its result.
+	// the OP_IFNOT is left in place so jumps into it stay valid.
+	OP_EQ_F_IFNOT,
+	OP_EQ_E_IFNOT,
+	OP_NE_F_IFNOT,
+	OP_NE_E_IFNOT,
+	OP_LE_IFNOT,
+	OP_GE_IFNOT,
+	OP_LT_IFNOT,
+	OP_GT_IFNOT,
+	OP_INDIRECT_F_IFNOT,
+	OP_INDIRECT_BOOL_IFNOT,
+	OP_NOT_BOOL_IFNOT,
+	OP_NOT_F_IFNOT,
+
 	NUM_OPCODES
 };
 
@@ -257,6 +272,7 @@ private:
 	idVarDef*		GetExpression( int priority );
 	idTypeDef*		GetTypeForEventArg( char argType );
 	void			PatchLoop( int start, int continuePos );
+	void			FuseStatements( int start, int end );
 	void			ParseReturnStatement();
 	void			ParseWhileStatement();
 	void			ParseForStatement();
@@ -274,6 +290,8 @@ private:
 public :
 	static opcode_t	opcodes[];
 
+	static int		UnfusedOpcode( int op );
+
 	idCompiler();
 	void			CompileFile( const char* text, const char* filename, bool console );
 };
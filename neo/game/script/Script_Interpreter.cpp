@@ -43,6 +43,10 @@ idInterpreter::idInterpreter()
 	debug = 0;
 	memset( localstack, 0, sizeof( localstack ) );
 	memset( callStack, 0, sizeof( callStack ) );
+	profiling = false;
+	profileGeneration = -1;
+	profileInstructions = 0;
+	profileTicks = 0.0;
 	Reset();
 }
 
@@ -192,6 +196,8 @@ void idInterpreter::Reset()
 	currentFunction = 0;
 	NextInstruction( 0 );
 
+	profileNode = -1;
+
 	threadDying 	= false;
 	doneProcessing	= true;
 }
@@ -650,6 +656,11 @@ void idInterpreter::EnterFunction( const function_t* func, bool clearStack )
 	int 		c;
 	prstack_t*	stack;
 
+	if( profiling )
+	{
+		ProfileUpdate();
+	}
+
 	if( clearStack )
 	{
 		Reset();
@@ -699,6 +710,20 @@ void idInterpreter::EnterFunction( const function_t* func, bool clearStack )
 	assert( !func->eventdef );
 	NextInstruction( func->firstStatement );
 
+	if( profiling )
+	{
+		// the caller's node is still valid unless the stack was cleared
+		if( profileNode >= 0 )
+		{
+			profileNode = gameLocal.program.ProfileFunction( profileNode, func );
+		}
+		gameLocal.program.ProfileCall( ProfileNode() );
+	}
+	else
+	{
+		profileNode = -1;
+	}
+
 	// allocate space on the stack for locals
 	// parms are already on stack
 	c = func->locals - func->parmTotal;
@@ -736,6 +761,11 @@ void idInterpreter::LeaveFunction( idVarDef* returnDef )
 		Error( "prog stack underflow" );
 	}
 
+	if( profiling )
+	{
+		ProfileUpdate();
+	}
+
 	// return value
 	if( returnDef )
 	{
@@ -781,6 +811,15 @@ void idInterpreter::LeaveFunction( idVarDef* returnDef )
 	localstackBase = stack->stackbase;
 	NextInstruction( stack->s );
 
+	if( profiling )
+	{
+		profileNode = gameLocal.program.ProfileParent( profileNode );
+	}
+	else
+	{
+		profileNode = -1;
+	}
+
 	if( !callStackDepth )
 	{
 		// all done
@@ -790,6 +829,173 @@ void idInterpreter::LeaveFunction( idVarDef* returnDef )
 	}
 }
 
+/*
+================
+idInterpreter::ProfileNode
+
+Returns the profile node of the current call stack, looking it up again
+if it was lost or the profile has been cleared.
+================
+*/
+int idInterpreter::ProfileNode()
+{
+	int i;
+
+	if( ( profileNode < 0 ) || ( profileGeneration != gameLocal.program.ProfileGeneration() ) )
+	{
+		profileGeneration = gameLocal.program.ProfileGeneration();
+		profileNode = gameLocal.program.ProfileThread( thread ? thread->GetThreadName() : "" );
+		for( i = 0; i < callStackDepth; i++ )
+		{
+			if( callStack[ i ].f )
+			{
+				profileNode = gameLocal.program.ProfileFunction( profileNode, callStack[ i ].f );
+			}
+		}
+		if( currentFunction )
+		{
+			profileNode = gameLocal.program.ProfileFunction( profileNode, currentFunction );
+		}
+	}
+
+	return profileNode;
+}
+
+/*
+================
+idInterpreter::ProfileUpdate
+
+Charges the instructions run and time spent since the last update to the current function.
+================
+*/
+void idInterpreter::ProfileUpdate()
+{
+	double now;
+
+	now = sys->GetClockTicks();
+	gameLocal.program.ProfileTime( ProfileNode(), profileInstructions, now - profileTicks );
+	profileInstructions = 0;
+	profileTicks = now;
+}
+
+/*
+================
+idInterpreter::ProfileBeginEvent
+================
+*/
+int idInterpreter::ProfileBeginEvent( const idEventDef* evdef )
+{
+	if( !profiling )
+	{
+		return -1;
+	}
+
+	ProfileUpdate();
+
+	// anything the event does to this interpreter is charged to the event
+	profiling = false;
+
+	return gameLocal.program.ProfileEvent( ProfileNode(), evdef );
+}
+
+/*
+================
+idInterpreter::ProfileEndEvent
+================
+*/
+void idInterpreter::ProfileEndEvent( int node )
+{
+	double now;
+
+	if( node < 0 )
+	{
+		return;
+	}
+
+	now = sys->GetClockTicks();
+	if( profileGeneration == gameLocal.program.ProfileGeneration() )
+	{
+		gameLocal.program.ProfileCall( node );
+		gameLocal.program.ProfileTime( node, 0, now - profileTicks );
+	}
+	profileTicks = now;
+	profiling = true;
+}
+
+/*
+================
+idInterpreter::CopyEventArgs
+
+Copies the parms a script pushed for an event call into the event data, using the
+offsets the event def worked out when it was registered.  Returns false and kills
+the thread if an entity parm doesn't exist.
+================
+*/
+bool idInterpreter::CopyEventArgs( const idEventDef* evdef, int start, int argsize, int data[ D_EVENT_MAXARGS ] )
+{
+	int			i;
+	int			numArgs;
+	const char*	format;
+	varEval_t	var;
+
+	assert( argsize == evdef->GetScriptArgSize() );
+
+	numArgs = evdef->GetNumArgs();
+	if( evdef->ScriptArgsAreFloats() )
+	{
+		memcpy( data, &localstack[ start ], numArgs * sizeof( float ) );
+		return true;
+	}
+
+	format = evdef->GetArgFormat();
+	for( i = 0; i < numArgs; i++ )
+	{
+		var.intPtr = ( int* )&localstack[ start + evdef->GetScriptArgOffset( i ) ];
+		switch( format[ i ] )
+		{
+			case D_EVENT_INTEGER :
+				data[ i ] = int( *var.floatPtr );
+				break;
+
+			case D_EVENT_FLOAT :
+				( *( float* )&data[ i ] ) = *var.floatPtr;
+				break;
+
+			case D_EVENT_VECTOR :
+				( *( idVec3** )&data[ i ] ) = var.vectorPtr;
+				break;
+
+			case D_EVENT_STRING :
+				( *( const char** )&data[ i ] ) = var.stringPtr;
+				break;
+
+			case D_EVENT_ENTITY :
+				( *( idEntity** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
+				if( !( *( idEntity** )&data[ i ] ) )
+				{
+					Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
+					threadDying = true;
+					return false;
+				}
+				break;
+
+			case D_EVENT_ENTITY_NULL :
+				( *( idEntity** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
+				break;
+
+			case D_EVENT_TRACE :
+				Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
+				break;
+
+			default :
+				Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
+				break;
+		}
+	}
+
+	return true;
+}
+
 /*
 ================
 idInterpreter::CallEvent
@@ -797,14 +1003,11 @@ idInterpreter::CallEvent
 */
 void idInterpreter::CallEvent( const function_t* func, int argsize )
 {
-	int 				i;
-	int					j;
 	varEval_t			var;
-	int 				pos;
 	int 				start;
 	int					data[ D_EVENT_MAXARGS ];
 	const idEventDef*	evdef;
-	const char*			format;
+	int					profileEvent;
 
 	if( !func )
 	{
@@ -860,61 +1063,16 @@ void idInterpreter::CallEvent( const function_t* func, int argsize )
 		return;
 	}
 
-	format = evdef->GetArgFormat();
-	for( j = 0, i = 0, pos = type_object.Size(); ( pos < argsize ) || ( format[ i ] != 0 ); i++ )
+	if( !CopyEventArgs( evdef, start + type_object.Size(), argsize - type_object.Size(), data ) )
 	{
-		switch( format[ i ] )
-		{
-			case D_EVENT_INTEGER :
-				var.intPtr = ( int* )&localstack[ start + pos ];
-				data[ i ] = int( *var.floatPtr );
-				break;
-
-			case D_EVENT_FLOAT :
-				var.intPtr = ( int* )&localstack[ start + pos ];
-				( *( float* )&data[ i ] ) = *var.floatPtr;
-				break;
-
-			case D_EVENT_VECTOR :
-				var.intPtr = ( int* )&localstack[ start + pos ];
-				( *( idVec3** )&data[ i ] ) = var.vectorPtr;
-				break;
-
-			case D_EVENT_STRING :
-				( *( const char** )&data[ i ] ) = ( char* )&localstack[ start + pos ];
-				break;
-
-			case D_EVENT_ENTITY :
-				var.intPtr = ( int* )&localstack[ start + pos ];
-				( *( idEntity** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
-				if( !( *( idEntity** )&data[ i ] ) )
-				{
-					Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
-					threadDying = true;
-					PopParms( argsize );
-					return;
-				}
-				break;
-
-			case D_EVENT_ENTITY_NULL :
-				var.intPtr = ( int* )&localstack[ start + pos ];
-				( *( idEntity** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
-				break;
-
-			case D_EVENT_TRACE :
-				Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
-				break;
-
-			default :
-				Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
-				break;
-		}
-
-		pos += func->parmSize[ j++ ];
+		PopParms( argsize );
+		return;
 	}
 
 	popParms = argsize;
+	profileEvent = ProfileBeginEvent( evdef );
 	eventEntity->ProcessEventArgPtr( evdef, data );
+	ProfileEndEvent( profileEvent );
 
 	if( !multiFrameEvent )
 	{
@@ -987,14 +1145,10 @@ idInterpreter::CallSysEvent
 */
 void idInterpreter::CallSysEvent( const function_t* func, int argsize )
 {
-	int 				i;
-	int					j;
-	varEval_t			source;
-	int 				pos;
 	int 				start;
 	int					data[ D_EVENT_MAXARGS ];
 	const idEventDef*	evdef;
-	const char*			format;
+	int					profileEvent;
 
 	if( !func )
 	{
@@ -1006,61 +1160,16 @@ void idInterpreter::CallSysEvent( const function_t* func, int argsize )
 
 	start = localstackUsed - argsize;
 
-	format = evdef->GetArgFormat();
-	for( j = 0, i = 0, pos = 0; ( pos < argsize ) || ( format[ i ] != 0 ); i++ )
+	if( !CopyEventArgs( evdef, start, argsize, data ) )
 	{
-		switch( format[ i ] )
-		{
-			case D_EVENT_INTEGER :
-				source.intPtr = ( int* )&localstack[ start + pos ];
-				*( int* )&data[ i ] = int( *source.floatPtr );
-				break;
-
-			case D_EVENT_FLOAT :
-				source.intPtr = ( int* )&localstack[ start + pos ];
-				*( float* )&data[ i ] = *source.floatPtr;
-				break;
-
-			case D_EVENT_VECTOR :
-				source.intPtr = ( int* )&localstack[ start + pos ];
-				*( idVec3** )&data[ i ] = source.vectorPtr;
-				break;
-
-			case D_EVENT_STRING :
-				*( const char** )&data[ i ] = ( char* )&localstack[ start + pos ];
-				break;
-
-			case D_EVENT_ENTITY :
-				source.intPtr = ( int* )&localstack[ start + pos ];
-				*( idEntity** )&data[ i ] = GetEntity( *source.entityNumberPtr );
-				if( !*( idEntity** )&data[ i ] )
-				{
-					Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
-					threadDying = true;
-					PopParms( argsize );
-					return;
-				}
-				break;
-
-			case D_EVENT_ENTITY_NULL :
-				source.intPtr = ( int* )&localstack[ start + pos ];
-				*( idEntity** )&data[ i ] = GetEntity( *source.entityNumberPtr );
-				break;
-
-			case D_EVENT_TRACE :
-				Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
-				break;
-
-			default :
-				Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
-				break;
-		}
-
-		pos += func->parmSize[ j++ ];
+		PopParms( argsize );
+		return;
 	}
 
 	popParms = argsize;
+	profileEvent = ProfileBeginEvent( evdef );
 	thread->ProcessEventArgPtr( evdef, data );
+	ProfileEndEvent( profileEvent );
 	if( popParms )
 	{
 		PopParms( popParms );
@@ -1097,6 +1206,15 @@ bool idInterpreter::Execute()
 		instructionPointer--;
 	}
 
+	profiling = g_scriptProfile.GetBool();
+	if( profiling )
+	{
+		// count the frames each thread runs
+		gameLocal.program.ProfileCall( gameLocal.program.ProfileThread( thread ? thread->GetThreadName() : "" ) );
+		profileInstructions = 0;
+		profileTicks = sys->GetClockTicks();
+	}
+
 	runaway = 5000000;
 
 	doneProcessing = false;
@@ -1109,6 +1227,11 @@ bool idInterpreter::Execute()
 			Error( "runaway loop error" );
 		}
 
+		if( profiling )
+		{
+			profileInstructions++;
+		}
+
 		// next statement
 		st = &gameLocal.program.GetStatement( instructionPointer );
 
@@ -1197,6 +1320,116 @@ bool idInterpreter::Execute()
 				NextInstruction( instructionPointer + st->a->value.jumpOffset );
 				break;
 
+			case OP_EQ_F_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_EQ_E_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_NE_F_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_NE_E_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_LE_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_GE_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_LT_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_GT_IFNOT:
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_INDIRECT_F_IFNOT:
+				var_a = GetVariable( st->a );
+				var_c = GetVariable( st->c );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var_c.floatPtr = *var.floatPtr;
+				}
+				else
+				{
+					*var_c.floatPtr = 0.0f;
+				}
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_INDIRECT_BOOL_IFNOT:
+				var_a = GetVariable( st->a );
+				var_c = GetVariable( st->c );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var_c.intPtr = *var.intPtr;
+				}
+				else
+				{
+					*var_c.intPtr = 0;
+				}
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_NOT_BOOL_IFNOT:
+				var_a = GetVariable( st->a );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.intPtr == 0 );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
+			case OP_NOT_F_IFNOT:
+				var_a = GetVariable( st->a );
+				var_c = GetVariable( st->c );
+				*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+				FusedIfNot( *var_c.intPtr != 0 );
+				break;
+
 			case OP_ADD_F:
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
@@ -2058,5 +2291,11 @@ bool idInterpreter::Execute()
 		}
 	}
 
+	if( profiling )
+	{
+		ProfileUpdate();
+		profiling = false;
+	}
+
 	return threadDying;
 }
@@ -60,6 +60,13 @@ private:
 
 	idThread*			thread;
 
+	// g_scriptProfile
+	bool				profiling;
+	int					profileNode;
+	int					profileGeneration;
+	int					profileInstructions;
+	double				profileTicks;
+
 	void				PopParms( int numParms );
 	void				PushString( const char* string );
 	void				Push( int value );
@@ -71,11 +78,18 @@ private:
 	idEntity*			GetEntity( int entnum ) const;
 	idScriptObject*		GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
+	void				FusedIfNot( bool condition );
 
 	void				LeaveFunction( idVarDef* returnDef );
+	bool				CopyEventArgs( const idEventDef* evdef, int start, int argsize, int data[ D_EVENT_MAXARGS ] );
 	void				CallEvent( const function_t* func, int argsize );
 	void				CallSysEvent( const function_t* func, int argsize );
 
+	int					ProfileNode();
+	void				ProfileUpdate();
+	int					ProfileBeginEvent( const idEventDef* evdef );
+	void				ProfileEndEvent( int node );
+
 public:
 	bool				doneProcessing;
 	bool				threadDying;
@@ -302,4 +316,24 @@ ID_INLINE void idInterpreter::NextInstruction( int position )
 	instructionPointer = position - 1;
 }
 
+/*
+====================
+idInterpreter::FusedIfNot
+
+Finishes a fused condition by doing the work of the OP_IFNOT that follows it.
+====================
+*/
+ID_INLINE void idInterpreter::FusedIfNot( bool condition )
+{
+	if( condition )
+	{
+		// skip over the OP_IFNOT
+		instructionPointer++;
+	}
+	else
+	{
+		NextInstruction( instructionPointer + 1 + gameLocal.program.GetStatement( instructionPointer + 1 ).b->value.jumpOffset );
+	}
+}
+
 #endif /* !__SCRIPT_INTERPRETER_H__ */
@@ -2152,6 +2152,8 @@ void idProgram::FreeData()
 	statements.Clear();
 	functions.Clear();
 
+	ClearProfile();
+
 	top_functions	= 0;
 	top_statements	= 0;
 	top_types		= 0;
@@ -2161,6 +2163,645 @@ void idProgram::FreeData()
 	filename = "";
 }
 
+/***********************************************************************
+
+  Compiled program cache
+
+  The default script is compiled every time the game starts.  Once compiled,
+  the types, defs, functions, statements and global variables are written
+  out with pointers replaced by indices, along with a checksum of every
+  source file that went into them.  The next startup loads that image
+  instead of compiling when all the sources still match.
+
+***********************************************************************/
+
+#define SCRIPT_CACHE_IDENT		( ( 'T' << 24 ) + ( 'P' << 16 ) + ( 'C' << 8 ) + 'S' )
+#define SCRIPT_CACHE_VERSION	3
+
+// how a def's value is stored in the cache
+#define SCRIPT_VALUE_INT		0
+#define SCRIPT_VALUE_VARIABLE	1
+#define SCRIPT_VALUE_FUNCTION	2
+
+// referred to by negative numbers in the cache
+static idTypeDef* const builtinTypes[] =
+{
+	&type_void, &type_scriptevent, &type_namespace, &type_string, &type_float, &type_vector, &type_entity, &type_field,
+	&type_function, &type_virtualfunction, &type_pointer, &type_object, &type_jumpoffset, &type_argsize, &type_boolean,
+	NULL
+};
+
+static idVarDef* const builtinDefs[] =
+{
+	&def_void, &def_scriptevent, &def_namespace, &def_string, &def_float, &def_vector, &def_entity, &def_field,
+	&def_function, &def_virtualfunction, &def_pointer, &def_object, &def_jumpoffset, &def_argsize, &def_boolean,
+	NULL
+};
+
+/*
+================
+idProgram::CompiledTypeNum
+================
+*/
+int idProgram::CompiledTypeNum( const idTypeDef* type, const idHashIndex& typeHash ) const
+{
+	int i;
+
+	if( !type )
+	{
+		return -1;
+	}
+
+	for( i = 0; builtinTypes[ i ]; i++ )
+	{
+		if( builtinTypes[ i ] == type )
+		{
+			return -2 - i;
+		}
+	}
+
+	for( i = typeHash.First( typeHash.GenerateKey( type->Name(), true ) ); i != -1; i = typeHash.Next( i ) )
+	{
+		if( types[ i ] == type )
+		{
+			return i;
+		}
+	}
+
+	assert( 0 );
+	return -1;
+}
+
+/*
+================
+idProgram::CompiledDefNum
+================
+*/
+int idProgram::CompiledDefNum( const idVarDef* def ) const
+{
+	int i;
+
+	if( !def )
+	{
+		return -1;
+	}
+
+	for( i = 0; builtinDefs[ i ]; i++ )
+	{
+		if( builtinDefs[ i ] == def )
+		{
+			return -2 - i;
+		}
+	}
+
+	assert( varDefs[ def->num ] == def );
+	return def->num;
+}
+
+/*
+================
+idProgram::CompiledType
+================
+*/
+idTypeDef* idProgram::CompiledType( int num, bool& valid ) const
+{
+	if( num >= 0 )
+	{
+		if( num < types.Num() )
+		{
+			return types[ num ];
+		}
+	}
+	else if( num == -1 )
+	{
+		return NULL;
+	}
+	else if( -2 - num < ( int )( sizeof( builtinTypes ) / sizeof( builtinTypes[ 0 ] ) ) - 1 )
+	{
+		return builtinTypes[ -2 - num ];
+	}
+
+	valid = false;
+	return NULL;
+}
+
+/*
+================
+idProgram::CompiledDef
+================
+*/
+idVarDef* idProgram::CompiledDef( int num, bool& valid ) const
+{
+	if( num >= 0 )
+	{
+		if( num < varDefs.Num() )
+		{
+			return varDefs[ num ];
+		}
+	}
+	else if( num == -1 )
+	{
+		return NULL;
+	}
+	else if( -2 - num < ( int )( sizeof( builtinDefs ) / sizeof( builtinDefs[ 0 ] ) ) - 1 )
+	{
+		return builtinDefs[ -2 - num ];
+	}
+
+	valid = false;
+	return NULL;
+}
+
+/*
+================
+idProgram::CheckCompiledSources
+
+Reads the source list of a cached program and makes sure every file is unchanged.
+================
+*/
+bool idProgram::CheckCompiledSources( idFile* file )
+{
+	int		i;
+	int		num;
+	int		length;
+	int		checksum;
+	idStr	name;
+	void*	buffer;
+	bool	valid;
+
+	valid = true;
+
+	file->ReadInt( num );
+	if( ( num <= 0 ) || ( num > 0xffff ) )
+	{
+		return false;
+	}
+
+	for( i = 0; i < num; i++ )
+	{
+		file->ReadString( name );
+		file->ReadInt( length );
+		file->ReadInt( checksum );
+
+		if( !valid )
+		{
+			continue;
+		}
+
+		// a different length is enough to tell without loading it
+		if( ( length < 0 ) || ( fileSystem->ReadFile( name, NULL, NULL ) != length ) )
+		{
+			valid = false;
+			continue;
+		}
+
+		fileSystem->ReadFile( name, &buffer, NULL );
+		if( ( int )MD5_BlockChecksum( buffer, length ) != checksum )
+		{
+			valid = false;
+		}
+		fileSystem->FreeFile( buffer );
+
+		fileList.Append( name );
+	}
+
+	return valid;
+}
+
+/*
+================
+idProgram::ReadCompiled
+
+Returns false and leaves the program empty if the image is missing, out of date or damaged.
+================
+*/
+bool idProgram::ReadCompiled( const char* cacheName )
+{
+	int				i;
+	int				j;
+	int				num;
+	int				ident;
+	int				version;
+	int				numTypes;
+	int				numDefs;
+	int				numFunctions;
+	int				numStatements;
+	int				tag;
+	int				value;
+	idStr			name;
+	idStr			format;
+	char			returnType;
+	bool			valid;
+	idFile*			file;
+	idTimer			loadTime;
+
+	file = fileSystem->OpenFileRead( cacheName );
+	if( !file )
+	{
+		return false;
+	}
+
+	loadTime.Start();
+
+	FreeData();
+
+	file->ReadInt( ident );
+	file->ReadInt( version );
+	file->ReadInt( i );
+	file->ReadInt( j );
+	file->ReadInt( num );
+	if( ( ident != SCRIPT_CACHE_IDENT ) || ( version != SCRIPT_CACHE_VERSION ) || ( i != sizeof( void* ) ) || ( j != MAX_STRING_LEN ) || ( num != NUM_OPCODES ) )
+	{
+		fileSystem->CloseFile( file );
+		return false;
+	}
+
+	if( !CheckCompiledSources( file ) )
+	{
+		fileSystem->CloseFile( file );
+		FreeData();
+		gameLocal.Printf( "Script sources changed since %s was written\n", cacheName );
+		return false;
+	}
+
+	valid = true;
+
+	file->ReadInt( numTypes );
+	file->ReadInt( numDefs );
+	file->ReadInt( numFunctions );
+	file->ReadInt( numStatements );
+	file->ReadInt( numVariables );
+	if( ( numTypes < 0 ) || ( numTypes > 0xfffff ) || ( numDefs < 0 ) || ( numDefs > 0xfffff ) || ( numFunctions < 0 ) || ( numFunctions > functions.Max() ) ||
+			( numStatements <= 0 ) || ( numStatements > statements.Max() ) || ( numVariables < 0 ) || ( numVariables > ( int )sizeof( variables ) ) )
+	{
+		valid = false;
+		numTypes = numDefs = numFunctions = numStatements = numVariables = 0;
+	}
+
+	// allocate everything first so references can be resolved as they're read
+	for( i = 0; i < numTypes; i++ )
+	{
+		AllocType( ev_void, NULL, "", 0, NULL );
+	}
+	for( i = 0; i < numDefs; i++ )
+	{
+		varDefs.Append( new idVarDef() );
+	}
+	functions.SetNum( numFunctions );
+	statements.SetNum( numStatements );
+
+	for( i = 0; i < numTypes && valid; i++ )
+	{
+		idTypeDef* type = types[ i ];
+
+		file->ReadInt( value );
+		type->type = ( etype_t )value;
+		file->ReadString( type->name );
+		file->ReadInt( type->size );
+		file->ReadInt( value );
+		type->auxType = CompiledType( value, valid );
+		file->ReadInt( value );
+		type->def = CompiledDef( value, valid );
+
+		file->ReadInt( num );
+		if( ( num < 0 ) || ( num > D_EVENT_MAXARGS * 16 ) )
+		{
+			valid = false;
+			break;
+		}
+		for( j = 0; j < num; j++ )
+		{
+			file->ReadInt( value );
+			file->ReadString( name );
+			type->parmTypes.Append( CompiledType( value, valid ) );
+			type->parmNames.Append( name );
+		}
+
+		file->ReadInt( num );
+		if( ( num < 0 ) || ( num > numFunctions ) )
+		{
+			valid = false;
+			break;
+		}
+		for( j = 0; j < num; j++ )
+		{
+			file->ReadInt( value );
+			if( ( value < 0 ) || ( value >= numFunctions ) )
+			{
+				valid = false;
+				break;
+			}
+			type->functions.Append( &functions[ value ] );
+		}
+	}
+
+	for( i = 0; i < numDefs && valid; i++ )
+	{
+		idVarDef* def = varDefs[ i ];
+
+		def->num = i;
+		file->ReadString( name );
+		AddDefToNameList( def, name );
+		file->ReadInt( value );
+		def->SetTypeDef( CompiledType( value, valid ) );
+		file->ReadInt( value );
+		def->scope = CompiledDef( value, valid );
+		file->ReadInt( def->numUsers );
+		file->ReadInt( value );
+		def->initialized = ( idVarDef::initialized_t )value;
+
+		file->ReadInt( tag );
+		file->ReadInt( value );
+		switch( tag )
+		{
+			case SCRIPT_VALUE_INT :
+				def->value.ptrOffset = value;
+				break;
+
+			case SCRIPT_VALUE_VARIABLE :
+				if( ( value < 0 ) || ( value > numVariables ) )
+				{
+					valid = false;
+					break;
+				}
+				def->value.bytePtr = &variables[ value ];
+				break;
+
+			case SCRIPT_VALUE_FUNCTION :
+				if( ( value < -1 ) || ( value >= numFunctions ) )
+				{
+					valid = false;
+					break;
+				}
+				def->value.functionPtr = ( value >= 0 ) ? &functions[ value ] : NULL;
+				break;
+
+			default :
+				valid = false;
+				break;
+		}
+	}
+
+	for( i = 0; i < numFunctions && valid; i++ )
+	{
+		function_t& func = functions[ i ];
+
+		func.Clear();
+		file->ReadString( name );
+		func.SetName( name );
+
+		// native events have to match the ones the game was built with
+		file->ReadString( name );
+		if( name.Length() )
+		{
+			file->ReadString( format );
+			file->ReadChar( returnType );
+			func.eventdef = idEventDef::FindEvent( name );
+			if( !func.eventdef || idStr::Cmp( func.eventdef->GetArgFormat(), format ) || ( func.eventdef->GetReturnType() != returnType ) )
+			{
+				valid = false;
+				break;
+			}
+		}
+
+		file->ReadInt( value );
+		func.def = CompiledDef( value, valid );
+		file->ReadInt( value );
+		func.type = CompiledType( value, valid );
+		file->ReadInt( func.firstStatement );
+		file->ReadInt( func.numStatements );
+		file->ReadInt( func.parmTotal );
+		file->ReadInt( func.locals );
+		file->ReadInt( func.filenum );
+
+		file->ReadInt( num );
+		if( ( num < 0 ) || ( num > D_EVENT_MAXARGS * 16 ) || ( func.firstStatement < 0 ) || ( func.firstStatement + func.numStatements > numStatements ) )
+		{
+			valid = false;
+			break;
+		}
+		func.parmSize.SetGranularity( 1 );
+		func.parmSize.SetNum( num );
+		for( j = 0; j < num; j++ )
+		{
+			file->ReadInt( func.parmSize[ j ] );
+		}
+	}
+
+	for( i = 0; i < numStatements && valid; i++ )
+	{
+		statement_t& st = statements[ i ];
+
+		file->ReadUnsignedShort( st.op );
+		file->ReadInt( value );
+		st.a = CompiledDef( value, valid );
+		file->ReadInt( value );
+		st.b = CompiledDef( value, valid );
+		file->ReadInt( value );
+		st.c = CompiledDef( value, valid );
+		file->ReadUnsignedShort( st.linenumber );
+		file->ReadUnsignedShort( st.file );
+		if( st.op >= NUM_OPCODES )
+		{
+			valid = false;
+		}
+	}
+
+	if( valid )
+	{
+		file->Read( variables, numVariables );
+
+		file->ReadInt( value );
+		returnDef = CompiledDef( value, valid );
+		file->ReadInt( value );
+		returnStringDef = CompiledDef( value, valid );
+		file->ReadInt( value );
+		sysDef = CompiledDef( value, valid );
+
+		file->ReadInt( ident );
+		if( ident != SCRIPT_CACHE_IDENT )
+		{
+			valid = false;
+		}
+	}
+
+	fileSystem->CloseFile( file );
+
+	if( !valid )
+	{
+		gameLocal.Warning( "%s is damaged, compiling scripts", cacheName );
+		FreeData();
+		return false;
+	}
+
+	loadTime.Stop();
+	gameLocal.Printf( "Loaded compiled scripts from %s in %.1f ms\n", cacheName, loadTime.Milliseconds() );
+
+	return true;
+}
+
+/*
+================
+idProgram::WriteCompiled
+================
+*/
+void idProgram::WriteCompiled( const char* cacheName ) const
+{
+	int				i;
+	int				j;
+	int				length;
+	void*			buffer;
+	idFile*			file;
+	idHashIndex		typeHash;
+
+	file = fileSystem->OpenFileWrite( cacheName );
+	if( !file )
+	{
+		gameLocal.Warning( "Couldn't write %s", cacheName );
+		return;
+	}
+
+	file->WriteInt( SCRIPT_CACHE_IDENT );
+	file->WriteInt( SCRIPT_CACHE_VERSION );
+	file->WriteInt( sizeof( void* ) );
+	file->WriteInt( MAX_STRING_LEN );
+	file->WriteInt( NUM_OPCODES );
+
+	// every file the program was compiled from
+	file->WriteInt( fileList.Num() );
+	for( i = 0; i < fileList.Num(); i++ )
+	{
+		length = fileSystem->ReadFile( fileList[ i ], &buffer, NULL );
+		file->WriteString( fileList[ i ] );
+		file->WriteInt( length );
+		file->WriteInt( ( length >= 0 ) ? ( int )MD5_BlockChecksum( buffer, length ) : 0 );
+		if( length >= 0 )
+		{
+			fileSystem->FreeFile( buffer );
+		}
+	}
+
+	file->WriteInt( types.Num() );
+	file->WriteInt( varDefs.Num() );
+	file->WriteInt( functions.Num() );
+	file->WriteInt( statements.Num() );
+	file->WriteInt( numVariables );
+
+	for( i = 0; i < types.Num(); i++ )
+	{
+		typeHash.Add( typeHash.GenerateKey( types[ i ]->Name(), true ), i );
+	}
+
+	for( i = 0; i < types.Num(); i++ )
+	{
+		const idTypeDef* type = types[ i ];
+
+		file->WriteInt( type->type );
+		file->WriteString( type->name );
+		file->WriteInt( type->size );
+		file->WriteInt( CompiledTypeNum( type->auxType, typeHash ) );
+		file->WriteInt( CompiledDefNum( type->def ) );
+
+		file->WriteInt( type->parmTypes.Num() );
+		for( j = 0; j < type->parmTypes.Num(); j++ )
+		{
+			file->WriteInt( CompiledTypeNum( type->parmTypes[ j ], typeHash ) );
+			file->WriteString( type->parmNames[ j ] );
+		}
+
+		file->WriteInt( type->functions.Num() );
+		for( j = 0; j < type->functions.Num(); j++ )
+		{
+			file->WriteInt( type->functions[ j ] - functions.Ptr() );
+		}
+	}
+
+	for( i = 0; i < varDefs.Num(); i++ )
+	{
+		const idVarDef* def = varDefs[ i ];
+
+		file->WriteString( def->Name() );
+		file->WriteInt( CompiledTypeNum( def->TypeDef(), typeHash ) );
+		file->WriteInt( CompiledDefNum( def->scope ) );
+		file->WriteInt( def->numUsers );
+		file->WriteInt( def->initialized );
+
+		// the type and scope say what the value holds, an int with a stale upper half
+		// can look like a pointer on 64 bit
+		if( def->Type() == ev_function )
+		{
+			file->WriteInt( SCRIPT_VALUE_FUNCTION );
+			file->WriteInt( def->value.functionPtr ? def->value.functionPtr - functions.Ptr() : -1 );
+		}
+		else if( ( def->Type() == ev_jumpoffset ) || ( def->Type() == ev_argsize ) || ( def->Type() == ev_virtualfunction ) ||
+				 ( def->scope && ( ( def->scope->Type() == ev_function ) || def->scope->TypeDef()->Inherits( &type_object ) ) ) )
+		{
+			// jump offsets, argument sizes, virtual function indices, stack offsets of locals and object field offsets
+			file->WriteInt( SCRIPT_VALUE_INT );
+			file->WriteInt( def->value.ptrOffset );
+		}
+		else
+		{
+			file->WriteInt( SCRIPT_VALUE_VARIABLE );
+			file->WriteInt( def->value.bytePtr - variables );
+		}
+	}
+
+	for( i = 0; i < functions.Num(); i++ )
+	{
+		const function_t& func = functions[ i ];
+
+		file->WriteString( func.Name() );
+		if( func.eventdef )
+		{
+			file->WriteString( func.eventdef->GetName() );
+			file->WriteString( func.eventdef->GetArgFormat() );
+			file->WriteChar( func.eventdef->GetReturnType() );
+		}
+		else
+		{
+			file->WriteString( "" );
+		}
+		file->WriteInt( CompiledDefNum( func.def ) );
+		file->WriteInt( CompiledTypeNum( func.type, typeHash ) );
+		file->WriteInt( func.firstStatement );
+		file->WriteInt( func.numStatements );
+		file->WriteInt( func.parmTotal );
+		file->WriteInt( func.locals );
+		file->WriteInt( func.filenum );
+
+		file->WriteInt( func.parmSize.Num() );
+		for( j = 0; j < func.parmSize.Num(); j++ )
+		{
+			file->WriteInt( func.parmSize[ j ] );
+		}
+	}
+
+	for( i = 0; i < statements.Num(); i++ )
+	{
+		const statement_t& st = statements[ i ];
+
+		file->WriteUnsignedShort( st.op );
+		file->WriteInt( CompiledDefNum( st.a ) );
+		file->WriteInt( CompiledDefNum( st.b ) );
+		file->WriteInt( CompiledDefNum( st.c ) );
+		file->WriteUnsignedShort( st.linenumber );
+		file->WriteUnsignedShort( st.file );
+	}
+
+	file->Write( variables, numVariables );
+
+	file->WriteInt( CompiledDefNum( returnDef ) );
+	file->WriteInt( CompiledDefNum( returnStringDef ) );
+	file->WriteInt( CompiledDefNum( sysDef ) );
+
+	file->WriteInt( SCRIPT_CACHE_IDENT );
+
+	fileSystem->CloseFile( file );
+
+	gameLocal.Printf( "Wrote compiled scripts to %s\n", cacheName );
+}
+
 /*
 ================
 idProgram::Startup
@@ -2168,11 +2809,26 @@ idProgram::Startup
 */
 void idProgram::Startup( const char* defaultScript )
 {
+	idStr cacheName;
+
 	gameLocal.Printf( "Initializing scripts\n" );
 
 	// make sure all data is freed up
 	idThread::Restart();
 
+	if( defaultScript && *defaultScript && g_scriptCache.GetBool() && !g_disasm.GetBool() )
+	{
+		cacheName = "compiled/";
+		cacheName += defaultScript;
+		cacheName.SetFileExtension( "bin" );
+
+		if( ReadCompiled( cacheName ) )
+		{
+			FinishCompilation();
+			return;
+		}
+	}
+
 	// get ready for loading scripts
 	BeginCompilation();
 
@@ -2183,6 +2839,11 @@ void idProgram::Startup( const char* defaultScript )
 	}
 
 	FinishCompilation();
+
+	if( cacheName.Length() )
+	{
+		WriteCompiled( cacheName );
+	}
 }
 
 /*
@@ -2293,7 +2954,7 @@ int idProgram::CalculateChecksum() const
 	// Copy info into new list, using the variable numbers instead of a pointer to the variable
 	for( i = 0; i < statements.Num(); i++ )
 	{
-		statementList[i].op = statements[i].op;
+		statementList[i].op = idCompiler::UnfusedOpcode( statements[i].op );
 
 		if( statements[i].a )
 		{
@@ -2371,6 +3032,9 @@ void idProgram::Restart()
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
+	// the profile refers to functions by index
+	ClearProfile();
+
 	// reset the variables to their default values
 	numVariables = variableDefaults.Num();
 	for( i = 0; i < numVariables; i++ )
@@ -2416,6 +3080,7 @@ idProgram::idProgram
 */
 idProgram::idProgram()
 {
+	profileGeneration = 0;
 	FreeData();
 }
 
@@ -2429,6 +3094,364 @@ idProgram::~idProgram()
 	FreeData();
 }
 
+/***********************************************************************
+
+  Script profiling
+
+  While g_scriptProfile is set every interpreter charges the instructions it
+  runs and the time it spends to a node for its current call stack, rooted
+  at the name of its thread.  Native event calls get a node of their own
+  below the function that made them.
+
+***********************************************************************/
+
+typedef struct scriptProfileEntry_s
+{
+	const char*		name;
+	int				calls;
+	int				instructions;
+	double			selfTicks;
+	double			totalTicks;
+} scriptProfileEntry_t;
+
+/*
+================
+SortProfileEntries
+================
+*/
+static int SortProfileEntries( const scriptProfileEntry_t* a, const scriptProfileEntry_t* b )
+{
+	if( a->selfTicks > b->selfTicks )
+	{
+		return -1;
+	}
+	if( a->selfTicks < b->selfTicks )
+	{
+		return 1;
+	}
+	return 0;
+}
+
+/*
+================
+PrintProfileEntries
+================
+*/
+static void PrintProfileEntries( const char* title, idList<scriptProfileEntry_t>& entries, int count, double toMsec )
+{
+	int i;
+
+	for( i = entries.Num() - 1; i >= 0; i-- )
+	{
+		if( !entries[ i ].calls && !entries[ i ].instructions && entries[ i ].totalTicks <= 0.0 )
+		{
+			entries.RemoveIndex( i );
+		}
+	}
+	entries.Sort( SortProfileEntries );
+
+	gameLocal.Printf( "\n%s:\n", title );
+	gameLocal.Printf( "   calls     instr   self ms  total ms  name\n" );
+	for( i = 0; i < entries.Num() && i < count; i++ )
+	{
+		const scriptProfileEntry_t& e = entries[ i ];
+		gameLocal.Printf( "%8d %9d %9.2f %9.2f  %s\n", e.calls, e.instructions, e.selfTicks * toMsec, e.totalTicks * toMsec, e.name );
+	}
+	if( entries.Num() > count )
+	{
+		gameLocal.Printf( "...%d more\n", entries.Num() - count );
+	}
+}
+
+/*
+================
+idProgram::GetProfileNode
+================
+*/
+int idProgram::GetProfileNode( int parent, int function, int event, int thread )
+{
+	int i;
+	int key;
+
+	key = profileHash.GenerateKey( parent, ( function >= 0 ) ? function : ( ( event >= 0 ) ? -2 - event : thread ) );
+	for( i = profileHash.First( key ); i != -1; i = profileHash.Next( i ) )
+	{
+		const scriptProfileNode_t& node = profileNodes[ i ];
+		if( ( node.parent == parent ) && ( node.function == function ) && ( node.event == event ) && ( node.thread == thread ) )
+		{
+			return i;
+		}
+	}
+
+	scriptProfileNode_t& node = profileNodes.Alloc();
+	node.parent			= parent;
+	node.function		= function;
+	node.event			= event;
+	node.thread			= thread;
+	node.calls			= 0;
+	node.instructions	= 0;
+	node.ticks			= 0.0;
+
+	i = profileNodes.Num() - 1;
+	profileHash.Add( key, i );
+
+	return i;
+}
+
+/*
+================
+idProgram::GetProfileNodeName
+================
+*/
+const char* idProgram::GetProfileNodeName( int node ) const
+{
+	const scriptProfileNode_t& n = profileNodes[ node ];
+
+	if( n.function >= 0 )
+	{
+		return functions[ n.function ].Name();
+	}
+	if( n.event >= 0 )
+	{
+		return idEventDef::GetEventCommand( n.event )->GetName();
+	}
+	return profileThreadNames[ n.thread ];
+}
+
+/*
+================
+idProgram::ProfileThread
+================
+*/
+int idProgram::ProfileThread( const char* threadName )
+{
+	return GetProfileNode( -1, -1, -1, profileThreadNames.AddUnique( threadName ) );
+}
+
+/*
+================
+idProgram::ClearProfile
+================
+*/
+void idProgram::ClearProfile()
+{
+	profileNodes.Clear();
+	profileHash.Clear();
+	profileThreadNames.Clear();
+
+	// makes the interpreters look up their nodes again
+	profileGeneration++;
+}
+
+/*
+================
+idProgram::PrintProfile
+================
+*/
+void idProgram::PrintProfile( int count ) const
+{
+	int								i;
+	int								j;
+	int								num;
+	double							toMsec;
+	double							ticks;
+	int								instructions;
+	idList<double>					totalTicks;
+	idList<int>						totalInstructions;
+	idList<scriptProfileEntry_t>	funcEntries;
+	idList<scriptProfileEntry_t>	eventEntries;
+	idList<scriptProfileEntry_t>	threadEntries;
+	scriptProfileEntry_t*			e;
+
+	num = profileNodes.Num();
+	if( !num )
+	{
+		gameLocal.Printf( "No script profile recorded.  Set g_scriptProfile to 1 to record one.\n" );
+		return;
+	}
+
+	toMsec = 1000.0 / sys->ClockTicksPerSecond();
+
+	// children are always added after their parent, so walking back sums up whole call stacks
+	totalTicks.SetNum( num );
+	totalInstructions.SetNum( num );
+	for( i = 0; i < num; i++ )
+	{
+		totalTicks[ i ] = profileNodes[ i ].ticks;
+		totalInstructions[ i ] = profileNodes[ i ].instructions;
+	}
+	for( i = num - 1; i >= 0; i-- )
+	{
+		if( profileNodes[ i ].parent >= 0 )
+		{
+			totalTicks[ profileNodes[ i ].parent ] += totalTicks[ i ];
+			totalInstructions[ profileNodes[ i ].parent ] += totalInstructions[ i ];
+		}
+	}
+
+	funcEntries.SetNum( functions.Num() );
+	memset( funcEntries.Ptr(), 0, funcEntries.Num() * sizeof( scriptProfileEntry_t ) );
+	for( i = 0; i < functions.Num(); i++ )
+	{
+		funcEntries[ i ].name = functions[ i ].Name();
+	}
+
+	eventEntries.SetNum( idEventDef::NumEventCommands() );
+	memset( eventEntries.Ptr(), 0, eventEntries.Num() * sizeof( scriptProfileEntry_t ) );
+	for( i = 0; i < eventEntries.Num(); i++ )
+	{
+		eventEntries[ i ].name = idEventDef::GetEventCommand( i )->GetName();
+	}
+
+	threadEntries.SetNum( profileThreadNames.Num() );
+	memset( threadEntries.Ptr(), 0, threadEntries.Num() * sizeof( scriptProfileEntry_t ) );
+	for( i = 0; i < threadEntries.Num(); i++ )
+	{
+		threadEntries[ i ].name = profileThreadNames[ i ];
+	}
+
+	ticks = 0.0;
+	instructions = 0;
+	for( i = 0; i < num; i++ )
+	{
+		const scriptProfileNode_t& node = profileNodes[ i ];
+
+		if( node.function >= 0 )
+		{
+			e = &funcEntries[ node.function ];
+			e->instructions += node.instructions;
+		}
+		else if( node.event >= 0 )
+		{
+			e = &eventEntries[ node.event ];
+		}
+		else
+		{
+			// a thread counts everything it ran
+			e = &threadEntries[ node.thread ];
+			e->instructions += totalInstructions[ i ];
+			e->calls += node.calls;
+			e->selfTicks += totalTicks[ i ];
+			e->totalTicks += totalTicks[ i ];
+			ticks += totalTicks[ i ];
+			instructions += totalInstructions[ i ];
+			continue;
+		}
+
+		e->calls += node.calls;
+		e->selfTicks += node.ticks;
+
+		// don't count the time of recursive calls twice
+		for( j = node.parent; j >= 0; j = profileNodes[ j ].parent )
+		{
+			if( ( profileNodes[ j ].function == node.function ) && ( profileNodes[ j ].event == node.event ) )
+			{
+				break;
+			}
+		}
+		if( j < 0 )
+		{
+			e->totalTicks += totalTicks[ i ];
+		}
+	}
+
+	PrintProfileEntries( "functions", funcEntries, count, toMsec );
+	PrintProfileEntries( "events", eventEntries, count, toMsec );
+	PrintProfileEntries( "threads (calls are frames run)", threadEntries, count, toMsec );
+	gameLocal.Printf( "\n%.2f ms in %d instructions\n", ticks * toMsec, instructions );
+}
+
+/*
+================
+idProgram::WriteProfileStacks
+
+Writes one line per call stack in the folded format flame graph tools read:
+"thread;function;function;event microseconds"
+================
+*/
+void idProgram::WriteProfileStacks( const char* filename ) const
+{
+	int		i;
+	int		j;
+	idFile*	file;
+	idStr	stack;
+	idStr	name;
+	double	toUsec;
+	idList<int>	path;
+
+	file = fileSystem->OpenFileWrite( filename );
+	if( !file )
+	{
+		gameLocal.Warning( "Couldn't open '%s'", filename );
+		return;
+	}
+
+	toUsec = 1000000.0 / sys->ClockTicksPerSecond();
+	for( i = 0; i < profileNodes.Num(); i++ )
+	{
+		if( profileNodes[ i ].ticks * toUsec < 1.0 )
+		{
+			continue;
+		}
+
+		path.SetNum( 0, false );
+		for( j = i; j >= 0; j = profileNodes[ j ].parent )
+		{
+			path.Append( j );
+		}
+
+		stack.Clear();
+		for( j = path.Num() - 1; j >= 0; j-- )
+		{
+			name = GetProfileNodeName( path[ j ] );
+			name.Replace( " ", "_" );
+			name.Replace( ";", "_" );
+			stack += name;
+			if( j > 0 )
+			{
+				stack += ";";
+			}
+		}
+
+		file->Printf( "%s %d\n", stack.c_str(), idMath::FtoiFast( profileNodes[ i ].ticks * toUsec ) );
+	}
+
+	fileSystem->CloseFile( file );
+
+	gameLocal.Printf( "wrote script call stacks to %s\n", filename );
+}
+
+/*
+================
+idProgram::ScriptProfile_f
+================
+*/
+void idProgram::ScriptProfile_f( const idCmdArgs& args )
+{
+	const char*	filename;
+	int			count;
+
+	if( ( args.Argc() > 1 ) && !idStr::Icmp( args.Argv( 1 ), "clear" ) )
+	{
+		gameLocal.program.ClearProfile();
+		return;
+	}
+
+	if( ( args.Argc() > 1 ) && !idStr::Icmp( args.Argv( 1 ), "stacks" ) )
+	{
+		filename = ( args.Argc() > 2 ) ? args.Argv( 2 ) : "scriptprofile.txt";
+		gameLocal.program.WriteProfileStacks( filename );
+		return;
+	}
+
+	count = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 0;
+	if( count <= 0 )
+	{
+		count = 20;
+	}
+	gameLocal.program.PrintProfile( count );
+}
+
 /*
 ================
 idProgram::ReturnEntity
@@ -93,6 +93,8 @@ Contains type information for variables and functions.
 
 class idTypeDef
 {
+	friend class idProgram;
+
 private:
 	etype_t						type;
 	idStr 						name;
@@ -468,6 +470,18 @@ typedef struct statement_s
 	unsigned short	file;
 } statement_t;
 
+// time and instructions spent in one call stack while g_scriptProfile is set
+typedef struct scriptProfileNode_s
+{
+	int				parent;				// -1 for the root of a thread
+	int				function;			// function index, -1 for thread roots and event calls
+	int				event;				// event number of a native event call, -1 otherwise
+	int				thread;				// thread name index for thread roots
+	int				calls;
+	int				instructions;
+	double			ticks;				// clock ticks spent in the node itself, children excluded
+} scriptProfileNode_t;
+
 /***********************************************************************
 
 idProgram
@@ -504,8 +518,25 @@ private:
 	int											top_defs;
 	int											top_files;
 
+	idList<scriptProfileNode_t>					profileNodes;
+	idHashIndex									profileHash;
+	idStrList									profileThreadNames;
+	int											profileGeneration;		// changes when the nodes are cleared
+
 	void										CompileStats();
 
+	// compiled program cache
+	bool										ReadCompiled( const char* cacheName );
+	void										WriteCompiled( const char* cacheName ) const;
+	bool										CheckCompiledSources( idFile* file );
+	int											CompiledTypeNum( const idTypeDef* type, const idHashIndex& typeHash ) const;
+	int											CompiledDefNum( const idVarDef* def ) const;
+	idTypeDef*									CompiledType( int num, bool& valid ) const;
+	idVarDef*									CompiledDef( int num, bool& valid ) const;
+
+	int											GetProfileNode( int parent, int function, int event, int thread );
+	const char*									GetProfileNodeName( int node ) const;
+
 public:
 	idVarDef*									returnDef;
 	idVarDef*									returnStringDef;
@@ -574,6 +605,20 @@ public:
 	{
 		return fileList.Num();
 	}
+
+	// script profiling
+	int											ProfileGeneration() const;
+	int											ProfileThread( const char* threadName );
+	int											ProfileFunction( int parent, const function_t* func );
+	int											ProfileEvent( int parent, const idEventDef* ev );
+	void										ProfileCall( int node );
+	void										ProfileTime( int node, int instructions, double ticks );
+	int											ProfileParent( int node ) const;
+	void										ClearProfile();
+	void										PrintProfile( int count ) const;
+	void										WriteProfileStacks( const char* filename ) const;
+
+	static void									ScriptProfile_f( const idCmdArgs& args );
 };
 
 /*
@@ -606,6 +651,67 @@ ID_INLINE int idProgram::GetFunctionIndex( const function_t* func )
 	return func - &functions[0];
 }
 
+/*
+================
+idProgram::ProfileGeneration
+================
+*/
+ID_INLINE int idProgram::ProfileGeneration() const
+{
+	return profileGeneration;
+}
+
+/*
+================
+idProgram::ProfileFunction
+================
+*/
+ID_INLINE int idProgram::ProfileFunction( int parent, const function_t* func )
+{
+	return GetProfileNode( parent, func - &functions[0], -1, -1 );
+}
+
+/*
+================
+idProgram::ProfileEvent
+================
+*/
+ID_INLINE int idProgram::ProfileEvent( int parent, const idEventDef* ev )
+{
+	return GetProfileNode( parent, -1, ev->GetEventNum(), -1 );
+}
+
+/*
+================
+idProgram::ProfileCall
+================
+*/
+ID_INLINE void idProgram::ProfileCall( int node )
+{
+	profileNodes[ node ].calls++;
+}
+
+/*
+================
+idProgram::ProfileTime
+================
+*/
+ID_INLINE void idProgram::ProfileTime( int node, int instructions, double ticks )
+{
+	profileNodes[ node ].instructions += instructions;
+	profileNodes[ node ].ticks += ticks;
+}
+
+/*
+================
+idProgram::ProfileParent
+================
+*/
+ID_INLINE int idProgram::ProfileParent( int node ) const
+{
+	return profileNodes[ node ].parent;
+}
+
 /*
 ================
 idProgram::GetReturnedInteger
@@ -37,6 +37,10 @@ If you have questions concerning this license or the applicable additional terms
 	//	#define CRASH_ON_STATIC_ALLOCATION
 #endif
 
+#ifndef _WIN32
+	#include <sched.h>
+#endif
+
 //===============================================================
 //
 //	idHeap
@@ -1181,6 +1185,76 @@ void Mem_UpdateFreeStats( int size )
 	mem_total_allocs.totalSize -= size;
 }
 
+/*
+==================
+Mem_BeginThreadSafeAllocs
+
+The heap is only used from the main thread, except while job threads run work
+that allocates. Those jobs are bracketed with Mem_BeginThreadSafeAllocs and
+Mem_EndThreadSafeAllocs, in between every heap access takes a spin lock.
+==================
+*/
+static volatile int		mem_threadSafe = 0;
+static volatile long	mem_heapLock = 0;
+
+void Mem_BeginThreadSafeAllocs()
+{
+	mem_threadSafe++;
+}
+
+/*
+==================
+Mem_EndThreadSafeAllocs
+==================
+*/
+void Mem_EndThreadSafeAllocs()
+{
+	assert( mem_threadSafe > 0 );
+	mem_threadSafe--;
+}
+
+/*
+==================
+Mem_LockAllocator
+==================
+*/
+void Mem_LockAllocator( volatile long& lock )
+{
+	if( !mem_threadSafe )
+	{
+		return;
+	}
+#ifdef _WIN32
+	while( InterlockedCompareExchange( &lock, 1, 0 ) != 0 )
+	{
+		Sleep( 0 );
+	}
+#else
+	while( !__sync_bool_compare_and_swap( &lock, 0, 1 ) )
+	{
+		sched_yield();
+	}
+#endif
+}
+
+/*
+==================
+Mem_UnlockAllocator
+==================
+*/
+void Mem_UnlockAllocator( volatile long& lock )
+{
+	if( !mem_threadSafe )
+	{
+		return;
+	}
+#ifdef _WIN32
+	InterlockedExchange( &lock, 0 );
+#else
+	__sync_lock_release( &lock );
+#endif
+}
+
 
 #ifndef ID_DEBUG_MEMORY
 
@@ -1202,8 +1276,10 @@ void* Mem_Alloc( const int size )
 #endif
 		return malloc( size );
 	}
+	Mem_LockAllocator( mem_heapLock );
 	void* mem = mem_heap->Allocate( size );
 	Mem_UpdateAllocStats( mem_heap->Msize( mem ) );
+	Mem_UnlockAllocator( mem_heapLock );
 	return mem;
 }
 
@@ -1226,8 +1302,10 @@ void Mem_Free( void* ptr )
 		free( ptr );
 		return;
 	}
+	Mem_LockAllocator( mem_heapLock );
 	Mem_UpdateFreeStats( mem_heap->Msize( ptr ) );
 	mem_heap->Free( ptr );
+	Mem_UnlockAllocator( mem_heapLock );
 }
 
 /*
@@ -1248,7 +1326,9 @@ void* Mem_Alloc16( const int size )
 #endif
 		return malloc( size );
 	}
+	Mem_LockAllocator( mem_heapLock );
 	void* mem = mem_heap->Allocate16( size );
+	Mem_UnlockAllocator( mem_heapLock );
 	// make sure the memory is 16 byte aligned
 	assert( ( ( ( int )mem ) & 15 ) == 0 );
 	return mem;
@@ -1275,7 +1355,9 @@ void Mem_Free16( void* ptr )
 	}
 	// make sure the memory is 16 byte aligned
 	assert( ( ( ( int )ptr ) & 15 ) == 0 );
+	Mem_LockAllocator( mem_heapLock );
 	mem_heap->Free16( ptr );
+	Mem_UnlockAllocator( mem_heapLock );
 }
 
 /*
@@ -1793,6 +1875,8 @@ void* Mem_AllocDebugMemory( const int size, const char* fileName, const int line
 		return malloc( size );
 	}
 
+	Mem_LockAllocator( mem_heapLock );
+
 	if( align16 )
 	{
 		p = mem_heap->Allocate16( size + sizeof( debugMemory_t ) );
@@ -1818,6 +1902,8 @@ void* Mem_AllocDebugMemory( const int size, const char* fileName, const int line
 	mem_debugMemory = m;
 	idLib::sys->GetCallStack( m->callStack, MAX_CALLSTACK_DEPTH );
 
+	Mem_UnlockAllocator( mem_heapLock );
+
 	return ( ( ( byte* ) p ) + sizeof( debugMemory_t ) );
 }
 
@@ -1845,6 +1931,8 @@ void Mem_FreeDebugMemory( void* p, const char* fileName, const int lineNumber, c
 		return;
 	}
 
+	Mem_LockAllocator( mem_heapLock );
+
 	m = ( debugMemory_t* )( ( ( byte* ) p ) - sizeof( debugMemory_t ) );
 
 	if( m->size < 0 )
@@ -1881,6 +1969,8 @@ void Mem_FreeDebugMemory( void* p, const char* fileName, const int lineNumber, c
 	{
 		mem_heap->Free( m );
 	}
+
+	Mem_UnlockAllocator( mem_heapLock );
 }
 
 /*
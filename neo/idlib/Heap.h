@@ -60,6 +60,10 @@ void		Mem_GetStats( memoryStats_t& stats );
 void		Mem_Dump_f( const class idCmdArgs& args );
 void		Mem_DumpCompressed_f( const class idCmdArgs& args );
 void		Mem_AllocDefragBlock();
+void		Mem_BeginThreadSafeAllocs();			// serialize heap access while job threads allocate
+void		Mem_EndThreadSafeAllocs();
+void		Mem_LockAllocator( volatile long& lock );	// no-op outside Mem_BeginThreadSafeAllocs
+void		Mem_UnlockAllocator( volatile long& lock );
 
 
 #ifndef ID_DEBUG_MEMORY
@@ -1183,6 +1183,7 @@ int idParser::Directive_include()
 	}
 	script->SetFlags( idParser::flags );
 	script->SetPunctuations( idParser::punctuations );
+	idParser::includedFiles.Append( script->GetFileName() );
 	idParser::PushScript( script );
 	return true;
 }
@@ -3826,6 +3827,7 @@ void idParser::FreeSource( bool keepDefines )
 		scriptstack = scriptstack->next;
 		delete script;
 	}
+	includedFiles.Clear();
 	// free all the tokens
 	while( tokens )
 	{
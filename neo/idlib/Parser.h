@@ -170,6 +170,11 @@ public:
 	const ID_TIME_T	GetFileTime() const;
 	// returns the current line number
 	const int		GetLineNum() const;
+	// returns the files opened by #include since the source was loaded
+	const idList<idStr>& GetIncludedFiles() const
+	{
+		return includedFiles;
+	}
 	// print an error message
 	void			Error( const char* str, ... ) const id_attribute( ( format( printf, 2, 3 ) ) );
 	// print a warning message
@@ -198,6 +203,7 @@ private:
 	indent_t* 		indentstack;				// stack with indents
 	int				skip;						// > 0 if skipping conditional code
 	const char*		marker_p;
+	idList<idStr>	includedFiles;				// every file opened by #include, even if it has no tokens
 
 	static define_t* globaldefines;				// list with global defines added to every source loaded
 
@@ -35,6 +35,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #ifdef USE_STRING_DATA_ALLOCATOR
 	static idDynamicBlockAlloc < char, 1 << 18, 128 >	stringDataAllocator;
+	static volatile long								stringDataLock = 0;
 #endif
 
 idVec4	g_color_table[16] =
@@ -99,7 +100,9 @@ void idStr::ReAllocate( int amount, bool keepold )
 	alloced = newsize;
 
 #ifdef USE_STRING_DATA_ALLOCATOR
+	Mem_LockAllocator( stringDataLock );
 	newbuffer = stringDataAllocator.Alloc( alloced );
+	Mem_UnlockAllocator( stringDataLock );
 #else
 	newbuffer = new char[ alloced ];
 #endif
@@ -112,7 +115,9 @@ void idStr::ReAllocate( int amount, bool keepold )
 	if( data && data != baseBuffer )
 	{
 #ifdef USE_STRING_DATA_ALLOCATOR
+		Mem_LockAllocator( stringDataLock );
 		stringDataAllocator.Free( data );
+		Mem_UnlockAllocator( stringDataLock );
 #else
 		delete [] data;
 #endif
@@ -131,7 +136,9 @@ void idStr::FreeData()
 	if( data && data != baseBuffer )
 	{
 #ifdef USE_STRING_DATA_ALLOCATOR
+		Mem_LockAllocator( stringDataLock );
 		stringDataAllocator.Free( data );
+		Mem_UnlockAllocator( stringDataLock );
 #else
 		delete[] data;
 #endif
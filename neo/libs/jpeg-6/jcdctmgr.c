@@ -58,7 +58,9 @@ start_pass_fdctmgr (j_compress_ptr cinfo)
   int ci, qtblno, i;
   jpeg_component_info *compptr;
   JQUANT_TBL * qtbl;
-  //DCTELEM * dtbl;
+#if defined(DCT_ISLOW_SUPPORTED) || defined(DCT_IFAST_SUPPORTED)
+  DCTELEM * dtbl;
+#endif
 
   for (ci = 0, compptr = cinfo->comp_info; ci < cinfo->num_components;
        ci++, compptr++) {
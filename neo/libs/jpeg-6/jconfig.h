@@ -16,7 +16,7 @@
 #undef INCOMPLETE_TYPES_BROKEN
 
 #define JDCT_DEFAULT  JDCT_FLOAT
-#define JDCT_FASTEST  JDCT_FLOAT
+#define JDCT_FASTEST  JDCT_IFAST
 
 #ifdef JPEG_INTERNALS
 
@@ -36,12 +36,33 @@ extern "C" {
 
 #include "tr_local.h"
 
+#ifdef ID_IMAGE_SSE2
+	#include <emmintrin.h>
+#endif
+
 #define CIN_system	1
 #define CIN_loop	2
 #define	CIN_hold	4
 #define CIN_silent	8
 #define CIN_shader	16
 
+// frames kept by a cinematic that decodes ahead, the one on display and the queued ones
+const int CIN_AHEAD_FRAMES		= 3;
+
+typedef struct
+{
+	byte* 					image;
+	long					frame;			// numQuads after decoding it
+	bool					end;			// the decoder hit the end of the file instead
+} cinAheadFrame_t;
+
+enum
+{
+	CIN_AHEAD_FRAME,
+	CIN_AHEAD_EMPTY,
+	CIN_AHEAD_END
+};
+
 class idCinematicLocal : public idCinematic
 {
 public:
@@ -54,6 +75,8 @@ public:
 	virtual void			Close();
 	virtual void			ResetTime( int time );
 
+	static unsigned int		DecodeAheadThread( void* parms );
+
 private:
 	unsigned int			mcomp[256];
 	byte** 					qStatus[2];
@@ -92,6 +115,25 @@ private:
 	bool					half;
 	bool					smootheddouble;
 	bool					inMemory;
+	bool					useSIMD;
+
+	// read buffer and codebooks, every cinematic has its own so they can decode on different threads
+	byte* 					file;
+	unsigned short* 		vq2;
+	unsigned short* 		vq4;
+	unsigned short* 		vq8;
+
+	// while decoding ahead the cinematic thread owns the decoder state whenever aheadBusy is set,
+	// the ring, aheadCount, aheadBusy and aheadEnd are shared under CRITICAL_SECTION_THREE
+	cinAheadFrame_t			aheadFrames[CIN_AHEAD_FRAMES];
+	byte* 					aheadImages;
+	int						aheadRead;				// frame on display
+	int						aheadWrite;				// next frame to decode into
+	int						aheadCount;				// decoded frames queued after aheadRead
+	bool					aheadActive;
+	bool					aheadBusy;
+	bool					aheadEnd;
+	bool					holdAtEnd;				// stop at the end of the file instead of rewinding a looping cinematic
 
 	void					RoQ_init();
 	void					blitVQQuad32fs( byte** status, unsigned char* data );
@@ -108,11 +150,21 @@ private:
 	unsigned int			yuv_to_rgb24( long y, long u, long v );
 
 	void					decodeCodeBook( byte* input, unsigned short roq_flags );
+#ifdef ID_IMAGE_SSE2
+	void					decodeCodeBookSIMD( byte* input, long two, long four );
+#endif
 	void					recurseQuad( long startX, long startY, long quadSize, long xOff, long yOff );
 	void					setupQuad( long xOff, long yOff );
 	void					readQuadInfo( byte* qData );
 	void					RoQPrepMcomp( long xoff, long yoff );
 	void					RoQReset();
+	void					RoQEndOfFile( int thisTime );
+
+	cinData_t				ImageForTimeAhead( int thisTime );
+	void					StartDecodeAhead();
+	void					StopDecodeAhead();
+	void					DecodeAheadFrame();
+	int						NextAheadFrame();
 };
 
 const int DEFAULT_CIN_WIDTH		= 512;
@@ -131,16 +183,16 @@ const int ROQ_PACKET			= 0x1030;
 const int ZA_SOUND_MONO			= 0x1020;
 const int ZA_SOUND_STEREO		= 0x1021;
 
-// temporary buffers used by all cinematics
+// tables used by all cinematics
 static long				ROQ_YY_tab[256];
 static long				ROQ_UB_tab[256];
 static long				ROQ_UG_tab[256];
 static long				ROQ_VG_tab[256];
 static long				ROQ_VR_tab[256];
-static byte* 			file = NULL;
-static unsigned short* 	vq2 = NULL;
-static unsigned short* 	vq4 = NULL;
-static unsigned short* 	vq8 = NULL;
+
+// cinematics the decode thread keeps ahead of, guarded by CRITICAL_SECTION_THREE
+static idList<idCinematicLocal*>	cinAheadList;
+static xthreadInfo				cinAheadThread;
 
 
 
@@ -172,10 +224,10 @@ void idCinematic::InitCinematic()
 		ROQ_YY_tab[i] = ( long )( ( i << 6 ) | ( i >> 2 ) );
 	}
 
-	file = ( byte* )Mem_Alloc( 65536 );
-	vq2 = ( word* )Mem_Alloc( 256 * 16 * 4 * sizeof( word ) );
-	vq4 = ( word* )Mem_Alloc( 256 * 64 * 4 * sizeof( word ) );
-	vq8 = ( word* )Mem_Alloc( 256 * 256 * 4 * sizeof( word ) );
+	if( !cinAheadThread.threadHandle )
+	{
+		Sys_CreateThread( ( xthread_t )idCinematicLocal::DecodeAheadThread, NULL, THREAD_NORMAL, cinAheadThread, "cinematic", g_threads, &g_thread_count );
+	}
 }
 
 /*
@@ -185,14 +237,8 @@ idCinematicLocal::ShutdownCinematic
 */
 void idCinematic::ShutdownCinematic()
 {
-	Mem_Free( file );
-	file = NULL;
-	Mem_Free( vq2 );
-	vq2 = NULL;
-	Mem_Free( vq4 );
-	vq4 = NULL;
-	Mem_Free( vq8 );
-	vq8 = NULL;
+	// the decode thread is left waiting like the background download thread,
+	// it has nothing to do once every cinematic is closed
 }
 
 /*
@@ -278,6 +324,18 @@ idCinematicLocal::idCinematicLocal()
 	status = FMV_EOF;
 	buf = NULL;
 	iFile = NULL;
+	useSIMD = false;
+
+	file = NULL;
+	vq2 = NULL;
+	vq4 = NULL;
+	vq8 = NULL;
+
+	aheadImages = NULL;
+	aheadActive = false;
+	aheadBusy = false;
+	aheadEnd = false;
+	holdAtEnd = false;
 
 	qStatus[0] = ( byte** )Mem_Alloc( 32768 * sizeof( byte* ) );
 	qStatus[1] = ( byte** )Mem_Alloc( 32768 * sizeof( byte* ) );
@@ -296,6 +354,15 @@ idCinematicLocal::~idCinematicLocal()
 	qStatus[0] = NULL;
 	Mem_Free( qStatus[1] );
 	qStatus[1] = NULL;
+
+	Mem_Free16( file );
+	file = NULL;
+	Mem_Free16( vq2 );
+	vq2 = NULL;
+	Mem_Free16( vq4 );
+	vq4 = NULL;
+	Mem_Free16( vq8 );
+	vq8 = NULL;
 }
 
 /*
@@ -330,6 +397,15 @@ bool idCinematicLocal::InitFromFile( const char* qpath, bool amilooping )
 
 	ROQSize = iFile->Length();
 
+	if( !file )
+	{
+		// a chunk is at most 65536 bytes plus the header of the next one
+		file = ( byte* )Mem_Alloc16( 65536 + 16 );
+		vq2 = ( word* )Mem_Alloc16( 256 * 16 * 4 * sizeof( word ) );
+		vq4 = ( word* )Mem_Alloc16( 256 * 64 * 4 * sizeof( word ) );
+		vq8 = ( word* )Mem_Alloc16( 256 * 256 * 4 * sizeof( word ) );
+	}
+
 	looping = amilooping;
 
 	CIN_HEIGHT = DEFAULT_CIN_HEIGHT;
@@ -368,6 +444,12 @@ idCinematicLocal::Close
 */
 void idCinematicLocal::Close()
 {
+	StopDecodeAhead();
+	if( aheadImages )
+	{
+		Mem_Free16( aheadImages );
+		aheadImages = NULL;
+	}
 	if( image )
 	{
 		Mem_Free( ( void* )image );
@@ -395,6 +477,7 @@ idCinematicLocal::ResetTime
 */
 void idCinematicLocal::ResetTime( int time )
 {
+	StopDecodeAhead();
 	startTime = ( backEnd.viewDef ) ? 1000 * backEnd.viewDef->floatTime : -1;
 	status = FMV_PLAY;
 }
@@ -420,6 +503,15 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 		return cinData;
 	}
 
+#ifdef ID_IMAGE_SSE2
+	useSIMD = globalImages->image_useSIMD.GetBool();
+#endif
+
+	if( aheadActive )
+	{
+		return ImageForTimeAhead( thisTime );
+	}
+
 	if( status == FMV_EOF || status == FMV_IDLE )
 	{
 		return cinData;
@@ -475,35 +567,287 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 
 	if( status == FMV_EOF )
 	{
-		if( looping )
+		RoQEndOfFile( thisTime );
+	}
+
+	// once it is actually playing, let the cinematic thread decode the next frames
+	if( status == FMV_PLAY && buf != NULL && tfps > 0 && r_cinematicDecodeAhead.GetBool() )
+	{
+		StartDecodeAhead();
+	}
+
+	cinData.imageWidth = CIN_WIDTH;
+	cinData.imageHeight = CIN_HEIGHT;
+	cinData.status = status;
+	cinData.image = buf;
+
+	return cinData;
+}
+
+/*
+==============
+idCinematicLocal::ImageForTimeAhead
+
+Moves through the frames the cinematic thread decoded, decoding here only when
+the thread fell behind. Anything out of the ordinary, like going back in time or
+the end of the file, drops back to decoding on the calling thread.
+==============
+*/
+cinData_t idCinematicLocal::ImageForTimeAhead( int thisTime )
+{
+	cinData_t	cinData;
+	int			result;
+
+	memset( &cinData, 0, sizeof( cinData ) );
+
+	if( !r_cinematicDecodeAhead.GetBool() )
+	{
+		// let the queue run dry, ImageForTime takes over after that
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+		cinAheadList.Remove( this );
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+	}
+
+	tfps = ( ( thisTime - startTime ) * frameRate ) / 1000;
+
+	// the first frame is also shown for tfps 0, anything earlier went back in time
+	if( tfps < aheadFrames[aheadRead].frame - 1 )
+	{
+		StopDecodeAhead();
+		if( status == FMV_EOF )
 		{
-			RoQReset();
-			buf = NULL;
-			if( status == FMV_LOOPED )
-			{
-				status = FMV_PLAY;
-			}
-			while( buf == NULL && status == FMV_PLAY )
-			{
-				RoQInterrupt();
-			}
-			startTime = thisTime;
+			status = FMV_PLAY;
 		}
-		else
+		return ImageForTime( thisTime );
+	}
+
+	while( aheadFrames[aheadRead].frame < tfps )
+	{
+		result = NextAheadFrame();
+		if( result == CIN_AHEAD_EMPTY )
+		{
+			// the decoder is at the frame on display
+			StopDecodeAhead();
+			return ImageForTime( thisTime );
+		}
+		if( result == CIN_AHEAD_END )
 		{
-			status = FMV_IDLE;
-			RoQShutdown();
+			StopDecodeAhead();
+			RoQEndOfFile( thisTime );
+
+			cinData.imageWidth = CIN_WIDTH;
+			cinData.imageHeight = CIN_HEIGHT;
+			cinData.status = status;
+			cinData.image = buf;
+			return cinData;
 		}
 	}
 
 	cinData.imageWidth = CIN_WIDTH;
 	cinData.imageHeight = CIN_HEIGHT;
-	cinData.status = status;
-	cinData.image = buf;
+	cinData.status = FMV_PLAY;
+	cinData.image = aheadFrames[aheadRead].image;
 
 	return cinData;
 }
 
+/*
+==============
+idCinematicLocal::StartDecodeAhead
+==============
+*/
+void idCinematicLocal::StartDecodeAhead()
+{
+	int i;
+
+	if( !aheadImages )
+	{
+		aheadImages = ( byte* )Mem_Alloc16( CIN_AHEAD_FRAMES * screenDelta );
+	}
+	for( i = 0; i < CIN_AHEAD_FRAMES; i++ )
+	{
+		aheadFrames[i].image = aheadImages + i * screenDelta;
+		aheadFrames[i].frame = 0;
+		aheadFrames[i].end = false;
+	}
+
+	// the decoder is going to overwrite the frame on display
+	memcpy( aheadFrames[0].image, buf, screenDelta );
+	aheadFrames[0].frame = numQuads;
+
+	aheadRead = 0;
+	aheadWrite = 1;
+	aheadCount = 0;
+	aheadBusy = false;
+	aheadEnd = false;
+	holdAtEnd = true;
+	aheadActive = true;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	cinAheadList.Append( this );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+}
+
+/*
+==============
+idCinematicLocal::StopDecodeAhead
+
+Takes the decoder back from the cinematic thread, the decoder can be ahead of
+the frame on display afterwards.
+==============
+*/
+void idCinematicLocal::StopDecodeAhead()
+{
+	if( !aheadActive )
+	{
+		return;
+	}
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	cinAheadList.Remove( this );
+	while( aheadBusy )
+	{
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+		Sys_WaitForEvent( TRIGGER_EVENT_THREE );
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	aheadActive = false;
+	holdAtEnd = false;
+}
+
+/*
+==============
+idCinematicLocal::DecodeAheadFrame
+
+Decodes the next frame into the ring, the caller set aheadBusy. The file is only
+read here, each file has its own handle, rewinding a looping cinematic can
+allocate so it is left to the main thread by holdAtEnd.
+==============
+*/
+void idCinematicLocal::DecodeAheadFrame()
+{
+	cinAheadFrame_t* frame = &aheadFrames[aheadWrite];
+	long previous = numQuads;
+
+	while( status == FMV_PLAY && numQuads <= previous )
+	{
+		RoQInterrupt();
+	}
+
+	frame->frame = numQuads;
+	frame->end = ( status != FMV_PLAY );
+	if( !frame->end )
+	{
+		memcpy( frame->image, buf, screenDelta );
+	}
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	aheadWrite = ( aheadWrite + 1 ) % CIN_AHEAD_FRAMES;
+	aheadCount++;
+	aheadEnd = frame->end;
+	aheadBusy = false;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	Sys_TriggerEvent( TRIGGER_EVENT_THREE );
+}
+
+/*
+==============
+idCinematicLocal::NextAheadFrame
+
+Puts the next decoded frame on display, waiting for the cinematic thread or
+decoding it here when the thread hasn't got to this cinematic yet.
+==============
+*/
+int idCinematicLocal::NextAheadFrame()
+{
+	int next;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	while( aheadCount == 0 )
+	{
+		if( aheadBusy )
+		{
+			Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+			Sys_WaitForEvent( TRIGGER_EVENT_THREE );
+			Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+			continue;
+		}
+		if( !r_cinematicDecodeAhead.GetBool() )
+		{
+			Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+			return CIN_AHEAD_EMPTY;
+		}
+		aheadBusy = true;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+		DecodeAheadFrame();
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	}
+
+	next = ( aheadRead + 1 ) % CIN_AHEAD_FRAMES;
+	if( aheadFrames[next].end )
+	{
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+		return CIN_AHEAD_END;
+	}
+	aheadRead = next;
+	aheadCount--;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	// a slot opened up
+	Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+
+	return CIN_AHEAD_FRAME;
+}
+
+/*
+==============
+idCinematicLocal::DecodeAheadThread
+
+Keeps every cinematic that is decoding ahead CIN_AHEAD_FRAMES - 1 frames ahead
+of the one on display, taking them in turns.
+==============
+*/
+unsigned int idCinematicLocal::DecodeAheadThread( void* parms )
+{
+	idCinematicLocal* cin;
+	int i, num, next;
+
+	next = 0;
+	while( 1 )
+	{
+		cin = NULL;
+
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+		num = cinAheadList.Num();
+		for( i = 0; i < num; i++ )
+		{
+			idCinematicLocal* c = cinAheadList[( next + i ) % num];
+			if( !c->aheadBusy && !c->aheadEnd && c->aheadCount < CIN_AHEAD_FRAMES - 1 )
+			{
+				cin = c;
+				cin->aheadBusy = true;
+				next = ( next + i + 1 ) % num;
+				break;
+			}
+		}
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+		if( !cin )
+		{
+			Sys_WaitForEvent( TRIGGER_EVENT_TWO );
+			continue;
+		}
+
+		cin->DecodeAheadFrame();
+	}
+	return 0;
+}
+
 /*
 ==============
 idCinematicLocal::move8_32
@@ -511,6 +855,20 @@ idCinematicLocal::move8_32
 */
 void idCinematicLocal::move8_32( byte* src, byte* dst, int spl )
 {
+#ifdef ID_IMAGE_SSE2
+	if( useSIMD )
+	{
+		for( int i = 0; i < 8; i++ )
+		{
+			_mm_storeu_si128( ( __m128i* )dst + 0, _mm_loadu_si128( ( const __m128i* )src + 0 ) );
+			_mm_storeu_si128( ( __m128i* )dst + 1, _mm_loadu_si128( ( const __m128i* )src + 1 ) );
+			src += spl;
+			dst += spl;
+		}
+		return;
+	}
+#endif
+
 #if 1
 	int* dsrc, *ddst;
 	int dspl;
@@ -654,6 +1012,19 @@ idCinematicLocal::move4_32
 */
 void idCinematicLocal::move4_32( byte* src, byte* dst, int spl )
 {
+#ifdef ID_IMAGE_SSE2
+	if( useSIMD )
+	{
+		for( int i = 0; i < 4; i++ )
+		{
+			_mm_storeu_si128( ( __m128i* )dst, _mm_loadu_si128( ( const __m128i* )src ) );
+			src += spl;
+			dst += spl;
+		}
+		return;
+	}
+#endif
+
 #if 1
 	int* dsrc, *ddst;
 	int dspl;
@@ -713,6 +1084,20 @@ idCinematicLocal::blit8_32
 */
 void idCinematicLocal::blit8_32( byte* src, byte* dst, int spl )
 {
+#ifdef ID_IMAGE_SSE2
+	if( useSIMD )
+	{
+		for( int i = 0; i < 8; i++ )
+		{
+			_mm_storeu_si128( ( __m128i* )dst + 0, _mm_loadu_si128( ( const __m128i* )src + 0 ) );
+			_mm_storeu_si128( ( __m128i* )dst + 1, _mm_loadu_si128( ( const __m128i* )src + 1 ) );
+			src += 32;
+			dst += spl;
+		}
+		return;
+	}
+#endif
+
 #if 1
 	int* dsrc, *ddst;
 	int dspl;
@@ -856,6 +1241,19 @@ idCinematicLocal::blit4_32
 */
 void idCinematicLocal::blit4_32( byte* src, byte* dst, int spl )
 {
+#ifdef ID_IMAGE_SSE2
+	if( useSIMD )
+	{
+		for( int i = 0; i < 4; i++ )
+		{
+			_mm_storeu_si128( ( __m128i* )dst, _mm_loadu_si128( ( const __m128i* )src ) );
+			src += 16;
+			dst += spl;
+		}
+		return;
+	}
+#endif
+
 #if 1
 	int* dsrc, *ddst;
 	int dspl;
@@ -1215,6 +1613,13 @@ void idCinematicLocal::decodeCodeBook( byte* input, unsigned short roq_flags )
 			}
 			else if( samplesPerPixel == 4 )
 			{
+#ifdef ID_IMAGE_SSE2
+				if( useSIMD )
+				{
+					decodeCodeBookSIMD( input, two, four );
+					return;
+				}
+#endif
 				ibptr = ( unsigned int* )bptr;
 				for( i = 0; i < two; i++ )
 				{
@@ -1383,6 +1788,70 @@ void idCinematicLocal::decodeCodeBook( byte* input, unsigned short roq_flags )
 	}
 }
 
+#ifdef ID_IMAGE_SSE2
+/*
+==============
+idCinematicLocal::decodeCodeBookSIMD
+
+The normal height 32 bit codebooks of decodeCodeBook. The four luma samples of a
+2x2 cell share their chroma, so a cell converts at once with the same rounding
+and clamping as yuv_to_rgb24, the 4x4 and 8x8 codebooks are whole register moves.
+==============
+*/
+void idCinematicLocal::decodeCodeBookSIMD( byte* input, long two, long four )
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i* cell, *c, *d;
+	__m128i yy, r, g, b, rgb, rb, a, bb, a01, a23, b01, b23;
+	long i, cr, cb;
+
+	cell = ( __m128i* )vq2;
+	for( i = 0; i < two; i++ )
+	{
+		yy = _mm_setr_epi32( ROQ_YY_tab[input[0]], ROQ_YY_tab[input[1]], ROQ_YY_tab[input[2]], ROQ_YY_tab[input[3]] );
+		cr = input[4];
+		cb = input[5];
+		input += 6;
+
+		r = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( ROQ_VR_tab[cb] ) ), 6 );
+		g = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( ROQ_UG_tab[cr] + ROQ_VG_tab[cb] ) ), 6 );
+		b = _mm_srai_epi32( _mm_add_epi32( yy, _mm_set1_epi32( ROQ_UB_tab[cr] ) ), 6 );
+
+		// clamp to bytes as r0..r3 g0..g3 b0..b3, then interleave to r g b 0
+		rgb = _mm_packus_epi16( _mm_packs_epi32( r, g ), _mm_packs_epi32( b, zero ) );
+		rb = _mm_unpacklo_epi8( rgb, _mm_srli_si128( rgb, 8 ) );
+		_mm_store_si128( cell++, _mm_unpacklo_epi8( rb, _mm_srli_si128( rb, 8 ) ) );
+	}
+
+	c = ( __m128i* )vq4;
+	d = ( __m128i* )vq8;
+	for( i = 0; i < four; i++ )
+	{
+		a = _mm_load_si128( ( __m128i* )vq2 + input[0] );
+		bb = _mm_load_si128( ( __m128i* )vq2 + input[1] );
+		input += 2;
+
+		c[0] = _mm_unpacklo_epi64( a, bb );
+		c[1] = _mm_unpackhi_epi64( a, bb );
+		c += 2;
+
+		a01 = _mm_unpacklo_epi32( a, a );
+		b01 = _mm_unpacklo_epi32( bb, bb );
+		a23 = _mm_unpackhi_epi32( a, a );
+		b23 = _mm_unpackhi_epi32( bb, bb );
+		d[0] = a01;
+		d[1] = b01;
+		d[2] = a01;
+		d[3] = b01;
+		d[4] = a23;
+		d[5] = b23;
+		d[6] = a23;
+		d[7] = b23;
+		d += 8;
+	}
+}
+#endif
+
 /*
 ==============
 idCinematicLocal::recurseQuad
@@ -1538,193 +2007,34 @@ void idCinematicLocal::RoQReset()
 	status = FMV_LOOPED;
 }
 
-
-typedef struct
-{
-	struct jpeg_source_mgr pub;	/* public fields */
-
-	byte*   infile;		/* source stream */
-	JOCTET* buffer;		/* start of buffer */
-	boolean start_of_file;	/* have we gotten any data yet? */
-	int	memsize;
-} my_source_mgr;
-
-typedef my_source_mgr* my_src_ptr;
-
-#define INPUT_BUF_SIZE  32768	/* choose an efficiently fread'able size */
-
-/* jpeg error handling */
-struct jpeg_error_mgr jerr;
-
 /*
- * Fill the input buffer --- called whenever buffer is emptied.
- *
- * In typical applications, this should read fresh data into the buffer
- * (ignoring the current state of next_input_byte & bytes_in_buffer),
- * reset the pointer & count to the start of the buffer, and return TRUE
- * indicating that the buffer has been reloaded.  It is not necessary to
- * fill the buffer entirely, only to obtain at least one more byte.
- *
- * There is no such thing as an EOF return.  If the end of the file has been
- * reached, the routine has a choice of ERREXIT() or inserting fake data into
- * the buffer.  In most cases, generating a warning message and inserting a
- * fake EOI marker is the best course of action --- this will allow the
- * decompressor to output however much of the image is there.  However,
- * the resulting error message is misleading if the real problem is an empty
- * input file, so we handle that case specially.
- *
- * In applications that need to be able to suspend compression due to input
- * not being available yet, a FALSE return indicates that no more data can be
- * obtained right now, but more may be forthcoming later.  In this situation,
- * the decompressor will return to its caller (with an indication of the
- * number of scanlines it has read, if any).  The application should resume
- * decompression after it has loaded more data into the input buffer.  Note
- * that there are substantial restrictions on the use of suspension --- see
- * the documentation.
- *
- * When suspending, the decompressor will back up to a convenient restart point
- * (typically the start of the current MCU). next_input_byte & bytes_in_buffer
- * indicate where the restart point will be if the current call returns FALSE.
- * Data beyond this point must be rescanned after resumption, so move it to
- * the front of the buffer rather than discarding it.
- */
-
-
-METHODDEF boolean fill_input_buffer( j_decompress_ptr cinfo )
+==============
+idCinematicLocal::RoQEndOfFile
+==============
+*/
+void idCinematicLocal::RoQEndOfFile( int thisTime )
 {
-	my_src_ptr src = ( my_src_ptr ) cinfo->src;
-	int nbytes;
-
-	nbytes = INPUT_BUF_SIZE;
-	if( nbytes > src->memsize )
-	{
-		nbytes = src->memsize;
-	}
-	if( nbytes == 0 )
+	if( looping )
 	{
-		/* Insert a fake EOI marker */
-		src->buffer[0] = ( JOCTET ) 0xFF;
-		src->buffer[1] = ( JOCTET ) JPEG_EOI;
-		nbytes = 2;
+		RoQReset();
+		buf = NULL;
+		if( status == FMV_LOOPED )
+		{
+			status = FMV_PLAY;
+		}
+		while( buf == NULL && status == FMV_PLAY )
+		{
+			RoQInterrupt();
+		}
+		startTime = thisTime;
 	}
 	else
 	{
-		memcpy( src->buffer, src->infile, INPUT_BUF_SIZE );
-		src->infile = src->infile + nbytes;
-		src->memsize = src->memsize - INPUT_BUF_SIZE;
+		status = FMV_IDLE;
+		RoQShutdown();
 	}
-	src->pub.next_input_byte = src->buffer;
-	src->pub.bytes_in_buffer = nbytes;
-	src->start_of_file = FALSE;
-
-	return TRUE;
 }
-/*
- * Initialize source --- called by jpeg_read_header
- * before any data is actually read.
- */
-
 
-METHODDEF void init_source( j_decompress_ptr cinfo )
-{
-	my_src_ptr src = ( my_src_ptr ) cinfo->src;
-
-	/* We reset the empty-input-file flag for each image,
-	 * but we don't clear the input buffer.
-	 * This is correct behavior for reading a series of images from one source.
-	 */
-	src->start_of_file = TRUE;
-}
-
-/*
- * Skip data --- used to skip over a potentially large amount of
- * uninteresting data (such as an APPn marker).
- *
- * Writers of suspendable-input applications must note that skip_input_data
- * is not granted the right to give a suspension return.  If the skip extends
- * beyond the data currently in the buffer, the buffer can be marked empty so
- * that the next read will cause a fill_input_buffer call that can suspend.
- * Arranging for additional bytes to be discarded before reloading the input
- * buffer is the application writer's problem.
- */
-
-METHODDEF void
-skip_input_data( j_decompress_ptr cinfo, long num_bytes )
-{
-	my_src_ptr src = ( my_src_ptr ) cinfo->src;
-
-	/* Just a dumb implementation for now.  Could use fseek() except
-	 * it doesn't work on pipes.  Not clear that being smart is worth
-	 * any trouble anyway --- large skips are infrequent.
-	 */
-	if( num_bytes > 0 )
-	{
-		src->infile = src->infile + num_bytes;
-		src->pub.next_input_byte += ( size_t ) num_bytes;
-		src->pub.bytes_in_buffer -= ( size_t ) num_bytes;
-	}
-}
-
-
-/*
- * An additional method that can be provided by data source modules is the
- * resync_to_restart method for error recovery in the presence of RST markers.
- * For the moment, this source module just uses the default resync method
- * provided by the JPEG library.  That method assumes that no backtracking
- * is possible.
- */
-
-
-/*
- * Terminate source --- called by jpeg_finish_decompress
- * after all data has been read.  Often a no-op.
- *
- * NB: *not* called by jpeg_abort or jpeg_destroy; surrounding
- * application must deal with any cleanup that should happen even
- * for error exit.
- */
-
-METHODDEF void
-term_source( j_decompress_ptr cinfo )
-{
-	cinfo = cinfo;
-	/* no work necessary here */
-}
-
-GLOBAL void
-jpeg_memory_src( j_decompress_ptr cinfo, byte* infile, int size )
-{
-	my_src_ptr src;
-
-	/* The source object and input buffer are made permanent so that a series
-	 * of JPEG images can be read from the same file by calling jpeg_stdio_src
-	 * only before the first one.  (If we discarded the buffer at the end of
-	 * one image, we'd likely lose the start of the next one.)
-	 * This makes it unsafe to use this manager and a different source
-	 * manager serially with the same JPEG object.  Caveat programmer.
-	 */
-	if( cinfo->src == NULL )  	/* first time for this JPEG object? */
-	{
-		cinfo->src = ( struct jpeg_source_mgr* )
-					 ( *cinfo->mem->alloc_small )( ( j_common_ptr ) cinfo, JPOOL_PERMANENT,
-							 sizeof( my_source_mgr ) );
-		src = ( my_src_ptr ) cinfo->src;
-		src->buffer = ( JOCTET* )
-					  ( *cinfo->mem->alloc_small )( ( j_common_ptr ) cinfo, JPOOL_PERMANENT,
-							  INPUT_BUF_SIZE * sizeof( JOCTET ) );
-	}
-
-	src = ( my_src_ptr ) cinfo->src;
-	src->pub.init_source = init_source;
-	src->pub.fill_input_buffer = fill_input_buffer;
-	src->pub.skip_input_data = skip_input_data;
-	src->pub.resync_to_restart = jpeg_resync_to_restart; /* use default method */
-	src->pub.term_source = term_source;
-	src->infile = infile;
-	src->memsize = size;
-	src->pub.bytes_in_buffer = 0; /* forces fill_input_buffer on first read */
-	src->pub.next_input_byte = NULL; /* until buffer loaded */
-}
 
 int JPEGBlit( byte* wStatus, byte* data, int datasize )
 {
@@ -1736,8 +2046,9 @@ int JPEGBlit( byte* wStatus, byte* data, int datasize )
 	 * Note that this struct must live as long as the main JPEG parameter
 	 * struct, to avoid dangling-pointer problems.
 	 */
+	struct jpeg_error_mgr jerr;
 	/* More stuff */
-	JSAMPARRAY buffer;		/* Output row buffer */
+	JSAMPROW row;		/* Output row */
 	int row_stride;		/* physical row width in output buffer */
 
 	/* Step 1: allocate and initialize JPEG decompression object */
@@ -1750,7 +2061,7 @@ int JPEGBlit( byte* wStatus, byte* data, int datasize )
 
 	/* Step 2: specify data source (eg, a file) */
 
-	jpeg_memory_src( &cinfo, data, datasize );
+	R_JPEGMemorySource( &cinfo, data, datasize );
 
 	/* Step 3: read file parameters with jpeg_read_header() */
 
@@ -1789,10 +2100,6 @@ int JPEGBlit( byte* wStatus, byte* data, int datasize )
 	/* JSAMPLEs per row in output buffer */
 	row_stride = cinfo.output_width * cinfo.output_components;
 
-	/* Make a one-row-high sample array that will go away when done with image */
-	buffer = ( *cinfo.mem->alloc_sarray )
-			 ( ( j_common_ptr ) &cinfo, JPOOL_IMAGE, row_stride, 1 );
-
 	/* Step 6: while (scan lines remain to be read) */
 	/*           jpeg_read_scanlines(...); */
 
@@ -1800,30 +2107,12 @@ int JPEGBlit( byte* wStatus, byte* data, int datasize )
 	 * loop counter, so that we don't have to keep track ourselves.
 	 */
 
+	// the frame is stored bottom up, decode each scanline straight into its row
 	wStatus += ( cinfo.output_height - 1 ) * row_stride;
 	while( cinfo.output_scanline < cinfo.output_height )
 	{
-		/* jpeg_read_scanlines expects an array of pointers to scanlines.
-		 * Here the array is only one element long, but you could ask for
-		 * more than one scanline at a time if that's more convenient.
-		 */
-		jpeg_read_scanlines( &cinfo, &buffer[0], 1 );
-
-		/* Assume put_scanline_someplace wants a pointer and sample count. */
-		memcpy( wStatus, &buffer[0][0], row_stride );
-		/*
-		int x;
-		unsigned int *buf = (unsigned int *)&buffer[0][0];
-		unsigned int *out = (unsigned int *)wStatus;
-		for(x=0;x<cinfo.output_width;x++) {
-			unsigned int pixel = buf[x];
-			byte *roof = (byte *)&pixel;
-			byte temp = roof[0];
-			roof[0] = roof[2];
-			roof[2] = temp;
-			out[x] = pixel;
-		}
-		*/
+		row = wStatus;
+		jpeg_read_scanlines( &cinfo, &row, 1 );
 		wStatus -= row_stride;
 	}
 
@@ -1859,7 +2148,7 @@ void idCinematicLocal::RoQInterrupt()
 	iFile->Read( file, RoQFrameSize + 8 );
 	if( RoQPlayed >= ROQSize )
 	{
-		if( looping )
+		if( looping && !holdAtEnd )
 		{
 			RoQReset();
 		}
@@ -1942,7 +2231,7 @@ redump:
 //
 	if( RoQPlayed >= ROQSize )
 	{
-		if( looping )
+		if( looping && !holdAtEnd )
 		{
 			RoQReset();
 		}
@@ -1964,7 +2253,7 @@ redump:
 	{
 		common->DPrintf( "roq_size>65536||roq_id==0x1084\n" );
 		status = FMV_EOF;
-		if( looping )
+		if( looping && !holdAtEnd )
 		{
 			RoQReset();
 		}
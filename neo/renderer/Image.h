@@ -147,6 +147,32 @@ typedef enum
 } cubeFiles_t;
 
 #define	MAX_IMAGE_NAME	256
+#define	MAX_IMAGE_LEVELS	16
+
+// formats and quality levels of the CPU block compression
+typedef enum
+{
+	BC_FORMAT_BC1,			// DXT1, opaque color
+	BC_FORMAT_BC3,			// DXT5, color and interpolated alpha, also used for RXGB normal maps
+	BC_FORMAT_BC5			// red and green as two interpolated channels
+} blockFormat_t;
+
+typedef enum
+{
+	BC_QUALITY_FAST,
+	BC_QUALITY_NORMAL,
+	BC_QUALITY_HIGH
+} blockQuality_t;
+
+// the resampled first level and complete mip chain of a 2D image, built without
+// touching OpenGL so level load can do it on job threads before the upload
+typedef struct
+{
+	int					numLevels;
+	int					width[MAX_IMAGE_LEVELS];
+	int					height[MAX_IMAGE_LEVELS];
+	byte*				data[MAX_IMAGE_LEVELS];
+} imageLevels_t;
 
 class idImage
 {
@@ -209,9 +235,17 @@ public:
 	void		SetImageFilterAndRepeat() const;
 	bool		ShouldImageBePartialCached();
 	void		WritePrecompressedImage();
+	bool		WriteBlockCompressedImage( const char* format, blockQuality_t quality ) const;
 	bool		CheckPrecompressedImage( bool fullLoad );
 	void		UploadPrecompressedImage( byte* data, int len );
 	void		ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd );
+	bool		LoadImageLevels( imageLevels_t& levels );
+	void		BuildImageLevels( const byte* pic, int width, int height, imageLevels_t& levels );
+	void		UploadImageLevels( imageLevels_t& levels );
+	bool		ProcessedImageKey( idStr& key, ID_TIME_T* sourceTimestamp ) const;
+	void		ProcessedImageFileName( const idStr& key, char* fileName ) const;
+	bool		LoadProcessedImage( const idStr& key, imageLevels_t& levels );
+	void		WriteProcessedImage( const idStr& key, const imageLevels_t& levels ) const;
 	void		StartBackgroundImageLoad();
 	int			BitsForInternalFormat( int internalFormat ) const;
 	void		UploadCompressedNormalMap( int width, int height, const byte* rgba, int mipLevel );
@@ -385,7 +419,13 @@ public:
 	static idCVar		image_writeTGA;				// debug tool to write out .tgas of the non normal maps
 	static idCVar		image_useNormalCompression;	// 1 = use 256 color compression for normal maps if available, 2 = use rxgb compression
 	static idCVar		image_useOffLineCompression; // will write a batch file with commands for the offline compression
+	static idCVar		image_useCPUCompression;	// write precompressed dxt images with the CPU block compressor
+	static idCVar		image_cpuCompressionQuality;	// 0 = fast, 1 = normal, 2 = high
 	static idCVar		image_preload;				// if 0, dynamically load all images
+	static idCVar		image_parallelLoad;			// decode and mip map images on the job threads at level load
+	static idCVar		image_useSIMD;				// use the SSE2 image processing kernels if compiled in
+	static idCVar		image_useProcessedCache;	// load and save processed mip chains in imagecache/
+	static idCVar		image_fastJPEG;				// integer IDCT and merged upsampling for .jpg files
 	static idCVar		image_cacheMinK;			// maximum K of precompressed files to read at specification time,
 	// the remainder will be dynamically cached
 	static idCVar		image_cacheMegs;			// maximum bytes set aside for temporary loading of full-sized precompressed images
@@ -425,6 +465,7 @@ public:
 	//--------------------------------------------------------
 
 	idImage* 			AllocImage( const char* name );
+	void				LoadLevelImages( idList<idImage*>& loadList );
 	void				SetNormalPalette();
 	void				ChangeTextureFilter();
 
@@ -466,6 +507,12 @@ FIXME: make an "imageBlock" type to hold byte*,width,height?
 ====================================================================
 */
 
+// the image processing kernels and image program operators have SSE2 versions
+// when the compiler targets it, image_useSIMD 0 forces the generic loops
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+	#define ID_IMAGE_SSE2
+#endif
+
 byte* R_Dropsample( const byte* in, int inwidth, int inheight,
 					int outwidth, int outheight );
 byte* R_ResampleTexture( const byte* in, int inwidth, int inheight,
@@ -482,6 +529,10 @@ void R_HorizontalFlip( byte* data, int width, int height );
 void R_VerticalFlip( byte* data, int width, int height );
 void R_RotatePic( byte* data, int width );
 
+// CPU block compression for writing .dds files without the driver
+int R_BlockCompressedSize( int width, int height, blockFormat_t format );
+void R_BlockCompress( const byte* rgba, int width, int height, byte* out, blockFormat_t format, blockQuality_t quality );
+
 /*
 ====================================================================
 
@@ -493,6 +544,30 @@ IMAGEFILES
 void R_LoadImage( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp, bool makePowerOf2 );
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char* cname, cubeFiles_t extensions, byte* pic[6], int* size, ID_TIME_T* timestamp );
+// checksums the file R_LoadImage would read for name, returns false if there isn't one
+bool R_ImageFileChecksum( const char* name, unsigned int* checksum, ID_TIME_T* timestamp );
+// a libjpeg source for a file that is already in memory, safe to use on any thread
+void R_JPEGMemorySource( struct jpeg_decompress_struct* cinfo, const byte* data, int size );
+// file access that is safe to use from the image loading job threads
+int R_ReadImageFile( const char* name, void** buffer, ID_TIME_T* timestamp );
+void R_FreeImageFile( void* buffer );
+void R_WriteImageFile( const char* name, const void* buffer, int length );
+
+// errors and warnings of an image decoded on a job thread, the console isn't thread
+// safe and an error would take down the whole load, so they are printed afterwards
+typedef struct
+{
+	bool				failed;
+	char				error[MAX_STRING_CHARS];
+	char				warning[MAX_STRING_CHARS];	// the first one
+} imageLoadStatus_t;
+
+// while a status is set the calling thread reports to it instead of the console
+void R_SetImageLoadStatus( imageLoadStatus_t* status );
+bool R_ImageLoadStatusActive();
+// common->Error without a status, returns after failing the image with one
+void R_ImageLoadError( const char* fmt, ... ) id_attribute( ( format( printf, 1, 2 ) ) );
+void R_ImageLoadWarning( const char* fmt, ... ) id_attribute( ( format( printf, 1, 2 ) ) );
 
 /*
 ====================================================================
@@ -504,4 +579,7 @@ IMAGEPROGRAM
 
 void R_LoadImageProgram( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp, textureDepth_t* depth = NULL );
 const char* R_ParsePastImageProgram( idLexer& src );
+void R_ImageProgramSources( const char* name, idStrList& sources );
+void R_TestImageProcess_f( const idCmdArgs& args );
+void R_CompressImages_f( const idCmdArgs& args );
 
@@ -31,6 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+#include <setjmp.h>
+
 /*
 
 This file only has a single entry point:
@@ -173,6 +175,126 @@ static void LoadBMP( const char* name, byte** pic, int* width, int* height, ID_T
 static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp );
 static void LoadJPG( const char* name, byte** pic, int* width, int* height, ID_TIME_T* timestamp );
 
+static ID_THREAD_LOCAL imageLoadStatus_t* imageLoadStatus;
+
+/*
+================
+R_SetImageLoadStatus
+================
+*/
+void R_SetImageLoadStatus( imageLoadStatus_t* status )
+{
+	if( status )
+	{
+		status->failed = false;
+		status->error[0] = '\0';
+		status->warning[0] = '\0';
+	}
+	imageLoadStatus = status;
+}
+
+/*
+================
+R_ImageLoadStatusActive
+================
+*/
+bool R_ImageLoadStatusActive()
+{
+	return ( imageLoadStatus != NULL );
+}
+
+/*
+================
+R_ImageLoadError
+================
+*/
+void R_ImageLoadError( const char* fmt, ... )
+{
+	va_list		argptr;
+	char		msg[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( msg, sizeof( msg ), fmt, argptr );
+	va_end( argptr );
+
+	if( !imageLoadStatus )
+	{
+		common->Error( "%s", msg );
+	}
+
+	if( !imageLoadStatus->failed )
+	{
+		imageLoadStatus->failed = true;
+		idStr::Copynz( imageLoadStatus->error, msg, sizeof( imageLoadStatus->error ) );
+	}
+}
+
+/*
+================
+R_ImageLoadWarning
+================
+*/
+void R_ImageLoadWarning( const char* fmt, ... )
+{
+	va_list		argptr;
+	char		msg[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( msg, sizeof( msg ), fmt, argptr );
+	va_end( argptr );
+
+	if( !imageLoadStatus )
+	{
+		common->Warning( "%s", msg );
+		return;
+	}
+
+	if( !imageLoadStatus->warning[0] )
+	{
+		idStr::Copynz( imageLoadStatus->warning, msg, sizeof( imageLoadStatus->warning ) );
+	}
+}
+
+/*
+================
+R_ReadImageFile
+
+Images are decoded on job threads during a parallel level load, the
+file system isn't thread safe so all image file access goes through here.
+================
+*/
+int R_ReadImageFile( const char* name, void** buffer, ID_TIME_T* timestamp )
+{
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	int length = fileSystem->ReadFile( name, buffer, timestamp );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+	return length;
+}
+
+/*
+================
+R_FreeImageFile
+================
+*/
+void R_FreeImageFile( void* buffer )
+{
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	fileSystem->FreeFile( buffer );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
+/*
+================
+R_WriteImageFile
+================
+*/
+void R_WriteImageFile( const char* name, const void* buffer, int length )
+{
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	fileSystem->WriteFile( name, buffer, length );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
 
 /*
 ========================================================================
@@ -264,7 +386,7 @@ static void LoadBMP( const char* name, byte** pic, int* width, int* height, ID_T
 
 	if( !pic )
 	{
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -273,7 +395,7 @@ static void LoadBMP( const char* name, byte** pic, int* width, int* height, ID_T
 	//
 	// load the file
 	//
-	length = fileSystem->ReadFile( name, ( void** )&buffer, timestamp );
+	length = R_ReadImageFile( name, ( void** )&buffer, timestamp );
 	if( !buffer )
 	{
 		return;
@@ -321,19 +443,33 @@ static void LoadBMP( const char* name, byte** pic, int* width, int* height, ID_T
 
 	if( bmpHeader.id[0] != 'B' && bmpHeader.id[1] != 'M' )
 	{
-		common->Error( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 	if( bmpHeader.fileSize != length )
 	{
-		common->Error( "LoadBMP: header size does not match file size (%lu vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
+		R_ImageLoadError( "LoadBMP: header size does not match file size (%lu vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 	if( bmpHeader.compression != 0 )
 	{
-		common->Error( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 	if( bmpHeader.bitsPerPixel < 8 )
 	{
-		common->Error( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
+		R_FreeImageFile( buffer );
+		return;
+	}
+	if( bmpHeader.bitsPerPixel != 8 && bmpHeader.bitsPerPixel != 16 && bmpHeader.bitsPerPixel != 24 && bmpHeader.bitsPerPixel != 32 )
+	{
+		R_ImageLoadError( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 
 	columns = bmpHeader.width;
@@ -411,7 +547,7 @@ static void LoadBMP( const char* name, byte** pic, int* width, int* height, ID_T
 		}
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 
 }
 
@@ -443,7 +579,7 @@ static void LoadPCX( const char* filename, byte** pic, byte** palette, int* widt
 
 	if( !pic )
 	{
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -453,7 +589,7 @@ static void LoadPCX( const char* filename, byte** pic, byte** palette, int* widt
 	//
 	// load the file
 	//
-	len = fileSystem->ReadFile( filename, ( void** )&raw, timestamp );
+	len = R_ReadImageFile( filename, ( void** )&raw, timestamp );
 	if( !raw )
 	{
 		return;
@@ -475,7 +611,8 @@ static void LoadPCX( const char* filename, byte** pic, byte** palette, int* widt
 			|| xmax >= 1024
 			|| ymax >= 1024 )
 	{
-		common->Printf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax + 1, ymax + 1, pcx->xmax, pcx->ymax );
+		R_ImageLoadWarning( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax + 1, ymax + 1, pcx->xmax, pcx->ymax );
+		R_FreeImageFile( pcx );
 		return;
 	}
 
@@ -527,12 +664,12 @@ static void LoadPCX( const char* filename, byte** pic, byte** palette, int* widt
 
 	if( raw - ( byte* )pcx > len )
 	{
-		common->Printf( "PCX file %s was malformed", filename );
+		R_ImageLoadWarning( "PCX file %s was malformed", filename );
 		R_StaticFree( *pic );
 		*pic = NULL;
 	}
 
-	fileSystem->FreeFile( pcx );
+	R_FreeImageFile( pcx );
 }
 
 
@@ -550,7 +687,7 @@ static void LoadPCX32( const char* filename, byte** pic, int* width, int* height
 
 	if( !pic )
 	{
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	LoadPCX( filename, &pic8, &palette, width, height, timestamp );
@@ -584,6 +721,64 @@ TARGA LOADING
 =========================================================
 */
 
+/*
+=============
+R_ExpandTGAPixels
+
+converts count 8 bit gray, 24 bit BGR or 32 bit BGRA pixels to RGBA
+=============
+*/
+static void R_ExpandTGAPixels( const byte* in, byte* out, int count, int bytesPerPixel )
+{
+	switch( bytesPerPixel )
+	{
+		case 1:
+			for( int i = 0; i < count; i++, in++, out += 4 )
+			{
+				out[0] = out[1] = out[2] = in[0];
+				out[3] = 255;
+			}
+			break;
+		case 3:
+			for( int i = 0; i < count; i++, in += 3, out += 4 )
+			{
+				out[0] = in[2];
+				out[1] = in[1];
+				out[2] = in[0];
+				out[3] = 255;
+			}
+			break;
+		case 4:
+			for( int i = 0; i < count; i++, in += 4, out += 4 )
+			{
+				out[0] = in[2];
+				out[1] = in[1];
+				out[2] = in[0];
+				out[3] = in[3];
+			}
+			break;
+	}
+}
+
+/*
+=============
+R_FillTGAPixels
+
+writes count copies of an RGBA pixel a whole word at a time
+=============
+*/
+static void R_FillTGAPixels( const byte rgba[4], byte* out, int count )
+{
+	int		pixel;
+	int*	out_p = ( int* )out;
+
+	memcpy( &pixel, rgba, 4 );
+	for( int i = 0; i < count; i++ )
+	{
+		out_p[i] = pixel;
+	}
+}
+
 /*
 =============
 LoadTGA
@@ -601,7 +796,7 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 
 	if( !pic )
 	{
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -610,7 +805,7 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 	//
 	// load the file
 	//
-	fileSize = fileSystem->ReadFile( name, ( void** )&buffer, timestamp );
+	fileSize = R_ReadImageFile( name, ( void** )&buffer, timestamp );
 	if( !buffer )
 	{
 		return;
@@ -640,17 +835,23 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 
 	if( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 )
 	{
-		common->Error( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 
 	if( targa_header.colormap_type != 0 )
 	{
-		common->Error( "LoadTGA( %s ): colormaps not supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): colormaps not supported\n", name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 
 	if( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 )
 	{
-		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		R_FreeImageFile( buffer );
+		return;
 	}
 
 	if( targa_header.image_type == 2 || targa_header.image_type == 3 )
@@ -658,7 +859,9 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
 		if( numBytes > fileSize - 18 - targa_header.id_length )
 		{
-			common->Error( "LoadTGA( %s ): incomplete file\n", name );
+			R_ImageLoadError( "LoadTGA( %s ): incomplete file\n", name );
+			R_FreeImageFile( buffer );
+			return;
 		}
 	}
 
@@ -683,170 +886,88 @@ static void LoadTGA( const char* name, byte** pic, int* width, int* height, ID_T
 		buf_p += targa_header.id_length;  // skip TARGA image comment
 	}
 
+	// rows are stored bottom up unless the flip bit is set, write each one
+	// straight to where it belongs instead of flipping the image afterwards
+	int		rowStep = columns * 4;
+	int		bytesPerPixel = targa_header.pixel_size >> 3;
+	byte*	rowStart = targa_rgba + ( rows - 1 ) * rowStep;
+
+	if( targa_header.attributes & ( 1 << 5 ) )
+	{
+		rowStart = targa_rgba;
+		rowStep = -rowStep;
+	}
+
 	if( targa_header.image_type == 2 || targa_header.image_type == 3 )
 	{
 		// Uncompressed RGB or gray scale image
-		for( row = rows - 1; row >= 0; row-- )
+		if( targa_header.pixel_size != 8 && targa_header.pixel_size != 24 && targa_header.pixel_size != 32 )
 		{
-			pixbuf = targa_rgba + row * columns * 4;
-			for( column = 0; column < columns; column++ )
-			{
-				unsigned char red, green, blue, alphabyte;
-				switch( targa_header.pixel_size )
-				{
-
-					case 8:
-						blue = *buf_p++;
-						green = blue;
-						red = blue;
-						*pixbuf++ = red;
-						*pixbuf++ = green;
-						*pixbuf++ = blue;
-						*pixbuf++ = 255;
-						break;
-
-					case 24:
-						blue = *buf_p++;
-						green = *buf_p++;
-						red = *buf_p++;
-						*pixbuf++ = red;
-						*pixbuf++ = green;
-						*pixbuf++ = blue;
-						*pixbuf++ = 255;
-						break;
-					case 32:
-						blue = *buf_p++;
-						green = *buf_p++;
-						red = *buf_p++;
-						alphabyte = *buf_p++;
-						*pixbuf++ = red;
-						*pixbuf++ = green;
-						*pixbuf++ = blue;
-						*pixbuf++ = alphabyte;
-						break;
-					default:
-						common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-						break;
-				}
-			}
+			R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+			R_StaticFree( targa_rgba );
+			*pic = NULL;
+			R_FreeImageFile( buffer );
+			return;
+		}
+		for( row = 0; row < rows; row++ )
+		{
+			R_ExpandTGAPixels( buf_p, rowStart - row * rowStep, columns, bytesPerPixel );
+			buf_p += columns * bytesPerPixel;
 		}
 	}
 	else if( targa_header.image_type == 10 )      // Runlength encoded RGB images
 	{
-		unsigned char red, green, blue, alphabyte, packetHeader, packetSize, j;
-
-		red = 0;
-		green = 0;
-		blue = 0;
-		alphabyte = 0xff;
+		const byte*	end = buffer + fileSize;
+		byte		rgba[4];
+		int			packetHeader, packetSize, count;
 
-		for( row = rows - 1; row >= 0; row-- )
+		// packets can span rows, so each one is split at the row ends
+		row = 0;
+		column = 0;
+		pixbuf = rowStart;
+		while( row < rows && buf_p < end )
 		{
-			pixbuf = targa_rgba + row * columns * 4;
-			for( column = 0; column < columns; )
+			packetHeader = *buf_p++;
+			packetSize = 1 + ( packetHeader & 0x7f );
+			if( buf_p + ( ( packetHeader & 0x80 ) ? 1 : packetSize ) * bytesPerPixel > end )
+			{
+				R_ImageLoadWarning( "LoadTGA( %s ): incomplete file", name );
+				break;
+			}
+
+			if( packetHeader & 0x80 )           // run-length packet
+			{
+				R_ExpandTGAPixels( buf_p, rgba, 1, bytesPerPixel );
+				buf_p += bytesPerPixel;
+			}
+
+			while( packetSize > 0 && row < rows )
 			{
-				packetHeader = *buf_p++;
-				packetSize = 1 + ( packetHeader & 0x7f );
-				if( packetHeader & 0x80 )           // run-length packet
+				count = Min( packetSize, columns - column );
+				if( packetHeader & 0x80 )
 				{
-					switch( targa_header.pixel_size )
-					{
-						case 24:
-							blue = *buf_p++;
-							green = *buf_p++;
-							red = *buf_p++;
-							alphabyte = 255;
-							break;
-						case 32:
-							blue = *buf_p++;
-							green = *buf_p++;
-							red = *buf_p++;
-							alphabyte = *buf_p++;
-							break;
-						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-							break;
-					}
-
-					for( j = 0; j < packetSize; j++ )
-					{
-						*pixbuf++ = red;
-						*pixbuf++ = green;
-						*pixbuf++ = blue;
-						*pixbuf++ = alphabyte;
-						column++;
-						if( column == columns )    // run spans across rows
-						{
-							column = 0;
-							if( row > 0 )
-							{
-								row--;
-							}
-							else
-							{
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row * columns * 4;
-						}
-					}
+					R_FillTGAPixels( rgba, pixbuf, count );
 				}
 				else                              // non run-length packet
 				{
-					for( j = 0; j < packetSize; j++ )
-					{
-						switch( targa_header.pixel_size )
-						{
-							case 24:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								*pixbuf++ = red;
-								*pixbuf++ = green;
-								*pixbuf++ = blue;
-								*pixbuf++ = 255;
-								break;
-							case 32:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								alphabyte = *buf_p++;
-								*pixbuf++ = red;
-								*pixbuf++ = green;
-								*pixbuf++ = blue;
-								*pixbuf++ = alphabyte;
-								break;
-							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-								break;
-						}
-						column++;
-						if( column == columns )    // pixel packet run spans across rows
-						{
-							column = 0;
-							if( row > 0 )
-							{
-								row--;
-							}
-							else
-							{
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row * columns * 4;
-						}
-					}
+					R_ExpandTGAPixels( buf_p, pixbuf, count, bytesPerPixel );
+					buf_p += count * bytesPerPixel;
+				}
+				pixbuf += count * 4;
+				column += count;
+				packetSize -= count;
+
+				if( column == columns )    // run spans across rows
+				{
+					column = 0;
+					row++;
+					pixbuf = rowStart - row * rowStep;
 				}
 			}
-breakOut:
-			;
 		}
 	}
 
-	if( ( targa_header.attributes & ( 1 << 5 ) ) )  			// image flp bit
-	{
-		R_VerticalFlip( *pic, *width, *height );
-	}
-
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 }
 
 /*
@@ -860,185 +981,204 @@ Interfaces with the huge libjpeg
 
 /*
 =============
-LoadJPG
+R_JPEGMemorySource
+
+A libjpeg data source that reads straight out of a buffer holding the whole
+file. Unlike the jdatasrc.c source it never copies or reads past the end of
+the data, and all of its state lives in cinfo, so any number of images can
+be decoded at once on different threads.
 =============
 */
-static void LoadJPG( const char* filename, unsigned char** pic, int* width, int* height, ID_TIME_T* timestamp )
+static const JOCTET jpegFakeEOI[2] = { ( JOCTET )0xFF, ( JOCTET )JPEG_EOI };
+
+static void R_JPEGInitSource( j_decompress_ptr cinfo )
 {
-	/* This struct contains the JPEG decompression parameters and pointers to
-	 * working space (which is allocated as needed by the JPEG library).
-	 */
-	struct jpeg_decompress_struct cinfo;
-	/* We use our private extension JPEG error handler.
-	 * Note that this struct must live as long as the main JPEG parameter
-	 * struct, to avoid dangling-pointer problems.
-	 */
-	/* This struct represents a JPEG error handler.  It is declared separately
-	 * because applications often want to supply a specialized error handler
-	 * (see the second half of this file for an example).  But here we just
-	 * take the easy way out and use the standard error handler, which will
-	 * print a message on stderr and call exit() if compression fails.
-	 * Note that this struct must live as long as the main JPEG parameter
-	 * struct, to avoid dangling-pointer problems.
-	 */
-	struct jpeg_error_mgr jerr;
-	/* More stuff */
-	JSAMPARRAY buffer;		/* Output row buffer */
-	int row_stride;		/* physical row width in output buffer */
-	unsigned char* out;
-	byte*	fbuffer;
-	byte*  bbuf;
-
-	/* In this example we want to open the input file before doing anything else,
-	 * so that the setjmp() error recovery below can assume the file is open.
-	 * VERY IMPORTANT: use "b" option to fopen() if you are on a machine that
-	 * requires it in order to read binary files.
-	 */
-
-	// JDC: because fill_input_buffer() blindly copies INPUT_BUF_SIZE bytes,
-	// we need to make sure the file buffer is padded or it may crash
-	if( pic )
+}
+
+static boolean R_JPEGFillInputBuffer( j_decompress_ptr cinfo )
+{
+	// the whole file was given up front, so this is only reached on a truncated
+	// file, insert a fake EOI marker so the decompressor outputs what it has
+	cinfo->src->next_input_byte = jpegFakeEOI;
+	cinfo->src->bytes_in_buffer = 2;
+	return TRUE;
+}
+
+static void R_JPEGSkipInputData( j_decompress_ptr cinfo, long num_bytes )
+{
+	if( num_bytes <= 0 )
 	{
-		*pic = NULL;		// until proven otherwise
+		return;
 	}
+	if( num_bytes > ( long )cinfo->src->bytes_in_buffer )
 	{
-		int		len;
-		idFile* f;
+		R_JPEGFillInputBuffer( cinfo );
+		return;
+	}
+	cinfo->src->next_input_byte += num_bytes;
+	cinfo->src->bytes_in_buffer -= num_bytes;
+}
 
-		f = fileSystem->OpenFileRead( filename );
-		if( !f )
-		{
-			return;
-		}
-		len = f->Length();
-		if( timestamp )
-		{
-			*timestamp = f->Timestamp();
-		}
-		if( !pic )
-		{
-			fileSystem->CloseFile( f );
-			return;	// just getting timestamp
-		}
-		fbuffer = ( byte* )Mem_ClearedAlloc( len + 4096 );
-		f->Read( fbuffer, len );
-		fileSystem->CloseFile( f );
+static void R_JPEGTermSource( j_decompress_ptr cinfo )
+{
+}
+
+void R_JPEGMemorySource( j_decompress_ptr cinfo, const byte* data, int size )
+{
+	if( cinfo->src == NULL )
+	{
+		cinfo->src = ( struct jpeg_source_mgr* )( *cinfo->mem->alloc_small )( ( j_common_ptr )cinfo, JPOOL_PERMANENT, sizeof( struct jpeg_source_mgr ) );
 	}
+	cinfo->src->init_source = R_JPEGInitSource;
+	cinfo->src->fill_input_buffer = R_JPEGFillInputBuffer;
+	cinfo->src->skip_input_data = R_JPEGSkipInputData;
+	cinfo->src->resync_to_restart = jpeg_resync_to_restart;
+	cinfo->src->term_source = R_JPEGTermSource;
+	cinfo->src->next_input_byte = data;
+	cinfo->src->bytes_in_buffer = size;
+}
+
+// when decoding on a job thread a corrupt jpeg fails just the image, the library
+// can't return from error_exit so it jumps back out to LoadJPG instead
+typedef struct
+{
+	struct jpeg_error_mgr	pub;
+	jmp_buf					setjmpBuffer;
+} jpegErrorMgr_t;
 
+static void R_JPEGErrorExit( j_common_ptr cinfo )
+{
+	char buffer[JMSG_LENGTH_MAX];
 
-	/* Step 1: allocate and initialize JPEG decompression object */
+	( *cinfo->err->format_message )( cinfo, buffer );
 
-	/* We have to set up the error handler first, in case the initialization
-	 * step fails.  (Unlikely, but it could happen if you are out of memory.)
-	 * This routine fills in the contents of struct jerr, and returns jerr's
-	 * address which we place into the link field in cinfo.
-	 */
-	cinfo.err = jpeg_std_error( &jerr );
+	if( !R_ImageLoadStatusActive() )
+	{
+		jpg_Error( "%s\n", buffer );
+	}
 
-	/* Now we can initialize the JPEG decompression object. */
-	jpeg_create_decompress( &cinfo );
+	R_ImageLoadError( "%s\n", buffer );
+	longjmp( ( ( jpegErrorMgr_t* )cinfo->err )->setjmpBuffer, 1 );
+}
+
+static void R_JPEGOutputMessage( j_common_ptr cinfo )
+{
+	char buffer[JMSG_LENGTH_MAX];
+
+	( *cinfo->err->format_message )( cinfo, buffer );
 
-	/* Step 2: specify data source (eg, a file) */
+	if( !R_ImageLoadStatusActive() )
+	{
+		jpg_Printf( "%s\n", buffer );
+		return;
+	}
+
+	R_ImageLoadWarning( "%s\n", buffer );
+}
+
+/*
+=============
+LoadJPG
+=============
+*/
+static void LoadJPG( const char* filename, unsigned char** pic, int* width, int* height, ID_TIME_T* timestamp )
+{
+	struct jpeg_decompress_struct cinfo;
+	jpegErrorMgr_t jerr;
+	JSAMPROW	rows[16];
+	byte*		fbuffer;
+	byte* volatile out;
+	int			len;
+
+	if( !pic )
+	{
+		R_ReadImageFile( filename, NULL, timestamp );
+		return;	// just getting timestamp
+	}
 
-	jpeg_stdio_src( &cinfo, fbuffer );
+	*pic = NULL;		// until proven otherwise
 
-	/* Step 3: read file parameters with jpeg_read_header() */
+	len = R_ReadImageFile( filename, ( void** )&fbuffer, timestamp );
+	if( !fbuffer )
+	{
+		return;
+	}
 
-	jpeg_read_header( &cinfo, true );
-	/* We can ignore the return value from jpeg_read_header since
-	 *   (a) suspension is not possible with the stdio data source, and
-	 *   (b) we passed TRUE to reject a tables-only JPEG file as an error.
-	 * See libjpeg.doc for more info.
-	 */
+	out = NULL;
+	cinfo.mem = NULL;
+	cinfo.err = jpeg_std_error( &jerr.pub );
+	jerr.pub.error_exit = R_JPEGErrorExit;
+	jerr.pub.output_message = R_JPEGOutputMessage;
+	if( setjmp( jerr.setjmpBuffer ) )
+	{
+		jpeg_destroy_decompress( &cinfo );
+		if( out )
+		{
+			R_StaticFree( out );
+		}
+		*pic = NULL;
+		R_FreeImageFile( fbuffer );
+		return;
+	}
+	jpeg_create_decompress( &cinfo );
 
-	/* Step 4: set parameters for decompression */
+	R_JPEGMemorySource( &cinfo, fbuffer, len );
 
-	/* In this example, we don't need to change any of the defaults set by
-	 * jpeg_read_header(), so we do nothing here.
-	 */
+	jpeg_read_header( &cinfo, TRUE );
 
-	/* Step 5: Start decompressor */
+	// the integer IDCT and merged upsampling are a good deal faster, but not
+	// bit exact with the float IDCT the images were always loaded with
+	if( globalImages->image_fastJPEG.GetBool() )
+	{
+		cinfo.dct_method = JDCT_IFAST;
+		cinfo.do_fancy_upsampling = FALSE;
+	}
 
 	jpeg_start_decompress( &cinfo );
-	/* We can ignore the return value since suspension is not possible
-	 * with the stdio data source.
-	 */
-
-	/* We may need to do some setup of our own at this point before reading
-	 * the data.  After jpeg_start_decompress() we have the correct scaled
-	 * output image dimensions available, as well as the output colormap
-	 * if we asked for color quantization.
-	 * In this example, we need to make an output work buffer of the right size.
-	 */
-	/* JSAMPLEs per row in output buffer */
-	row_stride = cinfo.output_width * cinfo.output_components;
 
 	if( cinfo.output_components != 4 )
 	{
-		common->DWarning( "JPG %s is unsupported color depth (%d)",
-						  filename, cinfo.output_components );
+		if( R_ImageLoadStatusActive() )
+		{
+			R_ImageLoadWarning( "JPG %s is unsupported color depth (%d)", filename, cinfo.output_components );
+		}
+		else
+		{
+			common->DWarning( "JPG %s is unsupported color depth (%d)",
+							  filename, cinfo.output_components );
+		}
 	}
+
+	int row_stride = cinfo.output_width * 4;
 	out = ( byte* )R_StaticAlloc( cinfo.output_width * cinfo.output_height * 4 );
 
 	*pic = out;
 	*width = cinfo.output_width;
 	*height = cinfo.output_height;
 
-	/* Step 6: while (scan lines remain to be read) */
-	/*           jpeg_read_scanlines(...); */
-
-	/* Here we use the library's state variable cinfo.output_scanline as the
-	 * loop counter, so that we don't have to keep track ourselves.
-	 */
+	// decode as many scanlines as the library will give us at once straight into
+	// the image, and set the alphas the color conversion skips while they are in cache
 	while( cinfo.output_scanline < cinfo.output_height )
 	{
-		/* jpeg_read_scanlines expects an array of pointers to scanlines.
-		 * Here the array is only one element long, but you could ask for
-		 * more than one scanline at a time if that's more convenient.
-		 */
-		bbuf = ( ( out + ( row_stride * cinfo.output_scanline ) ) );
-		buffer = &bbuf;
-		jpeg_read_scanlines( &cinfo, buffer, 1 );
-	}
-
-	// clear all the alphas to 255
-	{
-		int	i, j;
-		byte*	buf;
-
-		buf = *pic;
+		int first = cinfo.output_scanline;
+		int numRows = Min( ( int )( cinfo.output_height - first ), 16 );
+		for( int i = 0; i < numRows; i++ )
+		{
+			rows[i] = out + ( first + i ) * row_stride;
+		}
+		numRows = jpeg_read_scanlines( &cinfo, rows, numRows );
 
-		j = cinfo.output_width * cinfo.output_height * 4;
-		for( i = 3 ; i < j ; i += 4 )
+		byte* alpha = out + first * row_stride + 3;
+		for( int i = numRows * cinfo.output_width; i > 0; i--, alpha += 4 )
 		{
-			buf[i] = 255;
+			*alpha = 255;
 		}
 	}
 
-	/* Step 7: Finish decompression */
-
 	jpeg_finish_decompress( &cinfo );
-	/* We can ignore the return value since suspension is not possible
-	 * with the stdio data source.
-	 */
-
-	/* Step 8: Release JPEG decompression object */
-
-	/* This is an important step since it will release a good deal of memory. */
 	jpeg_destroy_decompress( &cinfo );
 
-	/* After finish_decompress, we can close the input file.
-	 * Here we postpone it until after no more JPEG errors are possible,
-	 * so as to simplify the setjmp error logic above.  (Actually, I don't
-	 * think that jpeg_destroy can do an error exit, but why assume anything...)
-	 */
-	Mem_Free( fbuffer );
-
-	/* At this point you may want to check to see whether any corrupt-data
-	 * warnings occurred (test whether jerr.pub.num_warnings is nonzero).
-	 */
-
-	/* And we're done! */
+	R_FreeImageFile( fbuffer );
 }
 
 //===================================================================
@@ -1169,6 +1309,54 @@ void R_LoadImage( const char* cname, byte** pic, int* width, int* height, ID_TIM
 }
 
 
+/*
+=================
+R_ImageFileChecksum
+
+Checksums the contents of the file R_LoadImage would load for name, following
+the same extension rules, so the processed image cache can tell when a source
+image has changed.
+=================
+*/
+bool R_ImageFileChecksum( const char* cname, unsigned int* checksum, ID_TIME_T* timestamp )
+{
+	idStr	name = cname;
+	void*	buffer;
+	int		length;
+
+	*checksum = 0;
+	*timestamp = FILE_NOT_FOUND_TIMESTAMP;
+
+	name.DefaultFileExtension( ".tga" );
+
+	if( name.Length() < 5 )
+	{
+		return false;
+	}
+
+	name.ToLower();
+	idStr ext;
+	name.ExtractFileExtension( ext );
+
+	length = R_ReadImageFile( name.c_str(), &buffer, timestamp );
+	if( !buffer && ext == "tga" )
+	{
+		name.StripFileExtension();
+		name.DefaultFileExtension( ".jpg" );
+		length = R_ReadImageFile( name.c_str(), &buffer, timestamp );
+	}
+	if( !buffer )
+	{
+		return false;
+	}
+
+	*checksum = MD4_BlockChecksum( buffer, length );
+	R_FreeImageFile( buffer );
+
+	return true;
+}
+
+
 /*
 =======================
 R_LoadCubeImages
@@ -50,6 +50,10 @@ idCVar idImageManager::image_forceDownSize( "image_forceDownSize", "0", CVAR_REN
 idCVar idImageManager::image_roundDown( "image_roundDown", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "round bad sizes down to nearest power of two" );
 idCVar idImageManager::image_colorMipLevels( "image_colorMipLevels", "0", CVAR_RENDERER | CVAR_BOOL, "development aid to see texture mip usage" );
 idCVar idImageManager::image_preload( "image_preload", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "if 0, dynamically load all images" );
+idCVar idImageManager::image_parallelLoad( "image_parallelLoad", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "decode images and build their mip levels on the job threads at level load" );
+idCVar idImageManager::image_useSIMD( "image_useSIMD", "1", CVAR_RENDERER | CVAR_BOOL, "use the SSE2 image processing and image program kernels when available" );
+idCVar idImageManager::image_useProcessedCache( "image_useProcessedCache", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "load processed mip chains from imagecache/ and write them on a miss" );
+idCVar idImageManager::image_fastJPEG( "image_fastJPEG", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "decode .jpg images with the faster but less accurate integer IDCT and upsampling" );
 idCVar idImageManager::image_useCompression( "image_useCompression", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "0 = force everything to high quality" );
 idCVar idImageManager::image_useAllFormats( "image_useAllFormats", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "allow alpha/intensity/luminance/luminance+alpha" );
 idCVar idImageManager::image_useNormalCompression( "image_useNormalCompression", "2", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "2 = use rxgb compression for normal maps, 1 = use 256 color compression for normal maps if available" );
@@ -59,6 +63,8 @@ idCVar idImageManager::image_writeNormalTGA( "image_writeNormalTGA", "0", CVAR_R
 idCVar idImageManager::image_writeNormalTGAPalletized( "image_writeNormalTGAPalletized", "0", CVAR_RENDERER | CVAR_BOOL, "write .tgas of the final palletized normal maps for debugging" );
 idCVar idImageManager::image_writeTGA( "image_writeTGA", "0", CVAR_RENDERER | CVAR_BOOL, "write .tgas of the non normal maps for debugging" );
 idCVar idImageManager::image_useOffLineCompression( "image_useOfflineCompression", "0", CVAR_RENDERER | CVAR_BOOL, "write a batch file for offline compression of DDS files" );
+idCVar idImageManager::image_useCPUCompression( "image_useCPUCompression", "0", CVAR_RENDERER | CVAR_BOOL, "write precompressed dxt images with the CPU block compressor instead of reading them back from the driver" );
+idCVar idImageManager::image_cpuCompressionQuality( "image_cpuCompressionQuality", "1", CVAR_RENDERER | CVAR_INTEGER, "quality of the CPU block compressor, 0 = fast, 1 = normal, 2 = high", 0, 2 );
 idCVar idImageManager::image_cacheMinK( "image_cacheMinK", "200", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "maximum KB of precompressed files to read at specification time" );
 idCVar idImageManager::image_cacheMegs( "image_cacheMegs", "20", CVAR_RENDERER | CVAR_ARCHIVE, "maximum MB set aside for temporary loading of full-sized precompressed images" );
 idCVar idImageManager::image_useCache( "image_useCache", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "1 = do background load image caching" );
@@ -2040,6 +2046,91 @@ void R_CombineCubeImages_f( const idCmdArgs& args )
 	common->SetRefreshOnPrint( false );
 }
 
+/*
+===============
+R_CompressImages_f
+
+Writes block compressed .dds files for an image, or for every 2D image
+when the name is *, without needing the driver to compress them.
+===============
+*/
+void R_CompressImages_f( const idCmdArgs& args )
+{
+	static const char* qualityNames[] = { "fast", "normal", "high" };
+
+	if( args.Argc() < 2 || args.Argc() > 4 )
+	{
+		common->Printf( "usage: compressImages <image program | *> [auto|dxt1|dxt5|rxgb|bc5] [fast|normal|high]\n" );
+		return;
+	}
+
+	const char* format = ( args.Argc() > 2 ) ? args.Argv( 2 ) : "auto";
+
+	blockQuality_t quality = BC_QUALITY_NORMAL;
+	if( args.Argc() > 3 )
+	{
+		int i;
+		for( i = 0; i < 3; i++ )
+		{
+			if( idStr::Icmp( args.Argv( 3 ), qualityNames[i] ) == 0 )
+			{
+				quality = ( blockQuality_t )i;
+				break;
+			}
+		}
+		if( i == 3 )
+		{
+			common->Printf( "unknown quality '%s'\n", args.Argv( 3 ) );
+			return;
+		}
+	}
+
+	common->SetRefreshOnPrint( true );
+
+	int start = Sys_Milliseconds();
+	int count = 0;
+
+	if( idStr::Cmp( args.Argv( 1 ), "*" ) == 0 )
+	{
+		for( int i = 0 ; i < globalImages->images.Num() ; i++ )
+		{
+			idImage* image = globalImages->images[ i ];
+			if( image->generatorFunction || image->cubeFiles != CF_2D || image->isPartialImage )
+			{
+				continue;
+			}
+			if( image->WriteBlockCompressedImage( format, quality ) )
+			{
+				count++;
+			}
+		}
+	}
+	else
+	{
+		// an image that isn't loaded is written from a scratch idImage, so it never
+		// gets registered or uploaded
+		idImage scratch;
+		idImage* image = globalImages->GetImage( args.Argv( 1 ) );
+		if( image == NULL )
+		{
+			scratch.imgName = args.Argv( 1 );
+			scratch.allowDownSize = true;
+			image = &scratch;
+		}
+		if( image->WriteBlockCompressedImage( format, quality ) )
+		{
+			count++;
+		}
+		else
+		{
+			common->Printf( "couldn't load %s\n", args.Argv( 1 ) );
+		}
+	}
+
+	common->SetRefreshOnPrint( false );
+	common->Printf( "%i images compressed in %i msec\n", count, Sys_Milliseconds() - start );
+}
+
 
 /*
 ==================
@@ -2283,6 +2374,8 @@ void idImageManager::Init()
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "testImageProcess", R_TestImageProcess_f, CMD_FL_RENDERER, "compares and times the generic and SIMD image processing kernels" );
+	cmdSystem->AddCommand( "compressImages", R_CompressImages_f, CMD_FL_RENDERER, "writes .dds files with the CPU block compressor" );
 
 	// should forceLoadImages be here?
 }
@@ -2383,6 +2476,8 @@ void idImageManager::EndLevelLoad()
 	}
 
 	// load the ones we do need, if we are preloading
+	idList<idImage*>	loadList;
+
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
 		idImage*	image = images[ i ];
@@ -2394,15 +2489,12 @@ void idImageManager::EndLevelLoad()
 		if( image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage )
 		{
 //			common->Printf( "Loading %s\n", image->imgName.c_str() );
-			loadCount++;
-			image->ActuallyLoadImage( true, false );
-
-			if( ( loadCount & 15 ) == 0 )
-			{
-				session->PacifierUpdate();
-			}
+			loadList.Append( image );
 		}
 	}
+	loadCount = loadList.Num();
+
+	LoadLevelImages( loadList );
 
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i purged from previous\n", purgeCount );
@@ -2412,6 +2504,128 @@ void idImageManager::EndLevelLoad()
 	common->Printf( "----------------------------------------\n" );
 }
 
+/*
+====================
+R_LoadImageLevelsJob
+====================
+*/
+typedef struct
+{
+	idImage*		image;
+	bool			loaded;
+	imageLevels_t	levels;
+	imageLoadStatus_t	status;		// reported by LoadLevelImages after the batch
+} imageLoadJob_t;
+
+static void R_LoadImageLevelsJob( void* parms )
+{
+	imageLoadJob_t* job = ( imageLoadJob_t* )parms;
+
+	R_SetImageLoadStatus( &job->status );
+	job->loaded = job->image->LoadImageLevels( job->levels ) && !job->status.failed;
+	R_SetImageLoadStatus( NULL );
+}
+
+/*
+====================
+LoadLevelImages
+
+Loads all the images in the list. When there are job threads, the plain 2D
+image files are decoded, run through their image programs and mip mapped on
+the job threads a batch at a time, only the precompressed checks, the
+texture uploads and the reporting of load errors are done here.
+====================
+*/
+void idImageManager::LoadLevelImages( idList<idImage*>& loadList )
+{
+	// the tga debug writes go through the file system from inside BuildImageLevels
+	if( !image_parallelLoad.GetBool() || Sys_NumJobThreads() == 0
+			|| image_writeTGA.GetBool() || image_writeNormalTGA.GetBool() )
+	{
+		for( int i = 0 ; i < loadList.Num() ; i++ )
+		{
+			loadList[i]->ActuallyLoadImage( true, false );
+
+			if( ( ( i + 1 ) & 15 ) == 0 )
+			{
+				session->PacifierUpdate();
+			}
+		}
+		return;
+	}
+
+	// every job in a batch holds a complete mip chain until it is uploaded,
+	// so keep the batches small enough to not blow up level load memory
+	const int batchSize = ( Sys_NumJobThreads() + 1 ) * 2;
+	imageLoadJob_t* jobs = ( imageLoadJob_t* )_alloca( batchSize * sizeof( jobs[0] ) );
+
+	int next = 0;
+	while( next < loadList.Num() )
+	{
+		int numJobs = 0;
+
+		while( next < loadList.Num() && numJobs < batchSize )
+		{
+			idImage* image = loadList[next++];
+
+			// cube maps and partial images are rare, just load them here
+			if( image->cubeFiles != CF_2D || image->isPartialImage )
+			{
+				image->ActuallyLoadImage( true, false );
+				continue;
+			}
+
+			if( image_usePrecompressedTextures.GetBool() && image->CheckPrecompressedImage( true ) )
+			{
+				continue;
+			}
+
+			jobs[numJobs].image = image;
+			jobs[numJobs].loaded = false;
+			jobs[numJobs].levels.numLevels = 0;
+			numJobs++;
+		}
+
+		// the heap and the file system are only serialized while the jobs run
+		Mem_BeginThreadSafeAllocs();
+		Sys_RunJobs( R_LoadImageLevelsJob, jobs, sizeof( jobs[0] ), numJobs );
+		Mem_EndThreadSafeAllocs();
+
+		for( int i = 0 ; i < numJobs ; i++ )
+		{
+			idImage* image = jobs[i].image;
+
+			if( jobs[i].status.warning[0] )
+			{
+				common->Warning( "%s", jobs[i].status.warning );
+			}
+
+			if( !jobs[i].loaded )
+			{
+				if( jobs[i].status.failed )
+				{
+					common->Warning( "%s", jobs[i].status.error );
+				}
+				common->Warning( "Couldn't load image: %s", image->imgName.c_str() );
+				image->MakeDefault();
+				continue;
+			}
+
+			image->PurgeImage();
+			if( jobs[i].levels.numLevels )
+			{
+				image->UploadImageLevels( jobs[i].levels );
+			}
+			image->precompressedFile = false;
+
+			// write out the precompressed version of this file if needed
+			image->WritePrecompressedImage();
+		}
+
+		session->PacifierUpdate();
+	}
+}
+
 /*
 ===============
 idImageManager::StartBuild
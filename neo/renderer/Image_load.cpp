@@ -591,10 +591,7 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 							 textureFilter_t filterParm, bool allowDownSizeParm,
 							 textureRepeat_t repeatParm, textureDepth_t depthParm )
 {
-	bool	preserveBorder;
-	byte*		scaledBuffer;
-	int			scaled_width, scaled_height;
-	byte*		shrunk;
+	imageLevels_t	levels;
 
 	PurgeImage();
 
@@ -612,6 +609,28 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 		return;
 	}
 
+	BuildImageLevels( pic, width, height, levels );
+	UploadImageLevels( levels );
+}
+
+/*
+================
+BuildImageLevels
+
+Does all of the CPU work of GenerateImage: picks the internal format, downsizes
+the first level and builds the complete mip chain into levels. Nothing here
+touches OpenGL, so it can run on a job thread while loading a level.
+================
+*/
+void idImage::BuildImageLevels( const byte* pic, int width, int height, imageLevels_t& levels )
+{
+	bool	preserveBorder;
+	byte*		scaledBuffer;
+	int			scaled_width, scaled_height;
+	byte*		shrunk;
+
+	levels.numLevels = 0;
+
 	// don't let mip mapping smear the texture into the clamped border
 	if( repeat == TR_CLAMP_TO_ZERO )
 	{
@@ -628,7 +647,9 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 
 	if( scaled_width != width || scaled_height != height )
 	{
-		common->Error( "R_CreateImage: not a power of 2 image" );
+		R_ImageLoadError( "R_CreateImage: not a power of 2 image (%s)", imgName.c_str() );
+		levels.numLevels = 0;
+		return;
 	}
 
 	// Optionally modify our width/height based on options/hardware
@@ -636,9 +657,6 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 
 	scaledBuffer = NULL;
 
-	// generate the texture number
-	qglGenTextures( 1, &texnum );
-
 	// select proper internal format before we resample
 	internalFormat = SelectInternalFormat( &pic, 1, width, height, depth, &isMonochrome );
 
@@ -757,36 +775,17 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 			scaledBuffer[ i ] = 0;
 		}
 	}
-	// upload the main image level
-	Bind();
-
-
-	if( internalFormat == GL_COLOR_INDEX8_EXT )
-	{
-		/*
-		if ( depth == TD_BUMP ) {
-			for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
-				scaledBuffer[ i ] = scaledBuffer[ i + 3 ];
-				scaledBuffer[ i + 3 ] = 0;
-			}
-		}
-		*/
-		UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, 0 );
-	}
-	else
-	{
-		qglTexImage2D( GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
-	}
 
-	// create and upload the mip map levels, which we do in all cases, even if we don't think they are needed
-	int		miplevel;
+	levels.width[0] = scaled_width;
+	levels.height[0] = scaled_height;
+	levels.data[0] = scaledBuffer;
+	levels.numLevels = 1;
 
-	miplevel = 0;
+	// create the mip map levels, which we do in all cases, even if we don't think they are needed
 	while( scaled_width > 1 || scaled_height > 1 )
 	{
 		// preserve the border after mip map unless repeating
 		shrunk = R_MipMap( scaledBuffer, scaled_width, scaled_height, preserveBorder );
-		R_StaticFree( scaledBuffer );
 		scaledBuffer = shrunk;
 
 		scaled_width >>= 1;
@@ -799,7 +798,6 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 		{
 			scaled_height = 1;
 		}
-		miplevel++;
 
 		// this is a visualization tool that shades each mip map
 		// level with a different color so you can see the
@@ -807,25 +805,46 @@ void idImage::GenerateImage( const byte* pic, int width, int height,
 		// Changing the color doesn't help with lumminance/alpha/intensity formats...
 		if( depth == TD_DIFFUSE && globalImages->image_colorMipLevels.GetBool() )
 		{
-			R_BlendOverTexture( ( byte* )scaledBuffer, scaled_width * scaled_height, mipBlendColors[miplevel] );
+			R_BlendOverTexture( ( byte* )scaledBuffer, scaled_width * scaled_height, mipBlendColors[levels.numLevels] );
 		}
 
-		// upload the mip map
+		assert( levels.numLevels < MAX_IMAGE_LEVELS );
+		levels.width[levels.numLevels] = scaled_width;
+		levels.height[levels.numLevels] = scaled_height;
+		levels.data[levels.numLevels] = scaledBuffer;
+		levels.numLevels++;
+	}
+}
+
+/*
+================
+UploadImageLevels
+
+Creates the texture object from levels built by BuildImageLevels, and frees them.
+================
+*/
+void idImage::UploadImageLevels( imageLevels_t& levels )
+{
+	// generate the texture number
+	qglGenTextures( 1, &texnum );
+
+	// upload the main image level and the mip map levels
+	Bind();
+
+	for( int miplevel = 0; miplevel < levels.numLevels; miplevel++ )
+	{
 		if( internalFormat == GL_COLOR_INDEX8_EXT )
 		{
-			UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, miplevel );
+			UploadCompressedNormalMap( levels.width[miplevel], levels.height[miplevel], levels.data[miplevel], miplevel );
 		}
 		else
 		{
-			qglTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height,
-						   0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
+			qglTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, levels.width[miplevel], levels.height[miplevel],
+						   0, GL_RGBA, GL_UNSIGNED_BYTE, levels.data[miplevel] );
 		}
+		R_StaticFree( levels.data[miplevel] );
 	}
-
-	if( scaledBuffer != 0 )
-	{
-		R_StaticFree( scaledBuffer );
-	}
+	levels.numLevels = 0;
 
 	SetImageFilterAndRepeat();
 
@@ -1258,6 +1277,14 @@ void idImage::WritePrecompressedImage()
 			}
 	}
 
+	// compress the source again on the CPU instead of reading back what the driver made
+	if( globalImages->image_useCPUCompression.GetBool() && ( altInternalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || altInternalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ) )
+	{
+		const char* format = ( altInternalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ) ? "dxt1" : ( depth == TD_BUMP ? "rxgb" : "dxt5" );
+		WriteBlockCompressedImage( format, ( blockQuality_t )idMath::ClampInt( BC_QUALITY_FAST, BC_QUALITY_HIGH, globalImages->image_cpuCompressionQuality.GetInteger() ) );
+		return;
+	}
+
 	if( globalImages->image_useOffLineCompression.GetBool() && FormatIsDXT( altInternalFormat ) )
 	{
 		idStr outFile = fileSystem->RelativePathToOSPath( filename, "fs_basepath" );
@@ -1449,6 +1476,201 @@ void idImage::WritePrecompressedImage()
 	fileSystem->CloseFile( f );
 }
 
+/*
+================
+WriteBlockCompressedImage
+
+Runs the image program and writes the full size mip chain to the .dds file
+CheckPrecompressedImage looks for, compressed by R_BlockCompress instead of
+the driver, so it works without a rendering context. The image is checked,
+downsized and border zeroed the same way BuildImageLevels does. An empty or "auto"
+format picks RXGB for normal maps, DXT5 for images with alpha and DXT1 for
+the rest. BC5 files are for other tools, the renderer can't load them.
+Returns false if the image couldn't be loaded.
+================
+*/
+bool idImage::WriteBlockCompressedImage( const char* formatName, blockQuality_t quality ) const
+{
+	byte*			pic;
+	int				width, height;
+	ID_TIME_T		picTimestamp;
+	textureDepth_t	picDepth = depth;
+
+	R_LoadImageProgram( imgName, &pic, &width, &height, &picTimestamp, &picDepth );
+	if( pic == NULL )
+	{
+		return false;
+	}
+
+	idStr format = formatName;
+	if( format.Length() == 0 || format.Icmp( "auto" ) == 0 )
+	{
+		if( picDepth == TD_BUMP )
+		{
+			format = "rxgb";
+		}
+		else
+		{
+			format = "dxt1";
+			for( int i = 0; i < width * height; i++ )
+			{
+				if( pic[i * 4 + 3] != 255 )
+				{
+					format = "dxt5";
+					break;
+				}
+			}
+		}
+	}
+
+	blockFormat_t	blockFormat;
+	unsigned long	fourCC;
+	if( format.Icmp( "dxt1" ) == 0 )
+	{
+		blockFormat = BC_FORMAT_BC1;
+		fourCC = DDS_MAKEFOURCC( 'D', 'X', 'T', '1' );
+	}
+	else if( format.Icmp( "dxt5" ) == 0 )
+	{
+		blockFormat = BC_FORMAT_BC3;
+		fourCC = DDS_MAKEFOURCC( 'D', 'X', 'T', '5' );
+	}
+	else if( format.Icmp( "rxgb" ) == 0 )
+	{
+		blockFormat = BC_FORMAT_BC3;
+		fourCC = DDS_MAKEFOURCC( 'R', 'X', 'G', 'B' );
+	}
+	else if( format.Icmp( "bc5" ) == 0 )
+	{
+		blockFormat = BC_FORMAT_BC5;
+		fourCC = DDS_MAKEFOURCC( 'A', 'T', 'I', '2' );
+	}
+	else
+	{
+		common->Warning( "WriteBlockCompressedImage: unknown format '%s'", format.c_str() );
+		R_StaticFree( pic );
+		return false;
+	}
+
+	// the same preparation BuildImageLevels does, so the file matches what would be uploaded
+	if( MakePowerOfTwo( width ) != width || MakePowerOfTwo( height ) != height )
+	{
+		common->Warning( "WriteBlockCompressedImage: not a power of 2 image (%s)", imgName.c_str() );
+		R_StaticFree( pic );
+		return false;
+	}
+
+	// don't let mip mapping smear the texture into the clamped border
+	bool preserveBorder = ( repeat == TR_CLAMP_TO_ZERO );
+
+	int scaled_width = width;
+	int scaled_height = height;
+	GetDownsize( scaled_width, scaled_height );
+	while( width > scaled_width || height > scaled_height )
+	{
+		byte* shrunk = R_MipMap( pic, width, height, preserveBorder );
+		R_StaticFree( pic );
+		pic = shrunk;
+		width = Max( width >> 1, 1 );
+		height = Max( height >> 1, 1 );
+	}
+
+	// zero the border for clamped projection textures
+	if( repeat == TR_CLAMP_TO_ZERO )
+	{
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 0;
+		rgba[3] = 255;
+		R_SetBorderTexels( pic, width, height, rgba );
+	}
+	if( repeat == TR_CLAMP_TO_ZERO_ALPHA )
+	{
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 255;
+		rgba[3] = 0;
+		R_SetBorderTexels( pic, width, height, rgba );
+	}
+
+	// the red and alpha swap for rxgb normal maps
+	if( fourCC == DDS_MAKEFOURCC( 'R', 'X', 'G', 'B' ) )
+	{
+		for( int i = 0; i < width * height * 4; i += 4 )
+		{
+			pic[ i + 3 ] = pic[ i ];
+			pic[ i ] = 0;
+		}
+	}
+
+	int numLevels = NumLevelsForImageSize( width, height );
+
+	int size = 0;
+	for( int level = 0, w = width, h = height; level < numLevels; level++ )
+	{
+		size += R_BlockCompressedSize( w, h, blockFormat );
+		w = Max( w >> 1, 1 );
+		h = Max( h >> 1, 1 );
+	}
+
+	byte* data = ( byte* )R_StaticAlloc( size );
+	byte* out = data;
+	for( int level = 0, w = width, h = height; level < numLevels; level++ )
+	{
+		R_BlockCompress( pic, w, h, out, blockFormat, quality );
+		out += R_BlockCompressedSize( w, h, blockFormat );
+
+		if( level < numLevels - 1 )
+		{
+			byte* shrunk = R_MipMap( pic, w, h, preserveBorder );
+			R_StaticFree( pic );
+			pic = shrunk;
+			w = Max( w >> 1, 1 );
+			h = Max( h >> 1, 1 );
+		}
+	}
+	R_StaticFree( pic );
+
+	ddsFileHeader_t header;
+	memset( &header, 0, sizeof( header ) );
+	header.dwSize = sizeof( header );
+	header.dwFlags = DDSF_CAPS | DDSF_PIXELFORMAT | DDSF_WIDTH | DDSF_HEIGHT | DDSF_LINEARSIZE;
+	header.dwHeight = height;
+	header.dwWidth = width;
+	header.dwPitchOrLinearSize = R_BlockCompressedSize( width, height, blockFormat );
+	header.dwCaps1 = DDSF_TEXTURE;
+	if( numLevels > 1 )
+	{
+		header.dwMipMapCount = numLevels;
+		header.dwFlags |= DDSF_MIPMAPCOUNT;
+		header.dwCaps1 |= DDSF_MIPMAP | DDSF_COMPLEX;
+	}
+	header.ddspf.dwSize = sizeof( header.ddspf );
+	header.ddspf.dwFlags = DDSF_FOURCC;
+	header.ddspf.dwFourCC = fourCC;
+
+	char filename[MAX_IMAGE_NAME];
+	ImageProgramStringToCompressedFileName( imgName, filename );
+
+	idFile* f = fileSystem->OpenFileWrite( filename );
+	if( f == NULL )
+	{
+		common->Warning( "Could not open %s trying to write block compressed image", filename );
+		R_StaticFree( data );
+		return false;
+	}
+	common->Printf( "Writing %s image: %s\n", format.c_str(), filename );
+
+	f->Write( "DDS ", 4 );
+	f->Write( &header, sizeof( header ) );
+	f->Write( data, size );
+
+	fileSystem->CloseFile( f );
+	R_StaticFree( data );
+
+	return true;
+}
+
 /*
 ================
 ShouldImageBePartialCached
@@ -1813,8 +2035,7 @@ On exit, the idImage will have a valid OpenGL texture number that can be bound
 */
 void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 {
-	int		width, height;
-	byte*	pic;
+	int		width;
 
 	// this is the ONLY place generatorFunction will ever be called
 	if( generatorFunction )
@@ -1877,43 +2098,326 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 			// fall through to load the normal image
 		}
 
-		R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
+		imageLevels_t	levels;
 
-		if( pic == NULL )
+		if( !LoadImageLevels( levels ) )
 		{
 			common->Warning( "Couldn't load image: %s", imgName.c_str() );
 			MakeDefault();
 			return;
 		}
-		/*
-				// swap the red and alpha for rxgb support
-				// do this even on tga normal maps so we only have to use
-				// one fragment program
-				// if the image is precompressed ( either in palletized mode or true rxgb mode )
-				// then it is loaded above and the swap never happens here
-				if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
-					for ( int i = 0; i < width * height * 4; i += 4 ) {
-						pic[ i + 3 ] = pic[ i ];
-						pic[ i ] = 0;
-					}
-				}
-		*/
-		// build a hash for checking duplicate image files
-		// NOTE: takes about 10% of image load times (SD)
-		// may not be strictly necessary, but some code uses it, so let's leave it in
-		imageHash = MD4_BlockChecksum( pic, width * height * 4 );
-
-		GenerateImage( pic, width, height, filter, allowDownSize, repeat, depth );
-		timestamp = timestamp;
-		precompressedFile = false;
 
-		R_StaticFree( pic );
+		PurgeImage();
+		if( levels.numLevels )
+		{
+			UploadImageLevels( levels );
+		}
+		precompressedFile = false;
 
 		// write out the precompressed version of this file if needed
 		WritePrecompressedImage();
 	}
 }
 
+/*
+===============
+LoadImageLevels
+
+The CPU half of loading a 2D image file: runs the image program, hashes the
+result and builds the mip levels, UploadImageLevels finishes the job.
+When image_useProcessedCache is set the levels come from the processed
+image cache if they can, and are written to it if they can't.
+This is run on job threads by idImageManager::EndLevelLoad, so it must not
+touch OpenGL or any shared state beyond this image.
+Returns false if the image couldn't be loaded.
+===============
+*/
+bool idImage::LoadImageLevels( imageLevels_t& levels )
+{
+	int		width, height;
+	byte*	pic;
+	idStr	cacheKey;
+	bool	useCache;
+
+	levels.numLevels = 0;
+
+	// the processed image cache holds exactly what BuildImageLevels would make,
+	// so skip it when we need its side effects or have nothing to build
+	useCache = false;
+	if( glConfig.isInitialized && globalImages->image_useProcessedCache.GetBool()
+			&& !globalImages->image_writeTGA.GetBool() && !globalImages->image_writeNormalTGA.GetBool() )
+	{
+		ID_TIME_T	sourceTimestamp;
+
+		useCache = ProcessedImageKey( cacheKey, &sourceTimestamp );
+		if( useCache && LoadProcessedImage( cacheKey, levels ) )
+		{
+			timestamp = sourceTimestamp;
+			return true;
+		}
+	}
+
+	R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
+
+	if( pic == NULL )
+	{
+		return false;
+	}
+	/*
+			// swap the red and alpha for rxgb support
+			// do this even on tga normal maps so we only have to use
+			// one fragment program
+			// if the image is precompressed ( either in palletized mode or true rxgb mode )
+			// then it is loaded above and the swap never happens here
+			if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
+				for ( int i = 0; i < width * height * 4; i += 4 ) {
+					pic[ i + 3 ] = pic[ i ];
+					pic[ i ] = 0;
+				}
+			}
+	*/
+	// build a hash for checking duplicate image files
+	// NOTE: takes about 10% of image load times (SD)
+	// may not be strictly necessary, but some code uses it, so let's leave it in
+	imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+
+	// if we don't have a rendering context there is nothing to build
+	if( glConfig.isInitialized )
+	{
+		BuildImageLevels( pic, width, height, levels );
+
+		if( levels.numLevels == 0 )
+		{
+			R_StaticFree( pic );
+			return false;
+		}
+
+		if( useCache )
+		{
+			WriteProcessedImage( cacheKey, levels );
+		}
+	}
+
+	R_StaticFree( pic );
+
+	return true;
+}
+
+/*
+========================================================================
+
+The processed image cache keeps the finished mip chain of 2D images, after the
+image program, downsizing and format selection, so a later load of the same
+image is only a file read and a decompress. Files are named by a checksum of
+the key, which holds the image program, every setting that changes what
+BuildImageLevels makes and the checksums of the source files, so edited
+sources or changed settings just miss and write a new file.
+
+========================================================================
+*/
+
+static const int PROCESSED_IMAGE_ID			= ( ( 'G' << 24 ) | ( 'M' << 16 ) | ( 'I' << 8 ) | 'B' );
+static const int PROCESSED_IMAGE_VERSION	= 2;
+
+/*
+================
+ProcessedImageKey
+
+Returns false if any of the source images can't be found.
+================
+*/
+bool idImage::ProcessedImageKey( idStr& key, ID_TIME_T* sourceTimestamp ) const
+{
+	idStrList		sources;
+	char			buffer[1024];
+	unsigned int	checksum;
+	ID_TIME_T		fileTimestamp;
+
+	*sourceTimestamp = 0;
+
+	R_ImageProgramSources( imgName, sources );
+	if( sources.Num() == 0 )
+	{
+		return false;
+	}
+
+	idStr::snPrintf( buffer, sizeof( buffer ), "%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d ",
+					 PROCESSED_IMAGE_VERSION, depth, repeat, allowDownSize, globalImages->image_fastJPEG.GetBool(), globalImages->image_useSIMD.GetBool(),
+					 globalImages->image_downSize.GetInteger(), globalImages->image_downSizeLimit.GetInteger(),
+					 globalImages->image_downSizeSpecular.GetInteger(), globalImages->image_downSizeSpecularLimit.GetInteger(),
+					 globalImages->image_downSizeBump.GetInteger(), globalImages->image_downSizeBumpLimit.GetInteger(),
+					 globalImages->image_forceDownSize.GetBool(), globalImages->image_roundDown.GetBool(),
+					 globalImages->image_useCompression.GetBool(), globalImages->image_useNormalCompression.GetInteger(),
+					 globalImages->image_useAllFormats.GetBool(), globalImages->image_colorMipLevels.GetBool(),
+					 glConfig.maxTextureSize, glConfig.textureCompressionAvailable, glConfig.sharedTexturePaletteAvailable );
+	key = buffer;
+	key += imgName;
+
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		if( !R_ImageFileChecksum( sources[i], &checksum, &fileTimestamp ) )
+		{
+			return false;
+		}
+		idStr::snPrintf( buffer, sizeof( buffer ), " %08x", checksum );
+		key += buffer;
+
+		if( fileTimestamp > *sourceTimestamp )
+		{
+			*sourceTimestamp = fileTimestamp;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+ProcessedImageFileName
+================
+*/
+void idImage::ProcessedImageFileName( const idStr& key, char* fileName ) const
+{
+	idStr::snPrintf( fileName, MAX_IMAGE_NAME, "imagecache/%08x.bimg", ( unsigned int )MD4_BlockChecksum( key.c_str(), key.Length() ) );
+}
+
+/*
+================
+LoadProcessedImage
+
+Fills in levels and the upload parameters from the cache file for key,
+returns false if there isn't a valid one.
+================
+*/
+bool idImage::LoadProcessedImage( const idStr& key, imageLevels_t& levels )
+{
+	char	filename[MAX_IMAGE_NAME];
+	void*	buffer;
+	int		len;
+
+	levels.numLevels = 0;
+
+	ProcessedImageFileName( key, filename );
+	len = R_ReadImageFile( filename, &buffer, NULL );
+	if( !buffer )
+	{
+		return false;
+	}
+
+	idFile_Memory	f( filename, ( const char* )buffer, len );
+	idStr			fileKey;
+	int				fileId, version, fileFormat, fileMonochrome, fileHash, fileDepth, numLevels;
+
+	f.ReadInt( fileId );
+	f.ReadInt( version );
+	if( fileId != PROCESSED_IMAGE_ID || version != PROCESSED_IMAGE_VERSION )
+	{
+		R_FreeImageFile( buffer );
+		return false;
+	}
+
+	// the file name is only a checksum, so make sure it is really ours
+	f.ReadString( fileKey );
+	f.ReadInt( fileFormat );
+	f.ReadInt( fileMonochrome );
+	f.ReadInt( fileHash );
+	f.ReadInt( fileDepth );
+	f.ReadInt( numLevels );
+	if( fileKey != key || numLevels < 1 || numLevels > MAX_IMAGE_LEVELS )
+	{
+		R_FreeImageFile( buffer );
+		return false;
+	}
+
+	for( int i = 0; i < numLevels; i++ )
+	{
+		f.ReadInt( levels.width[i] );
+		f.ReadInt( levels.height[i] );
+		if( levels.width[i] < 1 || levels.height[i] < 1 || levels.width[i] > 16384 || levels.height[i] > 16384 )
+		{
+			R_FreeImageFile( buffer );
+			return false;
+		}
+	}
+
+	idCompressor* compressor = idCompressor::AllocLZSS();
+	compressor->Init( &f, false, 8 );
+
+	for( levels.numLevels = 0; levels.numLevels < numLevels; levels.numLevels++ )
+	{
+		int size = levels.width[levels.numLevels] * levels.height[levels.numLevels] * 4;
+
+		levels.data[levels.numLevels] = ( byte* )R_StaticAlloc( size );
+		if( compressor->Read( levels.data[levels.numLevels], size ) != size )
+		{
+			// truncated file, throw away what we have
+			for( int i = 0; i <= levels.numLevels; i++ )
+			{
+				R_StaticFree( levels.data[i] );
+			}
+			levels.numLevels = 0;
+			break;
+		}
+	}
+
+	delete compressor;
+	R_FreeImageFile( buffer );
+
+	if( !levels.numLevels )
+	{
+		return false;
+	}
+
+	internalFormat = fileFormat;
+	isMonochrome = ( fileMonochrome != 0 );
+	imageHash = fileHash;
+	depth = ( textureDepth_t )fileDepth;
+	uploadWidth = levels.width[0];
+	uploadHeight = levels.height[0];
+	type = TT_2D;
+
+	return true;
+}
+
+/*
+================
+WriteProcessedImage
+================
+*/
+void idImage::WriteProcessedImage( const idStr& key, const imageLevels_t& levels ) const
+{
+	char	filename[MAX_IMAGE_NAME];
+
+	ProcessedImageFileName( key, filename );
+
+	idFile_Memory	f( filename );
+
+	f.WriteInt( PROCESSED_IMAGE_ID );
+	f.WriteInt( PROCESSED_IMAGE_VERSION );
+	f.WriteString( key );
+	f.WriteInt( internalFormat );
+	f.WriteInt( isMonochrome );
+	f.WriteInt( imageHash );
+	f.WriteInt( depth );
+	f.WriteInt( levels.numLevels );
+	for( int i = 0; i < levels.numLevels; i++ )
+	{
+		f.WriteInt( levels.width[i] );
+		f.WriteInt( levels.height[i] );
+	}
+
+	idCompressor* compressor = idCompressor::AllocLZSS();
+	compressor->Init( &f, true, 8 );
+	for( int i = 0; i < levels.numLevels; i++ )
+	{
+		compressor->Write( levels.data[i], levels.width[i] * levels.height[i] * 4 );
+	}
+	compressor->FinishCompress();
+	delete compressor;
+
+	R_WriteImageFile( filename, f.GetDataPtr(), f.Length() );
+}
+
 //=========================================================================================================
 
 /*
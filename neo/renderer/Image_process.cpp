@@ -30,6 +30,10 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+#ifdef ID_IMAGE_SSE2
+	#include <emmintrin.h>
+#endif
+
 /*
 ================
 R_ResampleTexture
@@ -86,7 +90,27 @@ byte* R_ResampleTexture( const byte* in, int inwidth, int inheight,
 		inrow = in + 4 * inwidth * ( int )( ( i + 0.25f ) * inheight / outheight );
 		inrow2 = in + 4 * inwidth * ( int )( ( i + 0.75f ) * inheight / outheight );
 		frac = fracstep >> 1;
-		for( j = 0 ; j < outwidth ; j++ )
+		j = 0;
+#ifdef ID_IMAGE_SSE2
+		if( globalImages->image_useSIMD.GetBool() )
+		{
+			// two output texels at a time, the four taps are summed in 16 bits
+			const __m128i zero = _mm_setzero_si128();
+			for( ; j + 2 <= outwidth ; j += 2 )
+			{
+				__m128i t1 = _mm_unpacklo_epi32( _mm_cvtsi32_si128( *( const int* )( inrow + p1[j] ) ), _mm_cvtsi32_si128( *( const int* )( inrow + p1[j + 1] ) ) );
+				__m128i t2 = _mm_unpacklo_epi32( _mm_cvtsi32_si128( *( const int* )( inrow + p2[j] ) ), _mm_cvtsi32_si128( *( const int* )( inrow + p2[j + 1] ) ) );
+				__m128i t3 = _mm_unpacklo_epi32( _mm_cvtsi32_si128( *( const int* )( inrow2 + p1[j] ) ), _mm_cvtsi32_si128( *( const int* )( inrow2 + p1[j + 1] ) ) );
+				__m128i t4 = _mm_unpacklo_epi32( _mm_cvtsi32_si128( *( const int* )( inrow2 + p2[j] ) ), _mm_cvtsi32_si128( *( const int* )( inrow2 + p2[j + 1] ) ) );
+				__m128i sum = _mm_add_epi16( _mm_unpacklo_epi8( t1, zero ), _mm_unpacklo_epi8( t2, zero ) );
+				sum = _mm_add_epi16( sum, _mm_unpacklo_epi8( t3, zero ) );
+				sum = _mm_add_epi16( sum, _mm_unpacklo_epi8( t4, zero ) );
+				sum = _mm_srli_epi16( sum, 2 );
+				_mm_storel_epi64( ( __m128i* )( out_p + j * 4 ), _mm_packus_epi16( sum, zero ) );
+			}
+		}
+#endif
+		for( ; j < outwidth ; j++ )
 		{
 			pix1 = inrow + p1[j];
 			pix2 = inrow + p2[j];
@@ -502,7 +526,38 @@ byte* R_MipMap( const byte* in, int width, int height, bool preserveBorder )
 
 	for( i = 0 ; i < height ; i++, in_p += row )
 	{
-		for( j = 0 ; j < width ; j++, out_p += 4, in_p += 8 )
+		j = 0;
+#ifdef ID_IMAGE_SSE2
+		if( globalImages->image_useSIMD.GetBool() )
+		{
+			// four output texels at a time, each 2x2 block is summed in 16 bits
+			const __m128i zero = _mm_setzero_si128();
+			for( ; j + 4 <= width ; j += 4, out_p += 16, in_p += 32 )
+			{
+				__m128i a0 = _mm_loadu_si128( ( const __m128i* )( in_p ) );
+				__m128i a1 = _mm_loadu_si128( ( const __m128i* )( in_p + 16 ) );
+				__m128i b0 = _mm_loadu_si128( ( const __m128i* )( in_p + row ) );
+				__m128i b1 = _mm_loadu_si128( ( const __m128i* )( in_p + row + 16 ) );
+
+				// vertical pairs, two texels per register
+				__m128i s0 = _mm_add_epi16( _mm_unpacklo_epi8( a0, zero ), _mm_unpacklo_epi8( b0, zero ) );
+				__m128i s1 = _mm_add_epi16( _mm_unpackhi_epi8( a0, zero ), _mm_unpackhi_epi8( b0, zero ) );
+				__m128i s2 = _mm_add_epi16( _mm_unpacklo_epi8( a1, zero ), _mm_unpacklo_epi8( b1, zero ) );
+				__m128i s3 = _mm_add_epi16( _mm_unpackhi_epi8( a1, zero ), _mm_unpackhi_epi8( b1, zero ) );
+
+				// horizontal pairs end up in the low half
+				s0 = _mm_add_epi16( s0, _mm_srli_si128( s0, 8 ) );
+				s1 = _mm_add_epi16( s1, _mm_srli_si128( s1, 8 ) );
+				s2 = _mm_add_epi16( s2, _mm_srli_si128( s2, 8 ) );
+				s3 = _mm_add_epi16( s3, _mm_srli_si128( s3, 8 ) );
+
+				__m128i lo = _mm_srli_epi16( _mm_unpacklo_epi64( s0, s1 ), 2 );
+				__m128i hi = _mm_srli_epi16( _mm_unpacklo_epi64( s2, s3 ), 2 );
+				_mm_storeu_si128( ( __m128i* )out_p, _mm_packus_epi16( lo, hi ) );
+			}
+		}
+#endif
+		for( ; j < width ; j++, out_p += 4, in_p += 8 )
 		{
 			out_p[0] = ( in_p[0] + in_p[4] + in_p[row + 0] + in_p[row + 4] ) >> 2;
 			out_p[1] = ( in_p[1] + in_p[5] + in_p[row + 1] + in_p[row + 5] ) >> 2;
@@ -692,3 +747,548 @@ void R_RotatePic( byte* data, int width )
 	R_StaticFree( temp );
 }
 
+
+/*
+====================================================================
+
+BLOCK COMPRESSION
+
+CPU encoders for BC1 (DXT1), BC3 (DXT5) and BC5 (two channel) blocks, so
+.dds files can be made without a GL driver doing the compression.
+
+====================================================================
+*/
+
+/*
+================
+R_GetBlockTexels
+
+copies the 4x4 block at bx, by, repeating the edge texels of images
+smaller than a block
+================
+*/
+static void R_GetBlockTexels( const byte* rgba, int width, int height, int bx, int by, byte block[16][4] )
+{
+	for( int y = 0; y < 4; y++ )
+	{
+		int sy = Min( by * 4 + y, height - 1 );
+		for( int x = 0; x < 4; x++ )
+		{
+			int sx = Min( bx * 4 + x, width - 1 );
+			*( int* )block[y * 4 + x] = *( const int* )( rgba + ( sy * width + sx ) * 4 );
+		}
+	}
+}
+
+/*
+================
+R_ColorTo565
+================
+*/
+static ID_INLINE int R_ColorTo565( const int c[3] )
+{
+	return ( ( ( c[0] * 31 + 127 ) / 255 ) << 11 ) | ( ( ( c[1] * 63 + 127 ) / 255 ) << 5 ) | ( ( c[2] * 31 + 127 ) / 255 );
+}
+
+/*
+================
+R_ColorFrom565
+================
+*/
+static ID_INLINE void R_ColorFrom565( int c565, int c[3] )
+{
+	int r = ( c565 >> 11 ) & 31;
+	int g = ( c565 >> 5 ) & 63;
+	int b = c565 & 31;
+	c[0] = ( r << 3 ) | ( r >> 2 );
+	c[1] = ( g << 2 ) | ( g >> 4 );
+	c[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+/*
+================
+R_EncodeColorIndices
+
+picks the closest of the four block colors for each texel, returns the total squared error
+================
+*/
+static int R_EncodeColorIndices( const byte block[16][4], int c0, int c1, unsigned int* indices )
+{
+	int		palette[4][3];
+	int		error = 0;
+
+	R_ColorFrom565( c0, palette[0] );
+	R_ColorFrom565( c1, palette[1] );
+	for( int i = 0; i < 3; i++ )
+	{
+		palette[2][i] = ( 2 * palette[0][i] + palette[1][i] ) / 3;
+		palette[3][i] = ( palette[0][i] + 2 * palette[1][i] ) / 3;
+	}
+
+	// equal end points would be read as the three color mode with a transparent
+	// black index in BC1, every palette color is the same so just use the first
+	int numColors = ( c0 > c1 ) ? 4 : 1;
+
+	*indices = 0;
+	for( int i = 0; i < 16; i++ )
+	{
+		int best = 0;
+		int bestError = 0x7fffffff;
+		for( int j = 0; j < numColors; j++ )
+		{
+			int dr = block[i][0] - palette[j][0];
+			int dg = block[i][1] - palette[j][1];
+			int db = block[i][2] - palette[j][2];
+			int e = dr * dr + dg * dg + db * db;
+			if( e < bestError )
+			{
+				bestError = e;
+				best = j;
+			}
+		}
+		*indices |= best << ( i * 2 );
+		error += bestError;
+	}
+	return error;
+}
+
+/*
+================
+R_QuantizeColorEndPoints
+
+rounds the end points to 565 and orders them for the four color mode,
+returns the total squared error of the block
+================
+*/
+static int R_QuantizeColorEndPoints( const byte block[16][4], const float minColor[3], const float maxColor[3], int* c0, int* c1, unsigned int* indices )
+{
+	int		a[3], b[3];
+
+	for( int i = 0; i < 3; i++ )
+	{
+		a[i] = idMath::ClampInt( 0, 255, idMath::FtoiFast( maxColor[i] + 0.5f ) );
+		b[i] = idMath::ClampInt( 0, 255, idMath::FtoiFast( minColor[i] + 0.5f ) );
+	}
+	*c0 = R_ColorTo565( a );
+	*c1 = R_ColorTo565( b );
+
+	// the first color has to be the larger one for the four color mode
+	if( *c0 < *c1 )
+	{
+		int temp = *c0;
+		*c0 = *c1;
+		*c1 = temp;
+	}
+	return R_EncodeColorIndices( block, *c0, *c1, indices );
+}
+
+/*
+================
+R_EncodeColorBlock
+
+BC_QUALITY_FAST uses the inset bounding box of the colors, BC_QUALITY_NORMAL fits
+the end points to the principal axis of the colors and BC_QUALITY_HIGH also refines
+them with a few least squares passes over the chosen indices.
+================
+*/
+static void R_EncodeColorBlock( const byte block[16][4], blockQuality_t quality, byte* out )
+{
+	float	minColor[3], maxColor[3];
+	int		c0, c1;
+	unsigned int indices;
+
+	for( int i = 0; i < 3; i++ )
+	{
+		minColor[i] = 255.0f;
+		maxColor[i] = 0.0f;
+	}
+	for( int i = 0; i < 16; i++ )
+	{
+		for( int j = 0; j < 3; j++ )
+		{
+			minColor[j] = Min( minColor[j], ( float )block[i][j] );
+			maxColor[j] = Max( maxColor[j], ( float )block[i][j] );
+		}
+	}
+
+	if( quality != BC_QUALITY_FAST )
+	{
+		float	mean[3] = { 0.0f, 0.0f, 0.0f };
+		float	cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		float	axis[3];
+
+		for( int i = 0; i < 16; i++ )
+		{
+			mean[0] += block[i][0];
+			mean[1] += block[i][1];
+			mean[2] += block[i][2];
+		}
+		for( int j = 0; j < 3; j++ )
+		{
+			mean[j] *= ( 1.0f / 16.0f );
+		}
+		for( int i = 0; i < 16; i++ )
+		{
+			float r = block[i][0] - mean[0];
+			float g = block[i][1] - mean[1];
+			float b = block[i][2] - mean[2];
+			cov[0] += r * r;
+			cov[1] += r * g;
+			cov[2] += r * b;
+			cov[3] += g * g;
+			cov[4] += g * b;
+			cov[5] += b * b;
+		}
+
+		// a few power iterations find the principal axis well enough
+		for( int j = 0; j < 3; j++ )
+		{
+			axis[j] = maxColor[j] - minColor[j];
+		}
+		for( int iter = 0; iter < 4; iter++ )
+		{
+			float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+			float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+			float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+			float m = Max( idMath::Fabs( x ), Max( idMath::Fabs( y ), idMath::Fabs( z ) ) );
+			if( m < 1e-6f )
+			{
+				break;
+			}
+			axis[0] = x / m;
+			axis[1] = y / m;
+			axis[2] = z / m;
+		}
+
+		float	minDot = idMath::INFINITY;
+		float	maxDot = -idMath::INFINITY;
+		for( int i = 0; i < 16; i++ )
+		{
+			float d = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+			if( d < minDot )
+			{
+				minDot = d;
+				minColor[0] = block[i][0];
+				minColor[1] = block[i][1];
+				minColor[2] = block[i][2];
+			}
+			if( d > maxDot )
+			{
+				maxDot = d;
+				maxColor[0] = block[i][0];
+				maxColor[1] = block[i][1];
+				maxColor[2] = block[i][2];
+			}
+		}
+	}
+
+	// pull the end points in a bit so the interpolated colors cover the block better
+	for( int j = 0; j < 3; j++ )
+	{
+		float inset = ( maxColor[j] - minColor[j] ) * ( 1.0f / 16.0f );
+		minColor[j] += inset;
+		maxColor[j] -= inset;
+	}
+
+	int error = R_QuantizeColorEndPoints( block, minColor, maxColor, &c0, &c1, &indices );
+
+	if( quality == BC_QUALITY_HIGH )
+	{
+		// weight of the first end point for each index
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		for( int iter = 0; iter < 2 && error > 0; iter++ )
+		{
+			float	aa = 0.0f, bb = 0.0f, ab = 0.0f;
+			float	ax[3] = { 0.0f, 0.0f, 0.0f };
+			float	bx[3] = { 0.0f, 0.0f, 0.0f };
+
+			for( int i = 0; i < 16; i++ )
+			{
+				float alpha = weights[( indices >> ( i * 2 ) ) & 3];
+				float beta = 1.0f - alpha;
+				aa += alpha * alpha;
+				bb += beta * beta;
+				ab += alpha * beta;
+				for( int j = 0; j < 3; j++ )
+				{
+					ax[j] += alpha * block[i][j];
+					bx[j] += beta * block[i][j];
+				}
+			}
+
+			float det = aa * bb - ab * ab;
+			if( idMath::Fabs( det ) < 1e-6f )
+			{
+				break;
+			}
+
+			float	newMax[3], newMin[3];
+			int		newC0, newC1;
+			unsigned int newIndices;
+
+			for( int j = 0; j < 3; j++ )
+			{
+				newMax[j] = ( ax[j] * bb - bx[j] * ab ) / det;
+				newMin[j] = ( bx[j] * aa - ax[j] * ab ) / det;
+			}
+			int newError = R_QuantizeColorEndPoints( block, newMin, newMax, &newC0, &newC1, &newIndices );
+			if( newError >= error )
+			{
+				break;
+			}
+			error = newError;
+			c0 = newC0;
+			c1 = newC1;
+			indices = newIndices;
+		}
+	}
+
+	out[0] = c0 & 255;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 255;
+	out[3] = c1 >> 8;
+	out[4] = indices & 255;
+	out[5] = ( indices >> 8 ) & 255;
+	out[6] = ( indices >> 16 ) & 255;
+	out[7] = indices >> 24;
+}
+
+/*
+================
+R_EncodeChannelIndices
+
+encodes the single channel block with the end points a0 and a1, returns the total squared error
+================
+*/
+static int R_EncodeChannelIndices( const byte values[16], int a0, int a1, byte* out )
+{
+	int		palette[8];
+	int		error = 0;
+	int		bits[2] = { 0, 0 };
+
+	palette[0] = a0;
+	palette[1] = a1;
+	if( a0 > a1 )
+	{
+		for( int i = 1; i < 7; i++ )
+		{
+			palette[i + 1] = ( ( 7 - i ) * a0 + i * a1 ) / 7;
+		}
+	}
+	else
+	{
+		for( int i = 1; i < 5; i++ )
+		{
+			palette[i + 1] = ( ( 5 - i ) * a0 + i * a1 ) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	for( int i = 0; i < 16; i++ )
+	{
+		int best = 0;
+		int bestError = 0x7fffffff;
+		for( int j = 0; j < 8; j++ )
+		{
+			int d = values[i] - palette[j];
+			if( d * d < bestError )
+			{
+				bestError = d * d;
+				best = j;
+			}
+		}
+		bits[i >> 3] |= best << ( ( i & 7 ) * 3 );
+		error += bestError;
+	}
+
+	if( out )
+	{
+		out[0] = a0;
+		out[1] = a1;
+		out[2] = bits[0] & 255;
+		out[3] = ( bits[0] >> 8 ) & 255;
+		out[4] = bits[0] >> 16;
+		out[5] = bits[1] & 255;
+		out[6] = ( bits[1] >> 8 ) & 255;
+		out[7] = bits[1] >> 16;
+	}
+	return error;
+}
+
+/*
+================
+R_EncodeChannelBlock
+
+the alpha block of BC3 and each half of a BC5 block, BC_QUALITY_NORMAL also tries the
+six value mode with exact 0 and 255, BC_QUALITY_HIGH searches for tighter end points
+================
+*/
+static void R_EncodeChannelBlock( const byte block[16][4], int channel, blockQuality_t quality, byte* out )
+{
+	byte	values[16];
+	int		minValue = 255, maxValue = 0;
+	int		minInner = 255, maxInner = 0;
+
+	for( int i = 0; i < 16; i++ )
+	{
+		values[i] = block[i][channel];
+		minValue = Min( minValue, ( int )values[i] );
+		maxValue = Max( maxValue, ( int )values[i] );
+		if( values[i] != 0 && values[i] != 255 )
+		{
+			minInner = Min( minInner, ( int )values[i] );
+			maxInner = Max( maxInner, ( int )values[i] );
+		}
+	}
+
+	int bestA0 = maxValue;
+	int bestA1 = minValue;
+	if( quality == BC_QUALITY_FAST || minValue == maxValue )
+	{
+		R_EncodeChannelIndices( values, bestA0, bestA1, out );
+		return;
+	}
+
+	int bestError = R_EncodeChannelIndices( values, bestA0, bestA1, NULL );
+
+	// the six value mode keeps 0 and 255 exact
+	if( minInner <= maxInner )
+	{
+		int error = R_EncodeChannelIndices( values, minInner, maxInner, NULL );
+		if( error < bestError )
+		{
+			bestError = error;
+			bestA0 = minInner;
+			bestA1 = maxInner;
+		}
+	}
+
+	if( quality == BC_QUALITY_HIGH )
+	{
+		static const int range = 4;
+		for( int a0 = maxValue; a0 >= Max( maxValue - range, minValue + 1 ); a0-- )
+		{
+			for( int a1 = minValue; a1 <= Min( minValue + range, a0 - 1 ); a1++ )
+			{
+				int error = R_EncodeChannelIndices( values, a0, a1, NULL );
+				if( error < bestError )
+				{
+					bestError = error;
+					bestA0 = a0;
+					bestA1 = a1;
+				}
+			}
+		}
+	}
+
+	R_EncodeChannelIndices( values, bestA0, bestA1, out );
+}
+
+/*
+================
+R_BlockCompressedSize
+================
+*/
+int R_BlockCompressedSize( int width, int height, blockFormat_t format )
+{
+	return ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * ( format == BC_FORMAT_BC1 ? 8 : 16 );
+}
+
+/*
+================
+R_BlockCompressRows
+
+compresses the rows of blocks from firstRow up to lastRow
+================
+*/
+static void R_BlockCompressRows( const byte* rgba, int width, int height, byte* out, blockFormat_t format, blockQuality_t quality, int firstRow, int lastRow )
+{
+	int		blocksWide = ( width + 3 ) / 4;
+	int		blockBytes = ( format == BC_FORMAT_BC1 ) ? 8 : 16;
+	byte	block[16][4];
+
+	for( int by = firstRow; by < lastRow; by++ )
+	{
+		byte* outBlock = out + by * blocksWide * blockBytes;
+		for( int bx = 0; bx < blocksWide; bx++, outBlock += blockBytes )
+		{
+			R_GetBlockTexels( rgba, width, height, bx, by, block );
+			switch( format )
+			{
+				case BC_FORMAT_BC1:
+					R_EncodeColorBlock( block, quality, outBlock );
+					break;
+				case BC_FORMAT_BC3:
+					R_EncodeChannelBlock( block, 3, quality, outBlock );
+					R_EncodeColorBlock( block, quality, outBlock + 8 );
+					break;
+				case BC_FORMAT_BC5:
+					R_EncodeChannelBlock( block, 0, quality, outBlock );
+					R_EncodeChannelBlock( block, 1, quality, outBlock + 8 );
+					break;
+			}
+		}
+	}
+}
+
+/*
+================
+R_BlockCompressJob
+================
+*/
+typedef struct
+{
+	const byte*		rgba;
+	int				width;
+	int				height;
+	byte*			out;
+	blockFormat_t	format;
+	blockQuality_t	quality;
+	int				firstRow;
+	int				lastRow;
+} blockCompressJob_t;
+
+static void R_BlockCompressJob( void* parms )
+{
+	blockCompressJob_t* job = ( blockCompressJob_t* )parms;
+
+	R_BlockCompressRows( job->rgba, job->width, job->height, job->out, job->format, job->quality, job->firstRow, job->lastRow );
+}
+
+/*
+================
+R_BlockCompress
+
+Compresses the RGBA image into R_BlockCompressedSize bytes of out, splitting
+the rows of blocks across the job threads. The output only depends on the
+pixels, the format and the quality, not on the number of threads.
+================
+*/
+void R_BlockCompress( const byte* rgba, int width, int height, byte* out, blockFormat_t format, blockQuality_t quality )
+{
+	const int maxJobs = ( MAX_JOB_THREADS + 1 ) * 4;
+	blockCompressJob_t	jobs[maxJobs];
+
+	int rows = ( height + 3 ) / 4;
+	int numJobs = Min( rows, ( Sys_NumJobThreads() + 1 ) * 4 );
+	if( numJobs <= 1 )
+	{
+		R_BlockCompressRows( rgba, width, height, out, format, quality, 0, rows );
+		return;
+	}
+
+	for( int i = 0; i < numJobs; i++ )
+	{
+		jobs[i].rgba = rgba;
+		jobs[i].width = width;
+		jobs[i].height = height;
+		jobs[i].out = out;
+		jobs[i].format = format;
+		jobs[i].quality = quality;
+		jobs[i].firstRow = rows * i / numJobs;
+		jobs[i].lastRow = rows * ( i + 1 ) / numJobs;
+	}
+	Sys_RunJobs( R_BlockCompressJob, jobs, sizeof( jobs[0] ), numJobs );
+}
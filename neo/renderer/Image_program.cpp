@@ -57,6 +57,10 @@ Manager
 
 #include "tr_local.h"
 
+#ifdef ID_IMAGE_SSE2
+	#include <emmintrin.h>
+#endif
+
 /*
 
 Anywhere that an image name is used (diffusemaps, bumpmaps, specularmaps, lights, etc),
@@ -67,6 +71,129 @@ composition, to be automatically handled in a way that supports timestamped relo
 
 */
 
+#ifdef ID_IMAGE_SSE2
+
+/*
+=================
+R_LoadBytes4_SSE2
+
+four consecutive bytes widened to 32 bit lanes
+=================
+*/
+static ID_INLINE __m128i R_LoadBytes4_SSE2( const byte* p )
+{
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( *( const int* )p ), zero ), zero );
+}
+
+/*
+=================
+R_Channel_SSE2
+
+one channel of four RGBA texels in 32 bit lanes
+=================
+*/
+static ID_INLINE __m128i R_Channel_SSE2( __m128i texels, int channel )
+{
+	return _mm_and_si128( _mm_srli_epi32( texels, channel * 8 ), _mm_set1_epi32( 0xFF ) );
+}
+
+/*
+=================
+R_AverageRGB_SSE2
+
+( r + g + b ) / 3 of four RGBA texels, x / 3 == ( x * 0xAAAB ) >> 17 for all
+sums of three bytes so this matches the integer divide exactly
+=================
+*/
+static ID_INLINE __m128i R_AverageRGB_SSE2( __m128i texels )
+{
+	__m128i sum = _mm_add_epi32( R_Channel_SSE2( texels, 0 ), R_Channel_SSE2( texels, 1 ) );
+	sum = _mm_add_epi32( sum, R_Channel_SSE2( texels, 2 ) );
+	return _mm_srli_epi32( _mm_mulhi_epu16( sum, _mm_set1_epi32( 0xAAAB ) ), 1 );
+}
+
+/*
+=================
+R_RSqrt_SSE2
+
+the same approximation as idMath::RSqrt
+=================
+*/
+static ID_INLINE __m128 R_RSqrt_SSE2( __m128 x )
+{
+	__m128 y = _mm_mul_ps( x, _mm_set1_ps( 0.5f ) );
+	__m128 r = _mm_castsi128_ps( _mm_sub_epi32( _mm_set1_epi32( 0x5f3759df ), _mm_srai_epi32( _mm_castps_si128( x ), 1 ) ) );
+	return _mm_mul_ps( r, _mm_sub_ps( _mm_set1_ps( 1.5f ), _mm_mul_ps( _mm_mul_ps( r, r ), y ) ) );
+}
+
+/*
+=================
+R_InvLength_SSE2
+
+1 / length of four vectors, 0 for zero length vectors
+=================
+*/
+static ID_INLINE __m128 R_InvLength_SSE2( __m128 x, __m128 y, __m128 z )
+{
+	__m128 sqr = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+	__m128 inv = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( sqr ) );
+	return _mm_and_ps( inv, _mm_cmpgt_ps( sqr, _mm_setzero_ps() ) );
+}
+
+/*
+=================
+R_PackNormals_SSE2
+
+( byte )( n * 127 + 128 ) for four normals, alpha comes from the high byte of alpha
+=================
+*/
+static ID_INLINE __m128i R_PackNormals_SSE2( __m128 x, __m128 y, __m128 z, __m128i alpha )
+{
+	const __m128 scale = _mm_set1_ps( 127.0f );
+	const __m128 bias = _mm_set1_ps( 128.0f );
+	__m128i r = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( x, scale ), bias ) );
+	__m128i g = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( y, scale ), bias ) );
+	__m128i b = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( z, scale ), bias ) );
+	__m128i texels = _mm_or_si128( r, _mm_slli_epi32( g, 8 ) );
+	texels = _mm_or_si128( texels, _mm_slli_epi32( b, 16 ) );
+	return _mm_or_si128( texels, _mm_and_si128( alpha, _mm_set1_epi32( 0xFF000000 ) ) );
+}
+
+/*
+=================
+R_UnpackNormal_SSE2
+
+( c - 128 ) / 127.0 the way the scalar code does it, in double and rounded to float
+=================
+*/
+static ID_INLINE __m128 R_UnpackNormal_SSE2( __m128i c )
+{
+	const __m128d div = _mm_set1_pd( 127.0 );
+	c = _mm_sub_epi32( c, _mm_set1_epi32( 128 ) );
+	__m128 lo = _mm_cvtpd_ps( _mm_div_pd( _mm_cvtepi32_pd( c ), div ) );
+	__m128 hi = _mm_cvtpd_ps( _mm_div_pd( _mm_cvtepi32_pd( _mm_srli_si128( c, 8 ) ), div ) );
+	return _mm_movelh_ps( lo, hi );
+}
+
+/*
+=================
+R_AddUnpackedNormal_SSE2
+
+n += ( c - 128 ) / 127.0 with the float to double promotion of the scalar code
+=================
+*/
+static ID_INLINE __m128 R_AddUnpackedNormal_SSE2( __m128 n, __m128i c )
+{
+	const __m128d div = _mm_set1_pd( 127.0 );
+	c = _mm_sub_epi32( c, _mm_set1_epi32( 128 ) );
+	__m128d lo = _mm_add_pd( _mm_cvtps_pd( n ), _mm_div_pd( _mm_cvtepi32_pd( c ), div ) );
+	__m128d hi = _mm_add_pd( _mm_cvtps_pd( _mm_movehl_ps( n, n ) ), _mm_div_pd( _mm_cvtepi32_pd( _mm_srli_si128( c, 8 ) ), div ) );
+	return _mm_movelh_ps( _mm_cvtpd_ps( lo ), _mm_cvtpd_ps( hi ) );
+}
+
+#endif
+
 /*
 =================
 R_HeightmapToNormalMap
@@ -74,19 +201,39 @@ R_HeightmapToNormalMap
 it is not possible to convert a heightmap into a normal map
 properly without knowing the texture coordinate stretching.
 We can assume constant and equal ST vectors for walls, but not for characters.
+
+The SSE2 path uses the same RSqrt approximation and operation order, so it
+matches the scalar loop whenever that is compiled to SSE float math.
 =================
 */
 static void R_HeightmapToNormalMap( byte* data, int width, int height, float scale )
 {
 	int		i, j;
 	byte*	depth;
+	bool	useSIMD = false;
+
+#ifdef ID_IMAGE_SSE2
+	useSIMD = globalImages->image_useSIMD.GetBool();
+#endif
 
 	scale = scale / 256;
 
 	// copy and convert to grey scale
 	j = width * height;
 	depth = ( byte* )R_StaticAlloc( j );
-	for( i = 0 ; i < j ; i++ )
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( useSIMD )
+	{
+		for( ; i + 4 <= j ; i += 4 )
+		{
+			__m128i grey = R_AverageRGB_SSE2( _mm_loadu_si128( ( const __m128i* )( data + i * 4 ) ) );
+			grey = _mm_packs_epi32( grey, grey );
+			*( int* )( depth + i ) = _mm_cvtsi128_si32( _mm_packus_epi16( grey, grey ) );
+		}
+	}
+#endif
+	for( ; i < j ; i++ )
 	{
 		depth[i] = ( data[i * 4] + data[i * 4 + 1] + data[i * 4 + 2] ) / 3;
 	}
@@ -94,7 +241,47 @@ static void R_HeightmapToNormalMap( byte* data, int width, int height, float sca
 	idVec3	dir, dir2;
 	for( i = 0 ; i < height ; i++ )
 	{
-		for( j = 0 ; j < width ; j++ )
+		j = 0;
+#ifdef ID_IMAGE_SSE2
+		if( useSIMD )
+		{
+			// four texels at a time, stopping short of the wrap at the end of the row
+			const byte* row0 = depth + i * width;
+			const byte* row1 = depth + ( ( i + 1 ) & ( height - 1 ) ) * width;
+			const __m128 s = _mm_set1_ps( scale );
+			const __m128 one = _mm_set1_ps( 1.0f );
+
+			for( ; j + 4 < width ; j += 4 )
+			{
+				__m128i d1 = R_LoadBytes4_SSE2( row0 + j );
+				__m128i d2 = R_LoadBytes4_SSE2( row0 + j + 1 );
+				__m128i d3 = R_LoadBytes4_SSE2( row1 + j );
+				__m128i d4 = R_LoadBytes4_SSE2( row1 + j + 1 );
+
+				__m128 x1 = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( d1, d2 ) ), s );
+				__m128 y1 = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( d1, d3 ) ), s );
+				__m128 inv = R_RSqrt_SSE2( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x1, x1 ), _mm_mul_ps( y1, y1 ) ), one ) );
+				x1 = _mm_mul_ps( x1, inv );
+				y1 = _mm_mul_ps( y1, inv );
+				__m128 z1 = inv;
+
+				__m128 x2 = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( d3, d4 ) ), s );
+				__m128 y2 = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( d1, d3 ) ), s );
+				inv = R_RSqrt_SSE2( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x2, x2 ), _mm_mul_ps( y2, y2 ) ), one ) );
+				x1 = _mm_add_ps( x1, _mm_mul_ps( x2, inv ) );
+				y1 = _mm_add_ps( y1, _mm_mul_ps( y2, inv ) );
+				z1 = _mm_add_ps( z1, inv );
+
+				inv = R_RSqrt_SSE2( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x1, x1 ), _mm_mul_ps( y1, y1 ) ), _mm_mul_ps( z1, z1 ) ) );
+				x1 = _mm_mul_ps( x1, inv );
+				y1 = _mm_mul_ps( y1, inv );
+				z1 = _mm_mul_ps( z1, inv );
+
+				_mm_storeu_si128( ( __m128i* )( data + ( i * width + j ) * 4 ), R_PackNormals_SSE2( x1, y1, z1, _mm_set1_epi32( -1 ) ) );
+			}
+		}
+#endif
+		for( ; j < width ; j++ )
 		{
 			int		d1, d2, d3, d4;
 			int		a1, a2, a3, a4;
@@ -151,7 +338,31 @@ static void R_ImageScale( byte* data, int width, int height, float scale[4] )
 
 	c = width * height * 4;
 
-	for( i = 0 ; i < c ; i++ )
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i low = _mm_set1_epi32( 0xFF );
+		const __m128 s = _mm_loadu_ps( scale );
+
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i p = _mm_loadu_si128( ( const __m128i* )( data + i ) );
+			__m128i lo = _mm_unpacklo_epi8( p, zero );
+			__m128i hi = _mm_unpackhi_epi8( p, zero );
+
+			// the ( byte ) cast keeps the low eight bits of the truncated product
+			__m128i v0 = _mm_and_si128( _mm_cvttps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ), s ) ), low );
+			__m128i v1 = _mm_and_si128( _mm_cvttps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ), s ) ), low );
+			__m128i v2 = _mm_and_si128( _mm_cvttps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ), s ) ), low );
+			__m128i v3 = _mm_and_si128( _mm_cvttps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ), s ) ), low );
+
+			_mm_storeu_si128( ( __m128i* )( data + i ), _mm_packus_epi16( _mm_packs_epi32( v0, v1 ), _mm_packs_epi32( v2, v3 ) ) );
+		}
+	}
+#endif
+	for( ; i < c ; i++ )
 	{
 		j = ( byte )( data[i] * scale[i & 3] );
 		if( j < 0 )
@@ -178,7 +389,20 @@ static void R_InvertAlpha( byte* data, int width, int height )
 
 	c = width * height * 4;
 
-	for( i = 0 ; i < c ; i += 4 )
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		// 255 - x is x ^ 255 for a byte
+		const __m128i mask = _mm_set1_epi32( 0xFF000000 );
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i p = _mm_loadu_si128( ( const __m128i* )( data + i ) );
+			_mm_storeu_si128( ( __m128i* )( data + i ), _mm_xor_si128( p, mask ) );
+		}
+	}
+#endif
+	for( ; i < c ; i += 4 )
 	{
 		data[i + 3] = 255 - data[i + 3];
 	}
@@ -196,7 +420,19 @@ static void R_InvertColor( byte* data, int width, int height )
 
 	c = width * height * 4;
 
-	for( i = 0 ; i < c ; i += 4 )
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		const __m128i mask = _mm_set1_epi32( 0x00FFFFFF );
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i p = _mm_loadu_si128( ( const __m128i* )( data + i ) );
+			_mm_storeu_si128( ( __m128i* )( data + i ), _mm_xor_si128( p, mask ) );
+		}
+	}
+#endif
+	for( ; i < c ; i += 4 )
 	{
 		data[i + 0] = 255 - data[i + 0];
 		data[i + 1] = 255 - data[i + 1];
@@ -204,11 +440,84 @@ static void R_InvertColor( byte* data, int width, int height )
 	}
 }
 
+/*
+=================
+R_MakeIntensity
+
+copy red to green, blue, and alpha
+=================
+*/
+static void R_MakeIntensity( byte* data, int width, int height )
+{
+	int		i;
+	int		c;
+
+	c = width * height * 4;
+
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		const __m128i low = _mm_set1_epi32( 0xFF );
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i p = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )( data + i ) ), low );
+			p = _mm_or_si128( p, _mm_slli_epi32( p, 8 ) );
+			p = _mm_or_si128( p, _mm_slli_epi32( p, 16 ) );
+			_mm_storeu_si128( ( __m128i* )( data + i ), p );
+		}
+	}
+#endif
+	for( ; i < c ; i += 4 )
+	{
+		data[i + 1] =
+			data[i + 2] =
+				data[i + 3] = data[i];
+	}
+}
+
+/*
+=================
+R_MakeAlpha
+
+average RGB into alpha, then set RGB to white
+=================
+*/
+static void R_MakeAlpha( byte* data, int width, int height )
+{
+	int		i;
+	int		c;
+
+	c = width * height * 4;
+
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		const __m128i white = _mm_set1_epi32( 0x00FFFFFF );
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i alpha = R_AverageRGB_SSE2( _mm_loadu_si128( ( const __m128i* )( data + i ) ) );
+			_mm_storeu_si128( ( __m128i* )( data + i ), _mm_or_si128( _mm_slli_epi32( alpha, 24 ), white ) );
+		}
+	}
+#endif
+	for( ; i < c ; i += 4 )
+	{
+		data[i + 3] = ( data[i + 0] + data[i + 1] + data[i + 2] ) / 3;
+		data[i + 0] =
+			data[i + 1] =
+				data[i + 2] = 255;
+	}
+}
+
 
 /*
 ===================
 R_AddNormalMaps
 
+The SSE2 path does the renormalize with a full precision square root instead
+of idMath::InvSqrt, so a channel can come out one lower or higher.
 ===================
 */
 static void R_AddNormalMaps( byte* data1, int width1, int height1, byte* data2, int width2, int height2 )
@@ -230,7 +539,39 @@ static void R_AddNormalMaps( byte* data1, int width1, int height1, byte* data2,
 	// add the normal change from the second and renormalize
 	for( i = 0 ; i < height1 ; i++ )
 	{
-		for( j = 0 ; j < width1 ; j++ )
+		j = 0;
+#ifdef ID_IMAGE_SSE2
+		if( globalImages->image_useSIMD.GetBool() )
+		{
+			const __m128 one = _mm_set1_ps( 1.0f );
+
+			for( ; j + 4 <= width1 ; j += 4 )
+			{
+				byte* d1 = data1 + ( i * width1 + j ) * 4;
+				__m128i t1 = _mm_loadu_si128( ( const __m128i* )d1 );
+				__m128i t2 = _mm_loadu_si128( ( const __m128i* )( data2 + ( i * width1 + j ) * 4 ) );
+
+				__m128 x = R_UnpackNormal_SSE2( R_Channel_SSE2( t1, 0 ) );
+				__m128 y = R_UnpackNormal_SSE2( R_Channel_SSE2( t1, 1 ) );
+				__m128 z = R_UnpackNormal_SSE2( R_Channel_SSE2( t1, 2 ) );
+
+				// There are some normal maps that blend to 0,0,0 at the edges
+				// this screws up compression, so we try to correct that here by instead fading it to 0,0,1
+				__m128 sqr = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+				__m128 fade = _mm_cmplt_ps( _mm_mul_ps( sqr, R_RSqrt_SSE2( sqr ) ), one );
+				__m128 fadeZ = _mm_sub_ps( _mm_sub_ps( one, _mm_mul_ps( x, x ) ), _mm_mul_ps( y, y ) );
+				fadeZ = _mm_sqrt_ps( _mm_max_ps( fadeZ, _mm_setzero_ps() ) );
+				z = _mm_or_ps( _mm_and_ps( fade, fadeZ ), _mm_andnot_ps( fade, z ) );
+
+				x = R_AddUnpackedNormal_SSE2( x, R_Channel_SSE2( t2, 0 ) );
+				y = R_AddUnpackedNormal_SSE2( y, R_Channel_SSE2( t2, 1 ) );
+
+				__m128 inv = R_InvLength_SSE2( x, y, z );
+				_mm_storeu_si128( ( __m128i* )d1, R_PackNormals_SSE2( _mm_mul_ps( x, inv ), _mm_mul_ps( y, inv ), _mm_mul_ps( z, inv ), _mm_set1_epi32( -1 ) ) );
+			}
+		}
+#endif
+		for( ; j < width1 ; j++ )
 		{
 			byte*	d1, *d2;
 			idVec3	n;
@@ -245,10 +586,11 @@ static void R_AddNormalMaps( byte* data1, int width1, int height1, byte* data2,
 
 			// There are some normal maps that blend to 0,0,0 at the edges
 			// this screws up compression, so we try to correct that here by instead fading it to 0,0,1
+			// LengthFast can be just under 1 when the real length isn't, so don't take the root of a negative number
 			len = n.LengthFast();
 			if( len < 1.0f )
 			{
-				n[2] = idMath::Sqrt( 1.0 - ( n[0] * n[0] ) - ( n[1] * n[1] ) );
+				n[2] = idMath::Sqrt( Max( 1.0 - ( n[0] * n[0] ) - ( n[1] * n[1] ), 0.0 ) );
 			}
 
 			n[0] += ( d2[0] - 128 ) / 127.0;
@@ -268,17 +610,59 @@ static void R_AddNormalMaps( byte* data1, int width1, int height1, byte* data2,
 	}
 }
 
+/*
+================
+R_SmoothNormal
+================
+*/
+static void R_SmoothNormal( const byte* orig, byte* data, int width, int height, const float factors[3][3], int i, int j )
+{
+	idVec3	normal;
+	byte*	out;
+
+	normal = vec3_origin;
+	for( int k = -1 ; k < 2 ; k++ )
+	{
+		for( int l = -1 ; l < 2 ; l++ )
+		{
+			const byte*	in;
+
+			in = orig + ( ( ( j + l ) & ( height - 1 ) ) * width + ( ( i + k ) & ( width - 1 ) ) ) * 4;
+
+			// ignore 000 and -1 -1 -1
+			if( in[0] == 0 && in[1] == 0 && in[2] == 0 )
+			{
+				continue;
+			}
+			if( in[0] == 128 && in[1] == 128 && in[2] == 128 )
+			{
+				continue;
+			}
+
+			normal[0] += factors[k + 1][l + 1] * ( in[0] - 128 );
+			normal[1] += factors[k + 1][l + 1] * ( in[1] - 128 );
+			normal[2] += factors[k + 1][l + 1] * ( in[2] - 128 );
+		}
+	}
+	normal.Normalize();
+	out = data + ( j * width + i ) * 4;
+	out[0] = ( byte )( 128 + 127 * normal[0] );
+	out[1] = ( byte )( 128 + 127 * normal[1] );
+	out[2] = ( byte )( 128 + 127 * normal[2] );
+}
+
 /*
 ================
 R_SmoothNormalMap
+
+The sums are exact in either path, but the SSE2 path normalizes with a full
+precision square root, so a channel can come out one lower or higher.
 ================
 */
 static void R_SmoothNormalMap( byte* data, int width, int height )
 {
 	byte*	orig;
-	int		i, j, k, l;
-	idVec3	normal;
-	byte*	out;
+	int		i, j;
 	static float	factors[3][3] =
 	{
 		{ 1, 1, 1 },
@@ -289,39 +673,54 @@ static void R_SmoothNormalMap( byte* data, int width, int height )
 	orig = ( byte* )R_StaticAlloc( width * height * 4 );
 	memcpy( orig, data, width * height * 4 );
 
-	for( i = 0 ; i < width ; i++ )
+	// every texel only reads orig, so walk the rows for the cache
+	for( j = 0 ; j < height ; j++ )
 	{
-		for( j = 0 ; j < height ; j++ )
+		i = 0;
+#ifdef ID_IMAGE_SSE2
+		if( globalImages->image_useSIMD.GetBool() && width > 5 )
 		{
-			normal = vec3_origin;
-			for( k = -1 ; k < 2 ; k++ )
+			const __m128i rgb = _mm_set1_epi32( 0x00FFFFFF );
+			const __m128i grey = _mm_set1_epi32( 0x00808080 );
+			const __m128i bias = _mm_set1_epi32( 128 );
+
+			// the first and last texel wrap around, leave them to the scalar loop below
+			for( i = 1 ; i + 4 < width ; i += 4 )
 			{
-				for( l = -1 ; l < 2 ; l++ )
+				__m128 x = _mm_setzero_ps();
+				__m128 y = _mm_setzero_ps();
+				__m128 z = _mm_setzero_ps();
+
+				for( int k = -1 ; k < 2 ; k++ )
 				{
-					byte*	in;
+					for( int l = -1 ; l < 2 ; l++ )
+					{
+						__m128i in = _mm_loadu_si128( ( const __m128i* )( orig + ( ( ( j + l ) & ( height - 1 ) ) * width + i + k ) * 4 ) );
 
-					in = orig + ( ( ( j + l ) & ( height - 1 ) ) * width + ( ( i + k ) & ( width - 1 ) ) ) * 4;
+						// ignore 000 and -1 -1 -1
+						__m128i color = _mm_and_si128( in, rgb );
+						__m128i skip = _mm_or_si128( _mm_cmpeq_epi32( color, _mm_setzero_si128() ), _mm_cmpeq_epi32( color, grey ) );
+						__m128 keep = _mm_castsi128_ps( _mm_andnot_si128( skip, _mm_set1_epi32( -1 ) ) );
+						__m128 factor = _mm_and_ps( _mm_set1_ps( factors[k + 1][l + 1] ), keep );
 
-					// ignore 000 and -1 -1 -1
-					if( in[0] == 0 && in[1] == 0 && in[2] == 0 )
-					{
-						continue;
+						x = _mm_add_ps( x, _mm_mul_ps( factor, _mm_cvtepi32_ps( _mm_sub_epi32( R_Channel_SSE2( in, 0 ), bias ) ) ) );
+						y = _mm_add_ps( y, _mm_mul_ps( factor, _mm_cvtepi32_ps( _mm_sub_epi32( R_Channel_SSE2( in, 1 ), bias ) ) ) );
+						z = _mm_add_ps( z, _mm_mul_ps( factor, _mm_cvtepi32_ps( _mm_sub_epi32( R_Channel_SSE2( in, 2 ), bias ) ) ) );
 					}
-					if( in[0] == 128 && in[1] == 128 && in[2] == 128 )
-					{
-						continue;
-					}
-
-					normal[0] += factors[k + 1][l + 1] * ( in[0] - 128 );
-					normal[1] += factors[k + 1][l + 1] * ( in[1] - 128 );
-					normal[2] += factors[k + 1][l + 1] * ( in[2] - 128 );
 				}
+
+				__m128 inv = R_InvLength_SSE2( x, y, z );
+				byte* out = data + ( j * width + i ) * 4;
+				__m128i alpha = _mm_loadu_si128( ( const __m128i* )out );
+				_mm_storeu_si128( ( __m128i* )out, R_PackNormals_SSE2( _mm_mul_ps( x, inv ), _mm_mul_ps( y, inv ), _mm_mul_ps( z, inv ), alpha ) );
 			}
-			normal.Normalize();
-			out = data + ( j * width + i ) * 4;
-			out[0] = ( byte )( 128 + 127 * normal[0] );
-			out[1] = ( byte )( 128 + 127 * normal[1] );
-			out[2] = ( byte )( 128 + 127 * normal[2] );
+
+			R_SmoothNormal( orig, data, width, height, factors, 0, j );
+		}
+#endif
+		for( ; i < width ; i++ )
+		{
+			R_SmoothNormal( orig, data, width, height, factors, i, j );
 		}
 	}
 
@@ -355,7 +754,19 @@ static void R_ImageAdd( byte* data1, int width1, int height1, byte* data2, int w
 
 	c = width1 * height1 * 4;
 
-	for( i = 0 ; i < c ; i++ )
+	i = 0;
+#ifdef ID_IMAGE_SSE2
+	if( globalImages->image_useSIMD.GetBool() )
+	{
+		for( ; i + 16 <= c ; i += 16 )
+		{
+			__m128i p1 = _mm_loadu_si128( ( const __m128i* )( data1 + i ) );
+			__m128i p2 = _mm_loadu_si128( ( const __m128i* )( data2 + i ) );
+			_mm_storeu_si128( ( __m128i* )( data1 + i ), _mm_adds_epu8( p1, p2 ) );
+		}
+	}
+#endif
+	for( ; i < c ; i++ )
 	{
 		j = data1[i] + data2[i];
 		if( j > 255 )
@@ -372,8 +783,10 @@ static void R_ImageAdd( byte* data1, int width1, int height1, byte* data2, int w
 }
 
 
-// we build a canonical token form of the image program here
+// we build a canonical token form of the image program here, only when parsing
+// past a program, loading happens on job threads and must not touch the buffer
 static char parseBuffer[MAX_IMAGE_NAME];
+static bool parseBufferActive = false;
 
 /*
 ===================
@@ -382,6 +795,10 @@ AppendToken
 */
 static void AppendToken( idToken& token )
 {
+	if( !parseBufferActive )
+	{
+		return;
+	}
 	// add a leading space if not at the beginning
 	if( parseBuffer[0] )
 	{
@@ -401,6 +818,10 @@ static void MatchAndAppendToken( idLexer& src, const char* match )
 	{
 		return;
 	}
+	if( !parseBufferActive )
+	{
+		return;
+	}
 	// a matched token won't need a leading space
 	idStr::Append( parseBuffer, MAX_IMAGE_NAME, match );
 }
@@ -412,10 +833,11 @@ R_ParseImageProgram_r
 If pic is NULL, the timestamps will be filled in, but no image will be generated
 If both pic and timestamps are NULL, it will just advance past it, which can be
 used to parse an image program from a text stream.
+If sources is set, the names of the image files used are appended to it instead.
 ===================
 */
 static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* height,
-								   ID_TIME_T* timestamps, textureDepth_t* depth )
+								   ID_TIME_T* timestamps, textureDepth_t* depth, idStrList* sources )
 {
 	idToken		token;
 	float		scale;
@@ -428,7 +850,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		MatchAndAppendToken( src, "(" );
 
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources ) )
 		{
 			return false;
 		}
@@ -460,14 +882,14 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 
 		MatchAndAppendToken( src, "(" );
 
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources ) )
 		{
 			return false;
 		}
 
 		MatchAndAppendToken( src, "," );
 
-		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth, sources ) )
 		{
 			if( pic )
 			{
@@ -496,7 +918,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		MatchAndAppendToken( src, "(" );
 
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources ) )
 		{
 			return false;
 		}
@@ -521,14 +943,14 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 
 		MatchAndAppendToken( src, "(" );
 
-		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources ) )
 		{
 			return false;
 		}
 
 		MatchAndAppendToken( src, "," );
 
-		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth ) )
+		if( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth, sources ) )
 		{
 			if( pic )
 			{
@@ -556,7 +978,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources );
 
 		for( i = 0 ; i < 4 ; i++ )
 		{
@@ -580,7 +1002,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources );
 
 		// process it
 		if( pic )
@@ -596,7 +1018,7 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 	{
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources );
 
 		// process it
 		if( pic )
@@ -610,23 +1032,14 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 
 	if( !token.Icmp( "makeIntensity" ) )
 	{
-		int		i;
-
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources );
 
 		// copy red to green, blue, and alpha
 		if( pic )
 		{
-			int		c;
-			c = *width * *height * 4;
-			for( i = 0 ; i < c ; i += 4 )
-			{
-				( *pic )[i + 1] =
-					( *pic )[i + 2] =
-						( *pic )[i + 3] = ( *pic )[i];
-			}
+			R_MakeIntensity( *pic, *width, *height );
 		}
 
 		MatchAndAppendToken( src, ")" );
@@ -635,30 +1048,27 @@ static bool R_ParseImageProgram_r( idLexer& src, byte** pic, int* width, int* he
 
 	if( !token.Icmp( "makeAlpha" ) )
 	{
-		int		i;
-
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sources );
 
 		// average RGB into alpha, then set RGB to white
 		if( pic )
 		{
-			int		c;
-			c = *width * *height * 4;
-			for( i = 0 ; i < c ; i += 4 )
-			{
-				( *pic )[i + 3] = ( ( *pic )[i + 0] + ( *pic )[i + 1] + ( *pic )[i + 2] ) / 3;
-				( *pic )[i + 0] =
-					( *pic )[i + 1] =
-						( *pic )[i + 2] = 255;
-			}
+			R_MakeAlpha( *pic, *width, *height );
 		}
 
 		MatchAndAppendToken( src, ")" );
 		return true;
 	}
 
+	// just gathering the names of the source images
+	if( sources )
+	{
+		sources->Append( token );
+		return true;
+	}
+
 	// if we are just parsing instead of loading or checking,
 	// don't do the R_LoadImage
 	if( !timestamps && !pic )
@@ -699,13 +1109,46 @@ void R_LoadImageProgram( const char* name, byte** pic, int* width, int* height,
 	src.LoadMemory( name, strlen( name ), name );
 	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
 
-	parseBuffer[0] = 0;
+	// the lexer prints its own errors, which a job thread can't do
+	const bool quiet = R_ImageLoadStatusActive();
+	if( quiet )
+	{
+		src.SetFlags( src.GetFlags() | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+	}
+
 	if( timestamps )
 	{
 		*timestamps = 0;
 	}
 
-	R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+	R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, NULL );
+
+	if( quiet && src.HadError() )
+	{
+		R_ImageLoadWarning( "R_LoadImageProgram: bad image program '%s'", name );
+	}
+
+	src.FreeSource();
+}
+
+/*
+===================
+R_ImageProgramSources
+
+Fills in the names of all the image files an image program reads, in the
+order they are loaded, without loading any of them
+===================
+*/
+void R_ImageProgramSources( const char* name, idStrList& sources )
+{
+	idLexer src;
+
+	sources.Clear();
+
+	src.LoadMemory( name, strlen( name ), name );
+	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
+
+	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL, &sources );
 
 	src.FreeSource();
 }
@@ -718,7 +1161,167 @@ R_ParsePastImageProgram
 const char* R_ParsePastImageProgram( idLexer& src )
 {
 	parseBuffer[0] = 0;
-	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL );
+	parseBufferActive = true;
+	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL, NULL );
+	parseBufferActive = false;
 	return parseBuffer;
 }
 
+
+/*
+===================
+R_RunImageKernel
+
+runs one of the image processing kernels on a copy of pic for R_TestImageProcess_f
+===================
+*/
+static const char* imageKernelNames[] =
+{
+	"R_MipMap",
+	"R_ResampleTexture",
+	"heightmap",
+	"addnormals",
+	"smoothnormals",
+	"add",
+	"scale",
+	"invertAlpha",
+	"invertColor",
+	"makeIntensity",
+	"makeAlpha",
+	NULL
+};
+
+static byte* R_RunImageKernel( int kernel, const byte* pic, const byte* pic2, int size, int* outSize )
+{
+	byte*	out;
+	float	scale[4] = { 0.5f, 1.0f, 1.5f, 0.75f };
+
+	*outSize = size * size * 4;
+
+	if( kernel == 0 )
+	{
+		*outSize /= 4;
+		return R_MipMap( pic, size, size, false );
+	}
+	if( kernel == 1 )
+	{
+		*outSize = ( size * 3 / 4 ) * ( size * 3 / 4 ) * 4;
+		return R_ResampleTexture( pic, size, size, size * 3 / 4, size * 3 / 4 );
+	}
+
+	out = ( byte* )R_StaticAlloc( size * size * 4 );
+	memcpy( out, pic, size * size * 4 );
+
+	switch( kernel )
+	{
+		case 2:
+			R_HeightmapToNormalMap( out, size, size, 4.0f );
+			break;
+		case 3:
+			R_AddNormalMaps( out, size, size, ( byte* )pic2, size, size );
+			break;
+		case 4:
+			R_SmoothNormalMap( out, size, size );
+			break;
+		case 5:
+			R_ImageAdd( out, size, size, ( byte* )pic2, size, size );
+			break;
+		case 6:
+			R_ImageScale( out, size, size, scale );
+			break;
+		case 7:
+			R_InvertAlpha( out, size, size );
+			break;
+		case 8:
+			R_InvertColor( out, size, size );
+			break;
+		case 9:
+			R_MakeIntensity( out, size, size );
+			break;
+		case 10:
+			R_MakeAlpha( out, size, size );
+			break;
+	}
+	return out;
+}
+
+/*
+===================
+R_TestImageProcess_f
+
+Times the generic and SIMD versions of the image processing kernels on a
+random image and reports the largest difference between their outputs.
+===================
+*/
+void R_TestImageProcess_f( const idCmdArgs& args )
+{
+#ifndef ID_IMAGE_SSE2
+	common->Printf( "no SIMD image processing kernels compiled in\n" );
+#else
+	const int	numRuns = 4;
+	int			size;
+
+	size = 1024;
+	if( args.Argc() > 1 )
+	{
+		size = MakePowerOfTwo( atoi( args.Argv( 1 ) ) );
+	}
+	size = idMath::ClampInt( 16, 4096, size );
+
+	byte* pic = ( byte* )R_StaticAlloc( size * size * 4 );
+	byte* pic2 = ( byte* )R_StaticAlloc( size * size * 4 );
+	idRandom random( 0 );
+	for( int i = 0 ; i < size * size * 4 ; i++ )
+	{
+		pic[i] = random.RandomInt( 256 );
+		pic2[i] = random.RandomInt( 256 );
+	}
+
+	bool useSIMD = globalImages->image_useSIMD.GetBool();
+
+	common->Printf( "image processing kernels on %i x %i texels:\n", size, size );
+	for( int kernel = 0 ; imageKernelNames[kernel] ; kernel++ )
+	{
+		byte*	results[2];
+		double	best[2];
+		int		outSize;
+
+		for( int simd = 0 ; simd < 2 ; simd++ )
+		{
+			globalImages->image_useSIMD.SetBool( simd != 0 );
+			results[simd] = NULL;
+			best[simd] = idMath::INFINITY;
+			for( int run = 0 ; run < numRuns ; run++ )
+			{
+				idTimer timer;
+
+				if( results[simd] )
+				{
+					R_StaticFree( results[simd] );
+				}
+				timer.Start();
+				results[simd] = R_RunImageKernel( kernel, pic, pic2, size, &outSize );
+				timer.Stop();
+				best[simd] = Min( best[simd], timer.Milliseconds() );
+			}
+		}
+
+		int maxDiff = 0;
+		for( int i = 0 ; i < outSize ; i++ )
+		{
+			maxDiff = Max( maxDiff, abs( results[0][i] - results[1][i] ) );
+		}
+
+		common->Printf( "%-18s generic %8.2f ms  sse2 %8.2f ms  %5.2fx  %s\n", imageKernelNames[kernel], best[0], best[1],
+						best[0] / Max( best[1], 0.001 ), maxDiff ? va( "max difference %i", maxDiff ) : "exact" );
+
+		R_StaticFree( results[0] );
+		R_StaticFree( results[1] );
+	}
+
+	globalImages->image_useSIMD.SetBool( useSIMD );
+
+	R_StaticFree( pic );
+	R_StaticFree( pic2 );
+#endif
+}
@@ -981,6 +981,15 @@ void idInteraction::CreateInteraction( const idRenderModel* model )
 
 	interactionGenerated = false;
 
+	// static world models may have their light tris and shadows in the offline interaction cache
+	const idInteractionCache* cache = NULL;
+	unsigned int lightKey = 0;
+	if( model->IsStaticWorldModel() && entityDef->world->interactionCache.IsLoaded() )
+	{
+		cache = &entityDef->world->interactionCache;
+		lightKey = idInteractionCache::LightKey( lightDef );
+	}
+
 	// check each surface in the model
 	for( int c = 0 ; c < model->NumSurfaces() ; c++ )
 	{
@@ -1025,10 +1034,20 @@ void idInteraction::CreateInteraction( const idRenderModel* model )
 			continue;
 		}
 
+		const cachedInteraction_t* cached = NULL;
+		if( cache )
+		{
+			cached = cache->FindSurface( lightKey, model->Name(), c, tri );
+		}
+
 		// generate a lighted surface and add it
 		if( shader->ReceivesLighting() )
 		{
-			if( tri->ambientViewCount == tr.viewCount )
+			if( cached && cache->CreateLightTris( cached, tri, &sint->lightTris ) )
+			{
+				// loading from the cache is cheap enough that it doesn't need to be deferred
+			}
+			else if( tri->ambientViewCount == tr.viewCount )
 			{
 				sint->lightTris = R_CreateLightTris( entityDef, tri, lightDef, shader, sint->cullInfo );
 			}
@@ -1049,7 +1068,10 @@ void idInteraction::CreateInteraction( const idRenderModel* model )
 			{
 
 				// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
-				sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
+				if( !cached || !cache->CreateShadowTris( cached, &sint->shadowTris ) )
+				{
+					sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
+				}
 				if( sint->shadowTris )
 				{
 					if( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) )
@@ -1515,3 +1537,724 @@ void R_ShowInteractionMemory_f( const idCmdArgs& args )
 	common->Printf( "%5i indexes %5i verts in %5i light tris\n", lightTriIndexes, lightTriVerts, lightTris );
 	common->Printf( "%5i indexes %5i verts in %5i shadow tris\n", shadowTriIndexes, shadowTriVerts, shadowTris );
 }
+
+/*
+===============================================================================
+
+	idInteractionCache
+
+===============================================================================
+*/
+
+// values of the state ints in front of the cached surface data
+#define CACHED_SURFACE_NONE			-1		// not cached, create it as usual
+#define CACHED_SURFACE_EMPTY		0		// cached, but nothing was lit or shadowed
+#define CACHED_SURFACE_ALL			1		// light tris reference all the ambient indexes
+#define CACHED_SURFACE_INDEXES		2		// own list of indexes or shadow volume follows
+
+#define INTERACTION_CACHE_LIGHT_ALL_BACK_FACES	BIT( 0 )
+#define INTERACTION_CACHE_PRECISE_TRIANGLES		BIT( 1 )
+
+/*
+===============
+idInteractionCache::idInteractionCache
+===============
+*/
+idInteractionCache::idInteractionCache()
+{
+	buffer = NULL;
+	bufferSize = 0;
+}
+
+/*
+===============
+idInteractionCache::~idInteractionCache
+===============
+*/
+idInteractionCache::~idInteractionCache()
+{
+	Clear();
+}
+
+/*
+===============
+idInteractionCache::Clear
+===============
+*/
+void idInteractionCache::Clear()
+{
+	if( buffer )
+	{
+		fileSystem->FreeFile( buffer );
+		buffer = NULL;
+	}
+	bufferSize = 0;
+	entries.Clear();
+	entryHash.Free();
+}
+
+/*
+===============
+idInteractionCache::CurrentFlags
+===============
+*/
+int idInteractionCache::CurrentFlags()
+{
+	int flags = 0;
+
+	if( r_lightAllBackFaces.GetBool() )
+	{
+		flags |= INTERACTION_CACHE_LIGHT_ALL_BACK_FACES;
+	}
+	if( r_usePreciseTriangleInteractions.GetBool() )
+	{
+		flags |= INTERACTION_CACHE_PRECISE_TRIANGLES;
+	}
+	return flags;
+}
+
+/*
+===============
+idInteractionCache::LightKey
+===============
+*/
+unsigned int idInteractionCache::LightKey( const idRenderLightLocal* ldef )
+{
+	unsigned long crc;
+	int flags;
+
+	flags = ( ldef->parms.noShadows ? 1 : 0 ) | ( ldef->parms.parallel ? 2 : 0 ) | ( ldef->parms.pointLight ? 4 : 0 );
+
+	CRC32_InitChecksum( crc );
+	CRC32_UpdateChecksum( crc, ldef->globalLightOrigin.ToFloatPtr(), sizeof( ldef->globalLightOrigin ) );
+	CRC32_UpdateChecksum( crc, ldef->frustum, sizeof( ldef->frustum ) );
+	CRC32_UpdateChecksum( crc, &flags, sizeof( flags ) );
+	CRC32_UpdateChecksum( crc, ldef->lightShader->GetName(), idStr::Length( ldef->lightShader->GetName() ) );
+	CRC32_FinishChecksum( crc );
+
+	return ( unsigned int )crc;
+}
+
+/*
+===============
+idInteractionCache::SurfaceKey
+
+Catches a map that was compiled again with the same vertex and index counts.
+This is only done for surfaces found in the cache, and is a lot cheaper than
+creating the interaction it replaces.
+===============
+*/
+unsigned int idInteractionCache::SurfaceKey( const srfTriangles_t* tri )
+{
+	unsigned long crc;
+
+	CRC32_InitChecksum( crc );
+	for( int i = 0; i < tri->numVerts; i++ )
+	{
+		CRC32_UpdateChecksum( crc, tri->verts[i].xyz.ToFloatPtr(), sizeof( tri->verts[i].xyz ) );
+	}
+	CRC32_UpdateChecksum( crc, tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+	CRC32_FinishChecksum( crc );
+
+	return ( unsigned int )crc;
+}
+
+/*
+===============
+R_ReadCacheInt
+===============
+*/
+static bool R_ReadCacheInt( idFile_Memory& f, int& value )
+{
+	return ( f.ReadInt( value ) == sizeof( value ) );
+}
+
+/*
+===============
+R_SkipCacheBytes
+===============
+*/
+static bool R_SkipCacheBytes( idFile_Memory& f, int numBytes )
+{
+	if( numBytes < 0 || numBytes > f.Length() - f.Tell() )
+	{
+		return false;
+	}
+	f.Seek( numBytes, FS_SEEK_CUR );
+	return true;
+}
+
+/*
+===============
+R_CheckCacheIndexes
+
+Makes sure the indexes that follow all reference one of the verts.
+===============
+*/
+static bool R_CheckCacheIndexes( idFile_Memory& f, int numIndexes, int numVerts )
+{
+	glIndex_t	indexes[1024];
+
+	if( numIndexes < 0 || numIndexes > ( f.Length() - f.Tell() ) / ( int )sizeof( glIndex_t ) )
+	{
+		return false;
+	}
+	while( numIndexes > 0 )
+	{
+		int num = Min( numIndexes, ( int )( sizeof( indexes ) / sizeof( indexes[0] ) ) );
+		if( f.Read( indexes, num * sizeof( indexes[0] ) ) != num * ( int )sizeof( indexes[0] ) )
+		{
+			return false;
+		}
+		LittleRevBytes( indexes, sizeof( indexes[0] ), num );
+		for( int i = 0; i < num; i++ )
+		{
+			if( indexes[i] < 0 || ( int )indexes[i] >= numVerts )
+			{
+				return false;
+			}
+		}
+		numIndexes -= num;
+	}
+	return true;
+}
+
+/*
+===============
+R_ReadCacheEntry
+
+Reads the header of a cached surface and skips over its geometry after checking
+it, so the surfaces can later be created without any further checks.
+===============
+*/
+static bool R_ReadCacheEntry( idFile_Memory& f, cachedInteraction_t& entry )
+{
+	int		lightKey;
+	int		length;
+	idStr	modelName;
+	int		state;
+	int		ambientChecksum;
+
+	if( !R_ReadCacheInt( f, lightKey ) || !R_ReadCacheInt( f, length ) )
+	{
+		return false;
+	}
+	if( length < 0 || length > f.Length() - f.Tell() )
+	{
+		return false;
+	}
+	entry.modelNameOffset = f.Tell();
+	entry.modelNameLength = length;
+	modelName.Fill( ' ', length );
+	if( f.Read( &modelName[0], length ) != length )
+	{
+		return false;
+	}
+	if( !R_ReadCacheInt( f, entry.surfaceNum ) || !R_ReadCacheInt( f, entry.ambientNumVerts ) || !R_ReadCacheInt( f, entry.ambientNumIndexes ) ||
+			!R_ReadCacheInt( f, ambientChecksum ) )
+	{
+		return false;
+	}
+	if( entry.ambientNumVerts < 0 || entry.ambientNumIndexes < 0 )
+	{
+		return false;
+	}
+	entry.lightKey = ( unsigned int )lightKey;
+	entry.modelNameKey = idStr::Hash( modelName );
+	entry.ambientChecksum = ( unsigned int )ambientChecksum;
+
+	// light tris
+	entry.lightTrisOffset = f.Tell();
+	if( !R_ReadCacheInt( f, state ) )
+	{
+		return false;
+	}
+	if( state == CACHED_SURFACE_NONE )
+	{
+		entry.lightTrisOffset = -1;
+	}
+	else if( state == CACHED_SURFACE_INDEXES )
+	{
+		int numIndexes;
+
+		if( !R_ReadCacheInt( f, numIndexes ) || !R_CheckCacheIndexes( f, numIndexes, entry.ambientNumVerts ) )
+		{
+			return false;
+		}
+		if( !R_SkipCacheBytes( f, sizeof( idBounds ) ) )
+		{
+			return false;
+		}
+	}
+	else if( state == CACHED_SURFACE_ALL )
+	{
+		if( !R_SkipCacheBytes( f, sizeof( idBounds ) ) )
+		{
+			return false;
+		}
+	}
+	else if( state != CACHED_SURFACE_EMPTY )
+	{
+		return false;
+	}
+
+	// shadow volume
+	entry.shadowTrisOffset = f.Tell();
+	if( !R_ReadCacheInt( f, state ) )
+	{
+		return false;
+	}
+	if( state == CACHED_SURFACE_NONE )
+	{
+		entry.shadowTrisOffset = -1;
+	}
+	else if( state == CACHED_SURFACE_INDEXES )
+	{
+		int numVerts, numShadowIndexesNoCaps, numShadowIndexesNoFrontCaps, numIndexes, shadowCapPlaneBits;
+
+		if( !R_ReadCacheInt( f, numVerts ) || !R_ReadCacheInt( f, numShadowIndexesNoCaps ) || !R_ReadCacheInt( f, numShadowIndexesNoFrontCaps ) ||
+				!R_ReadCacheInt( f, numIndexes ) || !R_ReadCacheInt( f, shadowCapPlaneBits ) )
+		{
+			return false;
+		}
+		if( numVerts < 0 || numVerts > ( f.Length() - f.Tell() ) / ( int )sizeof( shadowCache_t ) )
+		{
+			return false;
+		}
+		if( numShadowIndexesNoCaps < 0 || numShadowIndexesNoCaps > numShadowIndexesNoFrontCaps || numShadowIndexesNoFrontCaps > numIndexes )
+		{
+			return false;
+		}
+		if( !R_SkipCacheBytes( f, numVerts * sizeof( shadowCache_t ) ) || !R_CheckCacheIndexes( f, numIndexes, numVerts ) )
+		{
+			return false;
+		}
+	}
+	else if( state != CACHED_SURFACE_EMPTY )
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+===============
+idInteractionCache::Load
+
+Reads the whole cache file and builds the lookup table, the surfaces
+themselves are only created when an interaction needs them. The whole
+cache is rejected if any entry is truncated or out of range.
+===============
+*/
+bool idInteractionCache::Load( const char* filename )
+{
+	int		ident, version, flags, numEntries;
+
+	Clear();
+
+	bufferSize = fileSystem->ReadFile( filename, ( void** )&buffer );
+	if( bufferSize <= 0 || !buffer )
+	{
+		buffer = NULL;
+		bufferSize = 0;
+		return false;
+	}
+
+	idFile_Memory f( filename, ( const char* )buffer, bufferSize );
+
+	if( !R_ReadCacheInt( f, ident ) || !R_ReadCacheInt( f, version ) || !R_ReadCacheInt( f, flags ) || !R_ReadCacheInt( f, numEntries ) ||
+			ident != INTERACTION_CACHE_ID || version != INTERACTION_CACHE_VERSION )
+	{
+		common->Printf( "idInteractionCache::Load: %s has wrong id or version %i instead of %i\n", filename, version, INTERACTION_CACHE_VERSION );
+		Clear();
+		return false;
+	}
+	if( flags != CurrentFlags() )
+	{
+		common->Printf( "idInteractionCache::Load: %s was generated with different lighting settings, ignored\n", filename );
+		Clear();
+		return false;
+	}
+
+	// every entry takes at least the model name length, four ints, a checksum and two states
+	if( numEntries < 0 || numEntries > ( f.Length() - f.Tell() ) / ( 8 * ( int )sizeof( int ) ) )
+	{
+		common->Warning( "idInteractionCache::Load: %s is corrupt", filename );
+		Clear();
+		return false;
+	}
+
+	entries.SetNum( numEntries );
+	entryHash.Clear( 4096, numEntries );
+
+	for( int i = 0; i < numEntries; i++ )
+	{
+		cachedInteraction_t& entry = entries[i];
+
+		if( !R_ReadCacheEntry( f, entry ) )
+		{
+			common->Warning( "idInteractionCache::Load: %s is corrupt", filename );
+			Clear();
+			return false;
+		}
+
+		entryHash.Add( entry.lightKey ^ entry.modelNameKey ^ entry.surfaceNum, i );
+	}
+
+	if( f.Tell() != f.Length() )
+	{
+		common->Warning( "idInteractionCache::Load: %s is corrupt", filename );
+		Clear();
+		return false;
+	}
+
+	common->Printf( "loaded %i cached interaction surfaces from %s\n", entries.Num(), filename );
+	return true;
+}
+
+/*
+===============
+idInteractionCache::FindSurface
+===============
+*/
+const cachedInteraction_t* idInteractionCache::FindSurface( unsigned int lightKey, const char* modelName, int surfaceNum, const srfTriangles_t* ambientTris ) const
+{
+	if( !buffer )
+	{
+		return NULL;
+	}
+
+	int modelNameKey = idStr::Hash( modelName );
+	int modelNameLength = idStr::Length( modelName );
+
+	for( int i = entryHash.First( lightKey ^ modelNameKey ^ surfaceNum ); i != -1; i = entryHash.Next( i ) )
+	{
+		const cachedInteraction_t& entry = entries[i];
+
+		if( entry.lightKey != lightKey || entry.modelNameKey != modelNameKey || entry.surfaceNum != surfaceNum )
+		{
+			continue;
+		}
+		if( entry.modelNameLength != modelNameLength || memcmp( buffer + entry.modelNameOffset, modelName, modelNameLength ) != 0 )
+		{
+			continue;
+		}
+
+		// the world geometry changed since the cache was written
+		if( entry.ambientNumVerts != ambientTris->numVerts || entry.ambientNumIndexes != ambientTris->numIndexes ||
+				entry.ambientChecksum != SurfaceKey( ambientTris ) )
+		{
+			return NULL;
+		}
+		return &entry;
+	}
+	return NULL;
+}
+
+/*
+===============
+idInteractionCache::CreateLightTris
+===============
+*/
+bool idInteractionCache::CreateLightTris( const cachedInteraction_t* cached, const srfTriangles_t* ambientTris, srfTriangles_t** lightTris ) const
+{
+	int				state;
+	int				numIndexes;
+	srfTriangles_t*	newTri;
+
+	if( cached->lightTrisOffset < 0 )
+	{
+		return false;
+	}
+
+	idFile_Memory f( "interactionCache", ( const char* )buffer, bufferSize );
+	f.Seek( cached->lightTrisOffset, FS_SEEK_SET );
+
+	f.ReadInt( state );
+	if( state == CACHED_SURFACE_EMPTY )
+	{
+		*lightTris = NULL;
+		tr.pc.c_cachedLightTris++;
+		return true;
+	}
+
+	// allocate a new surface for the lit triangles
+	newTri = R_AllocStaticTriSurf();
+
+	// save a reference to the original surface
+	newTri->ambientSurface = const_cast<srfTriangles_t*>( ambientTris );
+
+	// the light surface references the verts of the ambient surface
+	newTri->numVerts = ambientTris->numVerts;
+	R_ReferenceStaticTriSurfVerts( newTri, ambientTris );
+
+	if( state == CACHED_SURFACE_ALL )
+	{
+		R_ReferenceStaticTriSurfIndexes( newTri, ambientTris );
+		numIndexes = ambientTris->numIndexes;
+	}
+	else
+	{
+		f.ReadInt( numIndexes );
+		R_AllocStaticTriSurfIndexes( newTri, numIndexes );
+		f.Read( newTri->indexes, numIndexes * sizeof( newTri->indexes[0] ) );
+		LittleRevBytes( newTri->indexes, sizeof( newTri->indexes[0] ), numIndexes );
+	}
+	newTri->numIndexes = numIndexes;
+
+	f.ReadVec3( newTri->bounds[0] );
+	f.ReadVec3( newTri->bounds[1] );
+
+	*lightTris = newTri;
+	tr.pc.c_cachedLightTris++;
+	return true;
+}
+
+/*
+===============
+idInteractionCache::CreateShadowTris
+===============
+*/
+bool idInteractionCache::CreateShadowTris( const cachedInteraction_t* cached, srfTriangles_t** shadowTris ) const
+{
+	int				state;
+	srfTriangles_t*	newTri;
+
+	if( cached->shadowTrisOffset < 0 )
+	{
+		return false;
+	}
+
+	idFile_Memory f( "interactionCache", ( const char* )buffer, bufferSize );
+	f.Seek( cached->shadowTrisOffset, FS_SEEK_SET );
+
+	f.ReadInt( state );
+	if( state == CACHED_SURFACE_EMPTY )
+	{
+		*shadowTris = NULL;
+		tr.pc.c_cachedShadowVolumes++;
+		return true;
+	}
+
+	newTri = R_AllocStaticTriSurf();
+
+	// like the dmap optimized shadows, the bounds are left cleared
+	newTri->bounds.Clear();
+
+	f.ReadInt( newTri->numVerts );
+	f.ReadInt( newTri->numShadowIndexesNoCaps );
+	f.ReadInt( newTri->numShadowIndexesNoFrontCaps );
+	f.ReadInt( newTri->numIndexes );
+	f.ReadInt( newTri->shadowCapPlaneBits );
+
+	R_AllocStaticTriSurfShadowVerts( newTri, newTri->numVerts );
+	f.Read( newTri->shadowVertexes, newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) );
+	LittleRevBytes( newTri->shadowVertexes, sizeof( float ), newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) / sizeof( float ) );
+
+	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
+	f.Read( newTri->indexes, newTri->numIndexes * sizeof( newTri->indexes[0] ) );
+	LittleRevBytes( newTri->indexes, sizeof( newTri->indexes[0] ), newTri->numIndexes );
+
+	*shadowTris = newTri;
+	tr.pc.c_cachedShadowVolumes++;
+	return true;
+}
+
+/*
+===============
+idInteractionCache::WriteInteractionCache_f
+
+Creates the light tris and shadow volumes of every light against every
+static world model of the current map and writes them next to the map.
+Lights with a dmap generated optimized shadow volume don't have their
+world shadows cached, because those are never created at run time.
+===============
+*/
+void idInteractionCache::WriteInteractionCache_f( const idCmdArgs& args )
+{
+	idRenderWorldLocal*	world = tr.primaryWorld;
+	idStr				filename;
+	idFile* 			f;
+	int					numEntries;
+	int					numLightTris;
+	int					numShadowTris;
+
+	if( !world || !world->mapName.Length() || world->mapName == "<FREED>" )
+	{
+		common->Printf( "no map loaded\n" );
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+
+	filename = world->mapName;
+	filename.SetFileExtension( INTERACTION_CACHE_EXT );
+
+	f = fileSystem->OpenFileWrite( filename );
+	if( !f )
+	{
+		common->Warning( "couldn't open %s", filename.c_str() );
+		return;
+	}
+
+	f->WriteInt( INTERACTION_CACHE_ID );
+	f->WriteInt( INTERACTION_CACHE_VERSION );
+	f->WriteInt( CurrentFlags() );
+	int numEntriesOffset = f->Tell();
+	f->WriteInt( 0 );
+
+	numEntries = 0;
+	numLightTris = 0;
+	numShadowTris = 0;
+
+	for( int i = 0; i < world->lightDefs.Num(); i++ )
+	{
+		idRenderLightLocal* ldef = world->lightDefs[i];
+		if( !ldef )
+		{
+			continue;
+		}
+
+		unsigned int lightKey = LightKey( ldef );
+
+		for( int j = 0; j < world->entityDefs.Num(); j++ )
+		{
+			idRenderEntityLocal* edef = world->entityDefs[j];
+			if( !edef || !edef->parms.hModel || !edef->parms.hModel->IsStaticWorldModel() )
+			{
+				continue;
+			}
+
+			idRenderModel* model = edef->parms.hModel;
+
+			if( R_CullLocalBox( model->Bounds( &edef->parms ), edef->modelMatrix, 6, ldef->frustum ) )
+			{
+				continue;
+			}
+
+			bool hasShadows = !ldef->parms.noShadows && !edef->parms.noShadow && ldef->lightShader->LightCastsShadows();
+
+			for( int c = 0; c < model->NumSurfaces(); c++ )
+			{
+				const modelSurface_t* surf = model->Surface( c );
+				srfTriangles_t* tri = surf->geometry;
+				const idMaterial* shader = R_RemapShaderBySkin( surf->shader, edef->parms.customSkin, edef->parms.customShader );
+
+				if( !tri || !shader )
+				{
+					continue;
+				}
+				if( R_CullLocalBox( tri->bounds, edef->modelMatrix, 6, ldef->frustum ) )
+				{
+					continue;
+				}
+				if( shader->Spectrum() != ldef->lightShader->Spectrum() )
+				{
+					continue;
+				}
+
+				bool lit = shader->ReceivesLighting();
+				bool shadowed = hasShadows && shader->SurfaceCastsShadow() && tri->silEdges != NULL && ldef->parms.prelightModel == NULL;
+				if( !lit && !shadowed )
+				{
+					continue;
+				}
+
+				srfCullInfo_t cullInfo = srfCullInfo_t();
+
+				f->WriteInt( lightKey );
+				f->WriteString( model->Name() );
+				f->WriteInt( c );
+				f->WriteInt( tri->numVerts );
+				f->WriteInt( tri->numIndexes );
+				f->WriteUnsignedInt( SurfaceKey( tri ) );
+
+				if( !lit )
+				{
+					f->WriteInt( CACHED_SURFACE_NONE );
+				}
+				else
+				{
+					srfTriangles_t* lightTris = R_CreateLightTris( edef, tri, ldef, shader, cullInfo );
+					if( !lightTris )
+					{
+						f->WriteInt( CACHED_SURFACE_EMPTY );
+					}
+					else
+					{
+						if( lightTris->indexes == tri->indexes )
+						{
+							f->WriteInt( CACHED_SURFACE_ALL );
+						}
+						else
+						{
+							f->WriteInt( CACHED_SURFACE_INDEXES );
+							f->WriteInt( lightTris->numIndexes );
+							for( int k = 0; k < lightTris->numIndexes; k++ )
+							{
+								f->WriteInt( lightTris->indexes[k] );
+							}
+						}
+						f->WriteVec3( lightTris->bounds[0] );
+						f->WriteVec3( lightTris->bounds[1] );
+						R_FreeStaticTriSurf( lightTris );
+						numLightTris++;
+					}
+				}
+
+				if( !shadowed )
+				{
+					f->WriteInt( CACHED_SURFACE_NONE );
+				}
+				else
+				{
+					// the static shadow path clips to the light frustum and optimizes the caps,
+					// which is too expensive at run time but is free when loaded from the cache
+					srfTriangles_t* shadowTris = R_CreateShadowVolume( edef, tri, ldef, SG_STATIC, cullInfo );
+					if( !shadowTris )
+					{
+						f->WriteInt( CACHED_SURFACE_EMPTY );
+					}
+					else
+					{
+						f->WriteInt( CACHED_SURFACE_INDEXES );
+						f->WriteInt( shadowTris->numVerts );
+						f->WriteInt( shadowTris->numShadowIndexesNoCaps );
+						f->WriteInt( shadowTris->numShadowIndexesNoFrontCaps );
+						f->WriteInt( shadowTris->numIndexes );
+						f->WriteInt( shadowTris->shadowCapPlaneBits );
+						for( int k = 0; k < shadowTris->numVerts; k++ )
+						{
+							f->WriteVec4( shadowTris->shadowVertexes[k].xyz );
+						}
+						for( int k = 0; k < shadowTris->numIndexes; k++ )
+						{
+							f->WriteInt( shadowTris->indexes[k] );
+						}
+						R_FreeStaticTriSurf( shadowTris );
+						numShadowTris++;
+					}
+				}
+
+				R_FreeInteractionCullInfo( cullInfo );
+				numEntries++;
+			}
+		}
+	}
+
+	f->Seek( numEntriesOffset, FS_SEEK_SET );
+	f->WriteInt( numEntries );
+	fileSystem->CloseFile( f );
+
+	int end = Sys_Milliseconds();
+
+	common->Printf( "wrote %s: %i surfaces, %i light tris, %i shadow volumes in %i msec\n",
+					filename.c_str(), numEntries, numLightTris, numShadowTris, end - start );
+
+	// use the new cache right away, the existing interactions keep their surfaces
+	if( r_useInteractionCache.GetBool() )
+	{
+		world->interactionCache.Load( filename );
+	}
+}
@@ -186,6 +186,79 @@ private:
 };
 
 
+/*
+===============================================================================
+
+	Static interaction cache.
+
+	The light tris and shadow volumes of a light against the static world
+	area models only depend on the light and the world geometry, so they can
+	be generated once with writeInteractionCache and stored next to the map.
+	Lights are identified by a checksum of their frustum, origin and shader,
+	so a light that moved or changed simply won't find any cached surfaces
+	and its interactions are created as usual.
+
+===============================================================================
+*/
+
+#define INTERACTION_CACHE_EXT		"icache"
+#define INTERACTION_CACHE_ID		( ( 'E' << 24 ) + ( 'H' << 16 ) + ( 'C' << 8 ) + 'I' )
+#define INTERACTION_CACHE_VERSION	2
+
+typedef struct
+{
+	unsigned int			lightKey;
+	int						modelNameKey;
+	int						modelNameOffset;		// the full name in the cache buffer, not terminated
+	int						modelNameLength;
+	int						surfaceNum;
+	int						ambientNumVerts;		// to detect surfaces that changed since the cache was written
+	int						ambientNumIndexes;
+	unsigned int			ambientChecksum;
+	int						lightTrisOffset;		// -1 if the light tris were not cached
+	int						shadowTrisOffset;		// -1 if the shadow volume was not cached
+} cachedInteraction_t;
+
+class idInteractionCache
+{
+public:
+	idInteractionCache();
+	~idInteractionCache();
+
+	void					Clear();
+	bool					Load( const char* filename );
+	bool					IsLoaded() const
+	{
+		return ( buffer != NULL );
+	}
+
+	// find the cached interaction between a light and a surface of a static world model
+	const cachedInteraction_t* FindSurface( unsigned int lightKey, const char* modelName, int surfaceNum, const srfTriangles_t* ambientTris ) const;
+
+	// create new surfaces from the cached data, return false if the surface wasn't cached
+	// the surface may be NULL if the cached result was an empty surface
+	bool					CreateLightTris( const cachedInteraction_t* cached, const srfTriangles_t* ambientTris, srfTriangles_t** lightTris ) const;
+	bool					CreateShadowTris( const cachedInteraction_t* cached, srfTriangles_t** shadowTris ) const;
+
+	// checksum identifying the light volume, origin and shader
+	static unsigned int		LightKey( const idRenderLightLocal* ldef );
+
+	// checksum of the vertex positions and indexes of a surface
+	static unsigned int		SurfaceKey( const srfTriangles_t* tri );
+
+	// cvars that change the generated light tris
+	static int				CurrentFlags();
+
+	static void				WriteInteractionCache_f( const idCmdArgs& args );
+
+private:
+	byte* 					buffer;
+	int						bufferSize;
+	idList<cachedInteraction_t>	entries;
+	idHashIndex				entryHash;
+};
+
+
 void R_CalcInteractionFacing( const idRenderEntityLocal* ent, const srfTriangles_t* tri, const idRenderLightLocal* light, srfCullInfo_t& cullInfo );
 void R_CalcInteractionCullBits( const idRenderEntityLocal* ent, const srfTriangles_t* tri, const idRenderLightLocal* light, srfCullInfo_t& cullInfo );
 void R_FreeInteractionCullInfo( srfCullInfo_t& cullInfo );
@@ -170,6 +170,7 @@ void idMaterial::FreeData()
 			}
 			if( stages[i].newStage != NULL )
 			{
+				delete stages[i].newStage->megaTexture;
 				Mem_Free( stages[i].newStage );
 				stages[i].newStage = NULL;
 			}
@@ -1787,6 +1788,7 @@ void idMaterial::ParseStage( idLexer& src, const textureRepeat_t trpDefault )
 				if( !newStage.megaTexture->InitFromMegaFile( token.c_str() ) )
 				{
 					delete newStage.megaTexture;
+					newStage.megaTexture = NULL;
 					SetMaterialFlag( MF_DEFAULTED );
 					continue;
 				}
@@ -35,6 +35,10 @@ idCVar idMegaTexture::r_showMegaTexture( "r_showMegaTexture", "0", CVAR_RENDERER
 idCVar idMegaTexture::r_showMegaTextureLabels( "r_showMegaTextureLabels", "0", CVAR_RENDERER | CVAR_BOOL, "draw colored blocks in each tile" );
 idCVar idMegaTexture::r_skipMegaTexture( "r_skipMegaTexture", "0", CVAR_RENDERER | CVAR_INTEGER, "only use the lowest level image" );
 idCVar idMegaTexture::r_terrainScale( "r_terrainScale", "3", CVAR_RENDERER | CVAR_INTEGER, "vertically scale USGS data" );
+idCVar idMegaTexture::r_megaTextureCacheMegs( "r_megaTextureCacheMegs", "32", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "MB of tiles each megaTexture keeps in memory" );
+idCVar idMegaTexture::r_megaTextureBackgroundLoads( "r_megaTextureBackgroundLoads", "1", CVAR_RENDERER | CVAR_BOOL, "read tiles on the background file thread and show a magnified coarser tile meanwhile" );
+idCVar idMegaTexture::r_megaTexturePrefetch( "r_megaTexturePrefetch", "8", CVAR_RENDERER | CVAR_INTEGER, "request the tiles the view reaches this many updates ahead at its current velocity, 0 = no prediction" );
+idCVar idMegaTexture::r_showMegaTextureStats( "r_showMegaTextureStats", "0", CVAR_RENDERER | CVAR_BOOL, "print tile cache hits, misses and background read latency" );
 
 /*
 
@@ -85,6 +89,61 @@ static void R_EmptyLevelImage( idImage* image )
 }
 
 
+/*
+====================
+idMegaTexture
+====================
+*/
+idMegaTexture::idMegaTexture()
+{
+	fileHandle = NULL;
+	loadHandle = NULL;
+
+	memset( tileHash, 0, sizeof( tileHash ) );
+	tileLRU.cacheUsagePrev = &tileLRU;
+	tileLRU.cacheUsageNext = &tileLRU;
+	tileLoads = NULL;
+	numTiles = 0;
+	numTileLoads = 0;
+}
+
+/*
+====================
+~idMegaTexture
+
+The file thread may still be reading into tiles, so wait for those before freeing anything
+====================
+*/
+idMegaTexture::~idMegaTexture()
+{
+	for( idMegaTile* tile = tileLoads ; tile ; tile = tile->loadNext )
+	{
+		while( !tile->bgl.completed )
+		{
+			Sys_Sleep( 1 );
+		}
+	}
+	tileLoads = NULL;
+	numTileLoads = 0;
+
+	idMegaTile*	next;
+	for( idMegaTile* tile = tileLRU.cacheUsageNext ; tile != &tileLRU ; tile = next )
+	{
+		next = tile->cacheUsageNext;
+		R_StaticFree( tile->data );
+		delete tile;
+	}
+	tileLRU.cacheUsagePrev = &tileLRU;
+	tileLRU.cacheUsageNext = &tileLRU;
+	memset( tileHash, 0, sizeof( tileHash ) );
+	numTiles = 0;
+
+	delete loadHandle;
+	loadHandle = NULL;
+	delete fileHandle;
+	fileHandle = NULL;
+}
+
 /*
 ====================
 InitFromMegaFile
@@ -113,6 +172,20 @@ bool idMegaTexture::InitFromMegaFile( const char* fileBase )
 		return false;
 	}
 
+	// a second handle for the background file thread, so it never shares a file position
+	// with the blocking reads
+	loadHandle = fileSystem->OpenFileRead( name.c_str() );
+
+	numPendingTiles = 0;
+	viewVelocity.Zero();
+
+	statHits = 0;
+	statMisses = 0;
+	statBlocking = 0;
+	statLoads = 0;
+	statCompleted = 0;
+	statLatency = 0;
+
 	currentTriMapping = NULL;
 
 	numLevels = 0;
@@ -332,7 +405,10 @@ void idMegaTexture::SetViewOrigin( const idVec3 viewOrigin )
 		}
 	}
 
-	if( viewOrigin == currentViewOrigin )
+	CompleteTileLoads();
+
+	// keep updating while magnified tiles wait for their own
+	if( viewOrigin == currentViewOrigin && !numPendingTiles )
 	{
 		return;
 	}
@@ -341,24 +417,260 @@ void idMegaTexture::SetViewOrigin( const idVec3 viewOrigin )
 		return;
 	}
 
+	// the first update has nothing to measure the velocity against
+	if( currentViewOrigin[0] != -99999999.0f )
+	{
+		viewVelocity = viewOrigin - currentViewOrigin;
+	}
+	else
+	{
+		viewVelocity.Zero();
+	}
 	currentViewOrigin = viewOrigin;
 
 	float	texCenter[2];
 
-	// convert the viewOrigin to a texture center, which will
-	// be a different conversion for each megaTexture
+	ViewToTextureCenter( viewOrigin, texCenter );
+
+	// coarsest first, so the finer levels can magnify it while their own tiles load
+	numPendingTiles = 0;
+	for( int i = numLevels - 1 ; i >= 0 ; i-- )
+	{
+		levels[i].UpdateForCenter( texCenter );
+	}
+
+	// start reading the tiles the view is heading for
+	if( r_megaTexturePrefetch.GetInteger() > 0 && viewVelocity != vec3_origin )
+	{
+		ViewToTextureCenter( viewOrigin + viewVelocity * r_megaTexturePrefetch.GetFloat(), texCenter );
+		for( int i = numLevels - 1 ; i >= 0 ; i-- )
+		{
+			levels[i].PrefetchForCenter( texCenter );
+		}
+	}
+}
+
+/*
+====================
+ViewToTextureCenter
+
+Converts a view origin to a texture center, which will
+be a different conversion for each megaTexture
+====================
+*/
+void idMegaTexture::ViewToTextureCenter( const idVec3& origin, float center[2] ) const
+{
 	for( int i = 0 ; i < 2 ; i++ )
 	{
-		texCenter[i] =
-			viewOrigin[0] * localViewToTextureCenter[i][0] +
-			viewOrigin[1] * localViewToTextureCenter[i][1] +
-			viewOrigin[2] * localViewToTextureCenter[i][2] +
+		center[i] =
+			origin[0] * localViewToTextureCenter[i][0] +
+			origin[1] * localViewToTextureCenter[i][1] +
+			origin[2] * localViewToTextureCenter[i][2] +
 			localViewToTextureCenter[i][3];
 	}
+}
 
-	for( int i = 0 ; i < numLevels ; i++ )
+/*
+====================
+FindTile
+====================
+*/
+idMegaTile* idMegaTexture::FindTile( int tileNum ) const
+{
+	for( idMegaTile* tile = tileHash[ tileNum & ( MEGA_TILE_HASH_SIZE - 1 ) ] ; tile ; tile = tile->hashNext )
 	{
-		levels[i].UpdateForCenter( texCenter );
+		if( tile->tileNum == tileNum )
+		{
+			return tile;
+		}
+	}
+	return NULL;
+}
+
+/*
+====================
+AllocTile
+
+Adds a cache entry for the tile, taking over the least recently used one once
+r_megaTextureCacheMegs is reached. Returns NULL if everything is still loading.
+====================
+*/
+idMegaTile* idMegaTexture::AllocTile( int tileNum )
+{
+	idMegaTile*	tile;
+
+	// never less than a window of every level plus the predicted one
+	int maxTiles = r_megaTextureCacheMegs.GetInteger() * 1024 * 1024 / TILE_BYTES;
+	if( maxTiles < numLevels * TILE_PER_LEVEL * TILE_PER_LEVEL * 2 )
+	{
+		maxTiles = numLevels * TILE_PER_LEVEL * TILE_PER_LEVEL * 2;
+	}
+
+	if( numTiles >= maxTiles )
+	{
+		for( tile = tileLRU.cacheUsagePrev ; tile != &tileLRU && tile->loading ; tile = tile->cacheUsagePrev )
+		{
+		}
+		if( tile == &tileLRU )
+		{
+			return NULL;
+		}
+
+		// remove it from the hash and the cached list
+		idMegaTile** prev;
+		for( prev = &tileHash[ tile->tileNum & ( MEGA_TILE_HASH_SIZE - 1 ) ] ; *prev != tile ; prev = &( *prev )->hashNext )
+		{
+		}
+		*prev = tile->hashNext;
+		tile->cacheUsageNext->cacheUsagePrev = tile->cacheUsagePrev;
+		tile->cacheUsagePrev->cacheUsageNext = tile->cacheUsageNext;
+	}
+	else
+	{
+		tile = new idMegaTile;
+		tile->data = ( byte* )R_StaticAlloc( TILE_BYTES );
+		tile->bgl.opcode = DLTYPE_FILE;
+		numTiles++;
+	}
+
+	tile->tileNum = tileNum;
+	tile->loading = false;
+	tile->loadNext = NULL;
+	tile->bgl.completed = false;
+
+	tile->hashNext = tileHash[ tileNum & ( MEGA_TILE_HASH_SIZE - 1 ) ];
+	tileHash[ tileNum & ( MEGA_TILE_HASH_SIZE - 1 ) ] = tile;
+
+	tile->cacheUsageNext = tileLRU.cacheUsageNext;
+	tile->cacheUsagePrev = &tileLRU;
+	tileLRU.cacheUsageNext->cacheUsagePrev = tile;
+	tileLRU.cacheUsageNext = tile;
+
+	return tile;
+}
+
+/*
+====================
+RequestTile
+
+Returns the cache entry of the tile, starting a background read if it isn't cached.
+Returns NULL if background reads are off or too many are in flight.
+====================
+*/
+idMegaTile* idMegaTexture::RequestTile( int tileNum )
+{
+	idMegaTile*	tile = FindTile( tileNum );
+
+	if( tile )
+	{
+		// move it to the head of the cached list
+		tile->cacheUsageNext->cacheUsagePrev = tile->cacheUsagePrev;
+		tile->cacheUsagePrev->cacheUsageNext = tile->cacheUsageNext;
+		tile->cacheUsageNext = tileLRU.cacheUsageNext;
+		tile->cacheUsagePrev = &tileLRU;
+		tileLRU.cacheUsageNext->cacheUsagePrev = tile;
+		tileLRU.cacheUsageNext = tile;
+		return tile;
+	}
+
+	if( !loadHandle || !r_megaTextureBackgroundLoads.GetBool() || numTileLoads >= MAX_MEGA_TILE_LOADS )
+	{
+		return NULL;
+	}
+
+	tile = AllocTile( tileNum );
+	if( !tile )
+	{
+		return NULL;
+	}
+
+	tile->loading = true;
+	tile->loadStartTime = Sys_Milliseconds();
+	tile->loadNext = tileLoads;
+	tileLoads = tile;
+	numTileLoads++;
+	statLoads++;
+
+	memset( tile->data, 128, TILE_BYTES );
+	tile->bgl.f = loadHandle;
+	tile->bgl.file.position = tileNum * TILE_BYTES;
+	tile->bgl.file.length = TILE_BYTES;
+	tile->bgl.file.buffer = tile->data;
+
+	// a zipped file is read right here
+	fileSystem->BackgroundDownload( &tile->bgl );
+
+	return tile;
+}
+
+/*
+====================
+ReadTile
+
+Blocking read for a tile nothing can stand in for, it is kept in the cache
+so the finer levels can magnify it
+====================
+*/
+void idMegaTexture::ReadTile( int tileNum, byte* data )
+{
+	fileHandle->Seek( tileNum * TILE_BYTES, FS_SEEK_SET );
+	memset( data, 128, TILE_BYTES );
+	fileHandle->Read( data, TILE_BYTES );
+
+	if( FindTile( tileNum ) )
+	{
+		// a background read is already on its way
+		return;
+	}
+	idMegaTile* tile = AllocTile( tileNum );
+	if( tile )
+	{
+		memcpy( tile->data, data, TILE_BYTES );
+		tile->bgl.completed = true;
+	}
+}
+
+/*
+====================
+CompleteTileLoads
+====================
+*/
+void idMegaTexture::CompleteTileLoads()
+{
+	idMegaTile*	remainingList = NULL;
+	idMegaTile*	next;
+	int			time = Sys_Milliseconds();
+
+	for( idMegaTile* tile = tileLoads ; tile ; tile = next )
+	{
+		next = tile->loadNext;
+		if( tile->bgl.completed )
+		{
+			tile->loading = false;
+			tile->loadNext = NULL;
+			numTileLoads--;
+			statCompleted++;
+			statLatency += time - tile->loadStartTime;
+		}
+		else
+		{
+			tile->loadNext = remainingList;
+			remainingList = tile;
+		}
+	}
+	tileLoads = remainingList;
+
+	if( r_showMegaTextureStats.GetBool() && ( statHits || statMisses || statBlocking || statLoads || statCompleted ) )
+	{
+		common->Printf( "megaTexture: %i hits, %i misses, %i blocking, %i reads started, %i done in %i msec avg, %i in flight, %i tiles cached\n",
+						statHits, statMisses, statBlocking, statLoads, statCompleted,
+						statCompleted ? statLatency / statCompleted : 0, numTileLoads, numTiles );
+		statHits = 0;
+		statMisses = 0;
+		statBlocking = 0;
+		statLoads = 0;
+		statCompleted = 0;
+		statLatency = 0;
 	}
 }
 
@@ -373,8 +685,9 @@ A local tile will only be mapped to globalTile[ localTile + X * TILE_PER_LEVEL ]
 void idTextureLevel::UpdateTile( int localX, int localY, int globalX, int globalY )
 {
 	idTextureTile*	tile = &tileMap[localX][localY];
+	idMegaTile*		cached;
 
-	if( tile->x == globalX && tile->y == globalY )
+	if( tile->x == globalX && tile->y == globalY && !tile->pending )
 	{
 		return;
 	}
@@ -383,8 +696,23 @@ void idTextureLevel::UpdateTile( int localX, int localY, int globalX, int global
 		common->Error( "idTextureLevel::UpdateTile: bad coordinate mod" );
 	}
 
+	int		tileNum = tileOffset + globalY * tilesWide + globalX;
+	bool	background = idMegaTexture::r_megaTextureBackgroundLoads.GetBool() && mega->loadHandle != NULL;
+
+	if( tile->x == globalX && tile->y == globalY && background )
+	{
+		// still magnified, wait for the background read
+		cached = mega->RequestTile( tileNum );
+		if( !cached || !cached->bgl.completed )
+		{
+			mega->numPendingTiles++;
+			return;
+		}
+	}
+
 	tile->x = globalX;
 	tile->y = globalY;
+	tile->pending = false;
 
 	byte	data[ TILE_SIZE * TILE_SIZE * 4 ];
 
@@ -395,14 +723,23 @@ void idTextureLevel::UpdateTile( int localX, int localY, int globalX, int global
 	}
 	else
 	{
-		// extract the data from the full image (FIXME: background load from disk)
-		int		tileNum = tileOffset + tile->y * tilesWide + tile->x;
-
-		int		tileSize = TILE_SIZE * TILE_SIZE * 4;
-
-		mega->fileHandle->Seek( tileNum * tileSize, FS_SEEK_SET );
-		memset( data, 128, sizeof( data ) );
-		mega->fileHandle->Read( data, tileSize );
+		cached = mega->RequestTile( tileNum );
+		if( cached && cached->bgl.completed )
+		{
+			memcpy( data, cached->data, sizeof( data ) );
+			mega->statHits++;
+		}
+		else if( background && MagnifyCoarserTile( globalX, globalY, data ) )
+		{
+			tile->pending = true;
+			mega->numPendingTiles++;
+			mega->statMisses++;
+		}
+		else
+		{
+			mega->ReadTile( tileNum, data );
+			mega->statBlocking++;
+		}
 	}
 
 	if( idMegaTexture::r_showMegaTextureLabels.GetBool() )
@@ -451,6 +788,54 @@ void idTextureLevel::UpdateTile( int localX, int localY, int globalX, int global
 	}
 }
 
+/*
+====================
+MagnifyCoarserTile
+
+Fills data with the part of the closest coarser level tile that is in memory,
+returns false if there isn't one
+====================
+*/
+bool idTextureLevel::MagnifyCoarserTile( int globalX, int globalY, byte* data )
+{
+	int levelNum = this - mega->levels;
+
+	for( int shift = 1 ; levelNum + shift < mega->numLevels && ( TILE_SIZE >> shift ) > 0 ; shift++ )
+	{
+		idTextureLevel* coarser = &mega->levels[ levelNum + shift ];
+		int	coarserX = globalX >> shift;
+		int	coarserY = globalY >> shift;
+
+		if( coarserX >= coarser->tilesWide || coarserY >= coarser->tilesHigh )
+		{
+			return false;
+		}
+
+		idMegaTile* cached = mega->FindTile( coarser->tileOffset + coarserY * coarser->tilesWide + coarserX );
+		if( !cached || !cached->bgl.completed )
+		{
+			continue;
+		}
+
+		// the mip levels are built from 2x2 blocks, so the tile is this part of it
+		int	size = TILE_SIZE >> shift;
+		int	ox = ( globalX & ( ( 1 << shift ) - 1 ) ) * size;
+		int	oy = ( globalY & ( ( 1 << shift ) - 1 ) ) * size;
+
+		for( int y = 0 ; y < TILE_SIZE ; y++ )
+		{
+			const int* in = ( const int* )cached->data + ( oy + ( y >> shift ) ) * TILE_SIZE + ox;
+			int* out = ( int* )data + y * TILE_SIZE;
+			for( int x = 0 ; x < TILE_SIZE ; x++ )
+			{
+				out[x] = in[ x >> shift ];
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
 /*
 ====================
 UpdateForCenter
@@ -510,6 +895,45 @@ void idTextureLevel::UpdateForCenter( float center[2] )
 	}
 }
 
+/*
+====================
+PrefetchForCenter
+
+Starts background reads for the window of tiles around center
+====================
+*/
+void idTextureLevel::PrefetchForCenter( float center[2] )
+{
+	int		globalTileCorner[2];
+
+	if( tilesWide <= TILE_PER_LEVEL && tilesHigh <= TILE_PER_LEVEL )
+	{
+		// the whole level is always mapped
+		return;
+	}
+
+	for( int i = 0 ; i < 2 ; i++ )
+	{
+		float	global = ( center[i] * parms[3] - 0.5 ) * TILE_PER_LEVEL;
+		globalTileCorner[i] = ( int )( global + 0.5 );
+	}
+
+	for( int x = 0 ; x < TILE_PER_LEVEL ; x++ )
+	{
+		for( int y = 0 ; y < TILE_PER_LEVEL ; y++ )
+		{
+			int	globalX = globalTileCorner[0] + x;
+			int	globalY = globalTileCorner[1] + y;
+
+			if( globalX >= tilesWide || globalX < 0 || globalY >= tilesHigh || globalY < 0 )
+			{
+				continue;
+			}
+			mega->RequestTile( tileOffset + globalY * tilesWide + globalX );
+		}
+	}
+}
+
 /*
 =====================
 Invalidate
@@ -525,6 +949,7 @@ void idTextureLevel::Invalidate()
 		{
 			tileMap[x][y].x =
 				tileMap[x][y].y = -99999;
+			tileMap[x][y].pending = false;
 		}
 	}
 }
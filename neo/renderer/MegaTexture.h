@@ -30,6 +30,7 @@ class idTextureTile
 {
 public:
 	int		x, y;
+	bool	pending;		// showing a magnified coarser tile until its own is loaded
 };
 
 static const int TILE_PER_LEVEL = 4;
@@ -37,9 +38,27 @@ static const int MAX_MEGA_CHANNELS = 3;		// normal, diffuse, specular
 static const int MAX_LEVELS = 12;
 static const int MAX_LEVEL_WIDTH = 512;
 static const int TILE_SIZE = MAX_LEVEL_WIDTH / TILE_PER_LEVEL;
+static const int TILE_BYTES = TILE_SIZE * TILE_SIZE * 4;
+static const int MEGA_TILE_HASH_SIZE = 1024;
+static const int MAX_MEGA_TILE_LOADS = 16;	// background reads in flight per megaTexture
 
 class	idMegaTexture;
 
+// a tile of the .mega file kept in memory, read by the background file thread
+class idMegaTile
+{
+public:
+	int					tileNum;
+	byte* 				data;				// TILE_BYTES
+	bool				loading;			// on the load list, data is valid once bgl.completed is set
+	int					loadStartTime;
+	backgroundDownload_t	bgl;
+
+	idMegaTile* 		hashNext;
+	idMegaTile* 		loadNext;
+	idMegaTile* 		cacheUsagePrev, *cacheUsageNext;	// most recently used first
+};
+
 class idTextureLevel
 {
 public:
@@ -55,7 +74,9 @@ public:
 	float			parms[4];
 
 	void			UpdateForCenter( float center[2] );
+	void			PrefetchForCenter( float center[2] );
 	void			UpdateTile( int localX, int localY, int globalX, int globalY );
+	bool			MagnifyCoarserTile( int globalX, int globalY, byte* data );
 	void			Invalidate();
 };
 
@@ -70,6 +91,9 @@ typedef struct
 class idMegaTexture
 {
 public:
+	idMegaTexture();
+	~idMegaTexture();
+
 	bool	InitFromMegaFile( const char* fileBase );
 	void	SetMappingForSurface( const srfTriangles_t* tri );	// analyzes xyz and st to create a mapping
 	void	BindForViewOrigin( const idVec3 origin );	// binds images and sets program parameters
@@ -82,7 +106,16 @@ private:
 	static void	GenerateMegaMipMaps( megaTextureHeader_t* header, idFile* file );
 	static void	GenerateMegaPreview( const char* fileName );
 
+	void			ViewToTextureCenter( const idVec3& origin, float center[2] ) const;
+
+	idMegaTile* 	FindTile( int tileNum ) const;
+	idMegaTile* 	AllocTile( int tileNum );
+	idMegaTile* 	RequestTile( int tileNum );
+	void			ReadTile( int tileNum, byte* data );
+	void			CompleteTileLoads();
+
 	idFile*			fileHandle;
+	idFile* 		loadHandle;						// background reads, fileHandle is used for the blocking ones
 
 	const srfTriangles_t* currentTriMapping;
 
@@ -94,10 +127,31 @@ private:
 	idTextureLevel	levels[MAX_LEVELS];				// 0 is the highest resolution
 	megaTextureHeader_t	header;
 
+	idVec3			viewVelocity;					// view movement since the previous update
+	int				numPendingTiles;
+
+	idMegaTile* 	tileHash[MEGA_TILE_HASH_SIZE];
+	idMegaTile		tileLRU;						// head of the cached tiles
+	idMegaTile* 	tileLoads;
+	int				numTiles;
+	int				numTileLoads;
+
+	// counted until r_showMegaTextureStats prints them
+	int				statHits;
+	int				statMisses;
+	int				statBlocking;
+	int				statLoads;
+	int				statCompleted;
+	int				statLatency;
+
 	static idCVar	r_megaTextureLevel;
 	static idCVar	r_showMegaTexture;
 	static idCVar	r_showMegaTextureLabels;
 	static idCVar	r_skipMegaTexture;
 	static idCVar	r_terrainScale;
+	static idCVar	r_megaTextureCacheMegs;
+	static idCVar	r_megaTextureBackgroundLoads;
+	static idCVar	r_megaTexturePrefetch;
+	static idCVar	r_showMegaTextureStats;
 };
 
@@ -125,6 +125,12 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 	g.origin.Zero();
 	g.axis.Identity();
 
+	// the spawn state of all the live particles is gathered first, so the
+	// expensive part of creating them can be done for whole stages at once
+	particleJob_t*	jobs = ( particleJob_t* )R_FrameAlloc( particleSystem->stages.Num() * sizeof( jobs[0] ) );
+	int				numJobs = 0;
+	int				numParticles = 0;
+
 	for( int stageNum = 0; stageNum < particleSystem->stages.Num(); stageNum++ )
 	{
 		idParticleStage* stage = particleSystem->stages[stageNum];
@@ -174,8 +180,11 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			R_AllocStaticTriSurfPlanes( surf->geometry, 6 * count );
 		}
 
-		int numVerts = 0;
-		idDrawVert* verts = surf->geometry->verts;
+		particleJob_t* job = &jobs[numJobs++];
+		job->stage = stage;
+		job->gens = ( particleGen_t* )R_FrameAlloc( Max( stage->totalParticles, 1 ) * sizeof( job->gens[0] ) );
+		job->numGens = 0;
+		job->tri = surf->geometry;
 
 		for( int index = 0; index < stage->totalParticles; index++ )
 		{
@@ -237,16 +246,28 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 
 			g.age = g.frac * stage->particleLife;
 
-			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
-			numVerts += stage->CreateParticle( &g, verts + numVerts );
+			// the particle is created later, and if it is faded out or beyond
+			// a kill region it won't get any verts
+			job->gens[job->numGens++] = g;
 		}
 
+		numParticles += job->numGens;
+	}
+
+	R_RunParticleJobs( jobs, numJobs, numParticles );
+
+	for( int jobNum = 0; jobNum < numJobs; jobNum++ )
+	{
+		const idParticleStage* stage = jobs[jobNum].stage;
+		srfTriangles_t* tri = jobs[jobNum].tri;
+		int numVerts = tri->numVerts;
+
 		// numVerts must be a multiple of 4
-		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
+		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * stage->totalParticles * stage->NumQuadsPerParticle() );
 
 		// build the indexes
 		int	numIndexes = 0;
-		glIndex_t* indexes = surf->geometry->indexes;
+		glIndex_t* indexes = tri->indexes;
 		for( int i = 0; i < numVerts; i += 4 )
 		{
 			indexes[numIndexes + 0] = i;
@@ -258,11 +279,11 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			numIndexes += 6;
 		}
 
-		surf->geometry->tangentsCalculated = false;
-		surf->geometry->facePlanesCalculated = false;
-		surf->geometry->numVerts = numVerts;
-		surf->geometry->numIndexes = numIndexes;
-		surf->geometry->bounds = stage->bounds;		// just always draw the particles
+		tri->tangentsCalculated = false;
+		tri->facePlanesCalculated = false;
+		tri->numVerts = numVerts;
+		tri->numIndexes = numIndexes;
+		tri->bounds = stage->bounds;		// just always draw the particles
 	}
 
 	return staticModel;
@@ -90,9 +90,10 @@ static void R_PerformanceCounters()
 
 	if( r_showCull.GetBool() )
 	{
-		common->Printf( "%i sin %i sclip  %i sout %i bin %i bout\n",
+		common->Printf( "%i sin %i sclip  %i sout %i bin %i bout %i portalWalks %i reusedFlows\n",
 						tr.pc.c_sphere_cull_in, tr.pc.c_sphere_cull_clip, tr.pc.c_sphere_cull_out,
-						tr.pc.c_box_cull_in, tr.pc.c_box_cull_out );
+						tr.pc.c_box_cull_in, tr.pc.c_box_cull_out,
+						tr.pc.c_portalFlowWalks, tr.pc.c_portalFlowReused );
 	}
 
 	if( r_showAlloc.GetBool() )
@@ -102,8 +103,9 @@ static void R_PerformanceCounters()
 
 	if( r_showInteractions.GetBool() )
 	{
-		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i\n",
-						tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes );
+		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i cachedLightTris:%i cachedShadowVolumes:%i\n",
+						tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes,
+						tr.pc.c_cachedLightTris, tr.pc.c_cachedShadowVolumes );
 	}
 	if( r_showDefs.GetBool() )
 	{
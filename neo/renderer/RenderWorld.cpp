@@ -152,6 +152,9 @@ idRenderWorldLocal::idRenderWorldLocal()
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
 
+	portalFlowGeneration = 0;
+	portalFlowRecord = NULL;
+
 	interactionTable = 0;
 	interactionTableWidth = 0;
 	interactionTableHeight = 0;
@@ -1594,6 +1597,7 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal* def, portalAre
 	ref->areaPrev = area->entityRefs.areaPrev;
 	ref->areaNext->areaPrev = ref;
 	ref->areaPrev->areaNext = ref;
+	area->entityCull.dirty = true;
 }
 
 /*
@@ -1619,6 +1623,7 @@ void idRenderWorldLocal::AddLightRefToArea( idRenderLightLocal* light, portalAre
 	lref->areaNext = area->lightRefs.areaNext;
 	lref->areaPrev = &area->lightRefs;
 	area->lightRefs.areaNext = lref;
+	area->lightCull.dirty = true;
 }
 
 /*
@@ -40,6 +40,23 @@ If you have questions concerning this license or the applicable additional terms
 #define PROC_FILE_EXT				"proc"
 #define	PROC_FILE_ID				"mapProcFile003"
 
+// binary version of the .proc file written by dmap, loaded in preference to
+// the text file when it is at least as new
+#define BPROC_FILE_EXT				"bproc"
+#define BPROC_FILE_ID				( ( 'C' << 24 ) + ( 'O' << 16 ) + ( 'R' << 8 ) + 'P' )
+#define BPROC_FILE_VERSION			2
+
+// chunk tags in a .bproc file, each followed by the same data as the
+// matching text section with all numbers stored as little endian binary
+typedef enum
+{
+	BPROC_CHUNK_END,
+	BPROC_CHUNK_MODEL,
+	BPROC_CHUNK_SHADOW_MODEL,
+	BPROC_CHUNK_INTER_AREA_PORTALS,
+	BPROC_CHUNK_NODES
+} bprocChunk_t;
+
 // shader parms
 const int MAX_GLOBAL_SHADER_PARMS	= 12;
 
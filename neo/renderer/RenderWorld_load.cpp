@@ -67,8 +67,13 @@ void idRenderWorldLocal::FreeWorld()
 		{
 			common->Error( "FreeWorld: unexpected remaining entityRefs" );
 		}
+
+		FreeAreaCullBounds( &area->entityCull );
+		FreeAreaCullBounds( &area->lightCull );
 	}
 
+	ClearPortalFlowCache();
+
 	if( portalAreas )
 	{
 		R_StaticFree( portalAreas );
@@ -99,6 +104,8 @@ void idRenderWorldLocal::FreeWorld()
 	}
 	localModels.Clear();
 
+	interactionCache.Clear();
+
 	areaReferenceAllocator.Shutdown();
 	interactionAllocator.Shutdown();
 	areaNumRefAllocator.Shutdown();
@@ -398,6 +405,461 @@ void idRenderWorldLocal::ParseNodes( idLexer* src )
 	src->ExpectTokenString( "}" );
 }
 
+/*
+================
+R_BinaryCountIsValid
+
+Makes sure a count read from a binary proc file doesn't run past the end of the file
+================
+*/
+static bool R_BinaryCountIsValid( idFile* f, int count, int elementSize )
+{
+	if( count < 0 )
+	{
+		return false;
+	}
+	return ( ( long long )count * elementSize <= f->Length() - f->Tell() );
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryModel
+
+Binary equivalent of ParseModel, returns NULL if the data is corrupt
+================
+*/
+idRenderModel* idRenderWorldLocal::ReadBinaryModel( idFile* f )
+{
+	idRenderModel*	model;
+	idStr			name;
+	int				i, j;
+	int				numSurfaces;
+	srfTriangles_t*	tri;
+	modelSurface_t	surf;
+	idList<float>	vec;
+
+	f->ReadString( name );
+	f->ReadInt( numSurfaces );
+	if( !R_BinaryCountIsValid( f, numSurfaces, 3 * sizeof( int ) ) )
+	{
+		common->Warning( "ReadBinaryModel: bad numSurfaces on '%s'", name.c_str() );
+		return NULL;
+	}
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( name );
+
+	for( i = 0 ; i < numSurfaces ; i++ )
+	{
+		idStr	materialName;
+		int		numVerts, numIndexes;
+
+		f->ReadString( materialName );
+		f->ReadInt( numVerts );
+		f->ReadInt( numIndexes );
+		if( !R_BinaryCountIsValid( f, numVerts, 8 * sizeof( float ) ) ||
+				!R_BinaryCountIsValid( f, numIndexes, sizeof( glIndex_t ) ) ||
+				!R_BinaryCountIsValid( f, numVerts * 8 + numIndexes, sizeof( float ) ) )
+		{
+			common->Warning( "ReadBinaryModel: bad surface %i on '%s'", i, name.c_str() );
+			delete model;
+			return NULL;
+		}
+
+		surf.shader = declManager->FindMaterial( materialName );
+
+		tri = R_AllocStaticTriSurf();
+		surf.geometry = tri;
+
+		tri->numVerts = numVerts;
+		tri->numIndexes = numIndexes;
+
+		// the vertexes are stored as xyz, st, normal in a single block
+		vec.SetNum( tri->numVerts * 8, false );
+		f->Read( vec.Ptr(), tri->numVerts * 8 * sizeof( float ) );
+		LittleRevBytes( vec.Ptr(), sizeof( float ), tri->numVerts * 8 );
+
+		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+		for( j = 0 ; j < tri->numVerts ; j++ )
+		{
+			const float* v = &vec[j * 8];
+
+			tri->verts[j].xyz[0] = v[0];
+			tri->verts[j].xyz[1] = v[1];
+			tri->verts[j].xyz[2] = v[2];
+			tri->verts[j].st[0] = v[3];
+			tri->verts[j].st[1] = v[4];
+			tri->verts[j].normal[0] = v[5];
+			tri->verts[j].normal[1] = v[6];
+			tri->verts[j].normal[2] = v[7];
+		}
+
+		// the indexes can go straight into the surface
+		R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+		f->Read( tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+		LittleRevBytes( tri->indexes, sizeof( tri->indexes[0] ), tri->numIndexes );
+
+		for( j = 0 ; j < tri->numIndexes ; j++ )
+		{
+			if( tri->indexes[j] < 0 || tri->indexes[j] >= tri->numVerts )
+			{
+				common->Warning( "ReadBinaryModel: index out of range on surface %i of '%s'", i, name.c_str() );
+				R_FreeStaticTriSurf( tri );
+				delete model;
+				return NULL;
+			}
+		}
+
+		// add the completed surface to the model
+		model->AddSurface( surf );
+	}
+
+	// only reference the materials once the whole model is good, a corrupt
+	// file falls back to the .proc which references them again
+	for( i = 0 ; i < model->NumSurfaces() ; i++ )
+	{
+		( ( idMaterial* )model->Surface( i )->shader )->AddReference();
+	}
+
+	model->FinishSurfaces();
+
+	return model;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryShadowModel
+
+Binary equivalent of ParseShadowModel, returns NULL if the data is corrupt
+================
+*/
+idRenderModel* idRenderWorldLocal::ReadBinaryShadowModel( idFile* f )
+{
+	idRenderModel*	model;
+	idStr			name;
+	int				j;
+	srfTriangles_t*	tri;
+	modelSurface_t	surf;
+	int				numVerts, numIndexes;
+	idList<float>	vec;
+
+	f->ReadString( name );
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( name );
+
+	surf.shader = tr.defaultMaterial;
+
+	tri = R_AllocStaticTriSurf();
+	surf.geometry = tri;
+
+	f->ReadInt( numVerts );
+	f->ReadInt( tri->numShadowIndexesNoCaps );
+	f->ReadInt( tri->numShadowIndexesNoFrontCaps );
+	f->ReadInt( numIndexes );
+	f->ReadInt( tri->shadowCapPlaneBits );
+
+	if( !R_BinaryCountIsValid( f, numVerts, 3 * sizeof( float ) ) ||
+			!R_BinaryCountIsValid( f, numIndexes, sizeof( glIndex_t ) ) ||
+			!R_BinaryCountIsValid( f, numVerts * 3 + numIndexes, sizeof( float ) ) )
+	{
+		common->Warning( "ReadBinaryShadowModel: bad counts on '%s'", name.c_str() );
+		R_FreeStaticTriSurf( tri );
+		delete model;
+		return NULL;
+	}
+
+	tri->numVerts = numVerts;
+	tri->numIndexes = numIndexes;
+
+	vec.SetNum( tri->numVerts * 3, false );
+	f->Read( vec.Ptr(), tri->numVerts * 3 * sizeof( float ) );
+	LittleRevBytes( vec.Ptr(), sizeof( float ), tri->numVerts * 3 );
+
+	R_AllocStaticTriSurfShadowVerts( tri, tri->numVerts );
+	tri->bounds.Clear();
+	for( j = 0 ; j < tri->numVerts ; j++ )
+	{
+		const float* v = &vec[j * 3];
+
+		tri->shadowVertexes[j].xyz[0] = v[0];
+		tri->shadowVertexes[j].xyz[1] = v[1];
+		tri->shadowVertexes[j].xyz[2] = v[2];
+		tri->shadowVertexes[j].xyz[3] = 1;		// no homogenous value
+
+		tri->bounds.AddPoint( tri->shadowVertexes[j].xyz.ToVec3() );
+	}
+
+	R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+	f->Read( tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+	LittleRevBytes( tri->indexes, sizeof( tri->indexes[0] ), tri->numIndexes );
+
+	for( j = 0 ; j < tri->numIndexes ; j++ )
+	{
+		if( tri->indexes[j] < 0 || tri->indexes[j] >= tri->numVerts )
+		{
+			common->Warning( "ReadBinaryShadowModel: index out of range on '%s'", name.c_str() );
+			R_FreeStaticTriSurf( tri );
+			delete model;
+			return NULL;
+		}
+	}
+
+	// add the completed surface to the model
+	model->AddSurface( surf );
+
+	// we do NOT do a model->FinishSurfaceces, because we don't need sil edges, planes, tangents, etc.
+
+	return model;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryInterAreaPortals
+
+Binary equivalent of ParseInterAreaPortals
+================
+*/
+bool idRenderWorldLocal::ReadBinaryInterAreaPortals( idFile* f )
+{
+	int i, j;
+	idList<float>	points;
+
+	// every area has a model of at least a name length and a surface count in the file
+	f->ReadInt( numPortalAreas );
+	if( numPortalAreas < 0 || ( long long )numPortalAreas * 2 * sizeof( int ) > f->Length() )
+	{
+		common->Warning( "ReadBinaryInterAreaPortals: bad numPortalAreas" );
+		numPortalAreas = 0;
+		return false;
+	}
+	portalAreas = ( portalArea_t* )R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
+	areaScreenRect = ( idScreenRect* ) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
+
+	// set the doubly linked lists
+	SetupAreaRefs();
+
+	f->ReadInt( numInterAreaPortals );
+	if( !R_BinaryCountIsValid( f, numInterAreaPortals, 3 * sizeof( int ) ) )
+	{
+		common->Warning( "ReadBinaryInterAreaPortals: bad numInterAreaPortals" );
+		numInterAreaPortals = 0;
+		return false;
+	}
+
+	doublePortals = ( doublePortal_t* )R_ClearedStaticAlloc( numInterAreaPortals *
+					sizeof( doublePortals [0] ) );
+
+	for( i = 0 ; i < numInterAreaPortals ; i++ )
+	{
+		int		numPoints, a1, a2;
+		idWinding*	w;
+		portal_t*	p;
+
+		f->ReadInt( numPoints );
+		f->ReadInt( a1 );
+		f->ReadInt( a2 );
+
+		if( !R_BinaryCountIsValid( f, numPoints, 3 * sizeof( float ) ) ||
+				a1 < 0 || a1 >= numPortalAreas || a2 < 0 || a2 >= numPortalAreas )
+		{
+			common->Warning( "ReadBinaryInterAreaPortals: bad portal %i", i );
+			// the portals read so far are hooked into the areas and freed with the world
+			numInterAreaPortals = i;
+			return false;
+		}
+
+		points.SetNum( numPoints * 3, false );
+		f->Read( points.Ptr(), numPoints * 3 * sizeof( float ) );
+		LittleRevBytes( points.Ptr(), sizeof( float ), numPoints * 3 );
+
+		w = new idWinding( numPoints );
+		w->SetNumPoints( numPoints );
+		for( j = 0 ; j < numPoints ; j++ )
+		{
+			( *w )[j][0] = points[j * 3 + 0];
+			( *w )[j][1] = points[j * 3 + 1];
+			( *w )[j][2] = points[j * 3 + 2];
+			// no texture coordinates
+			( *w )[j][3] = 0;
+			( *w )[j][4] = 0;
+		}
+
+		// add the portal to a1
+		p = ( portal_t* )R_ClearedStaticAlloc( sizeof( *p ) );
+		p->intoArea = a2;
+		p->doublePortal = &doublePortals[i];
+		p->w = w;
+		p->w->GetPlane( p->plane );
+
+		p->next = portalAreas[a1].portals;
+		portalAreas[a1].portals = p;
+
+		doublePortals[i].portals[0] = p;
+
+		// reverse it for a2
+		p = ( portal_t* )R_ClearedStaticAlloc( sizeof( *p ) );
+		p->intoArea = a1;
+		p->doublePortal = &doublePortals[i];
+		p->w = w->Reverse();
+		p->w->GetPlane( p->plane );
+
+		p->next = portalAreas[a2].portals;
+		portalAreas[a2].portals = p;
+
+		doublePortals[i].portals[1] = p;
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryNodes
+
+Binary equivalent of ParseNodes
+================
+*/
+bool idRenderWorldLocal::ReadBinaryNodes( idFile* f )
+{
+	int			i;
+
+	f->ReadInt( numAreaNodes );
+	if( !R_BinaryCountIsValid( f, numAreaNodes, 4 * sizeof( float ) + 2 * sizeof( int ) ) )
+	{
+		common->Warning( "ReadBinaryNodes: bad numAreaNodes" );
+		numAreaNodes = 0;
+		return false;
+	}
+	areaNodes = ( areaNode_t* )R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
+
+	for( i = 0 ; i < numAreaNodes ; i++ )
+	{
+		areaNode_t*	node;
+
+		node = &areaNodes[i];
+
+		f->ReadVec4( node->plane.ToVec4() );
+		f->ReadInt( node->children[0] );
+		f->ReadInt( node->children[1] );
+
+		// nodes are written depth first, so child nodes always come later
+		for( int j = 0 ; j < 2 ; j++ )
+		{
+			int child = node->children[j];
+			if( ( child > 0 && ( child <= i || child >= numAreaNodes ) ) || ( child <= 0 && -1 - child >= numPortalAreas ) )
+			{
+				common->Warning( "ReadBinaryNodes: bad child %i on node %i", child, i );
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::LoadBinaryProc
+
+Loads the world from a .bproc file written by dmap.  The whole file is
+read with a single read and the vertex and index blocks are copied
+straight into the surfaces, so no text has to be converted.
+
+Returns false if the file is missing or corrupt, in which case the
+world is left empty and the text .proc file should be parsed instead.
+================
+*/
+bool idRenderWorldLocal::LoadBinaryProc( const char* filename )
+{
+	void*			buffer;
+	int				length;
+	int				ident, version;
+	int				chunk;
+	idRenderModel* 	lastModel;
+	bool			ok;
+
+	length = fileSystem->ReadFile( filename, &buffer );
+	if( length <= 0 || !buffer )
+	{
+		return false;
+	}
+
+	idFile_Memory f( filename, ( const char* )buffer, length );
+
+	f.ReadInt( ident );
+	f.ReadInt( version );
+	if( ident != BPROC_FILE_ID || version != BPROC_FILE_VERSION )
+	{
+		common->Printf( "idRenderWorldLocal::LoadBinaryProc: %s has wrong id or version %i instead of %i\n", filename, version, BPROC_FILE_VERSION );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	ok = true;
+	while( ok )
+	{
+		if( f.ReadInt( chunk ) != sizeof( chunk ) || chunk == BPROC_CHUNK_END )
+		{
+			break;
+		}
+
+		switch( chunk )
+		{
+			case BPROC_CHUNK_MODEL:
+			case BPROC_CHUNK_SHADOW_MODEL:
+			{
+				if( chunk == BPROC_CHUNK_MODEL )
+				{
+					lastModel = ReadBinaryModel( &f );
+				}
+				else
+				{
+					lastModel = ReadBinaryShadowModel( &f );
+				}
+				if( !lastModel )
+				{
+					ok = false;
+					break;
+				}
+
+				// add it to the model manager list
+				renderModelManager->AddModel( lastModel );
+
+				// save it in the list to free when clearing this map
+				localModels.Append( lastModel );
+				break;
+			}
+			case BPROC_CHUNK_INTER_AREA_PORTALS:
+			{
+				ok = ReadBinaryInterAreaPortals( &f );
+				break;
+			}
+			case BPROC_CHUNK_NODES:
+			{
+				ok = ReadBinaryNodes( &f );
+				break;
+			}
+			default:
+			{
+				common->Warning( "idRenderWorldLocal::LoadBinaryProc: bad chunk %i in %s", chunk, filename );
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if( !ok )
+	{
+		FreeWorld();
+		return false;
+	}
+
+	return true;
+}
+
 /*
 ================
 idRenderWorldLocal::CommonChildrenArea_r
@@ -527,6 +989,7 @@ bool idRenderWorldLocal::InitFromMap( const char* name )
 	idLexer* 		src;
 	idToken			token;
 	idStr			filename;
+	idStr			binaryFilename;
 	idRenderModel* 	lastModel;
 
 	// if this is an empty world, initialize manually
@@ -542,12 +1005,34 @@ bool idRenderWorldLocal::InitFromMap( const char* name )
 	// load it
 	filename = name;
 	filename.SetFileExtension( PROC_FILE_EXT );
+	binaryFilename = name;
+	binaryFilename.SetFileExtension( BPROC_FILE_EXT );
 
 	// if we are reloading the same map, check the timestamp
 	// and try to skip all the work
 	ID_TIME_T currentTimeStamp;
 	fileSystem->ReadFile( filename, NULL, &currentTimeStamp );
 
+	// the binary file is only used if it is at least as new as the text file
+	bool useBinary = false;
+	if( r_useBinaryProc.GetBool() )
+	{
+		ID_TIME_T binaryTimeStamp;
+		fileSystem->ReadFile( binaryFilename, NULL, &binaryTimeStamp );
+		if( binaryTimeStamp != FILE_NOT_FOUND_TIMESTAMP )
+		{
+			if( currentTimeStamp == FILE_NOT_FOUND_TIMESTAMP )
+			{
+				currentTimeStamp = binaryTimeStamp;
+				useBinary = true;
+			}
+			else if( binaryTimeStamp >= currentTimeStamp )
+			{
+				useBinary = true;
+			}
+		}
+	}
+
 	if( name == mapName )
 	{
 		if( currentTimeStamp != FILE_NOT_FOUND_TIMESTAMP && currentTimeStamp == mapTimeStamp )
@@ -564,80 +1049,99 @@ bool idRenderWorldLocal::InitFromMap( const char* name )
 
 	FreeWorld();
 
-	src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if( !src->IsLoaded() )
+	if( useBinary && LoadBinaryProc( binaryFilename ) )
 	{
-		common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename.c_str() );
-		ClearWorld();
-		return false;
-	}
-
-
-	mapName = name;
-	mapTimeStamp = currentTimeStamp;
+		mapName = name;
+		mapTimeStamp = currentTimeStamp;
 
-	// if we are writing a demo, archive the load command
-	if( session->writeDemo )
-	{
-		WriteLoadMap();
-	}
-
-	if( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) )
-	{
-		common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
-		delete src;
-		return false;
+		// if we are writing a demo, archive the load command
+		if( session->writeDemo )
+		{
+			WriteLoadMap();
+		}
 	}
-
-	// parse the file
-	while( 1 )
+	else
 	{
-		if( !src->ReadToken( &token ) )
+		if( useBinary )
 		{
-			break;
+			common->Printf( "idRenderWorldLocal::InitFromMap: failed to load %s, parsing %s\n", binaryFilename.c_str(), filename.c_str() );
 		}
 
-		if( token == "model" )
+		src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+		if( !src->IsLoaded() )
 		{
-			lastModel = ParseModel( src );
-
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
-
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
+			common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename.c_str() );
+			ClearWorld();
+			return false;
 		}
 
-		if( token == "shadowModel" )
-		{
-			lastModel = ParseShadowModel( src );
 
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
+		mapName = name;
+		mapTimeStamp = currentTimeStamp;
 
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
+		// if we are writing a demo, archive the load command
+		if( session->writeDemo )
+		{
+			WriteLoadMap();
 		}
 
-		if( token == "interAreaPortals" )
+		if( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) )
 		{
-			ParseInterAreaPortals( src );
-			continue;
+			common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
+			delete src;
+			return false;
 		}
 
-		if( token == "nodes" )
+		// parse the file
+		while( 1 )
 		{
-			ParseNodes( src );
-			continue;
+			if( !src->ReadToken( &token ) )
+			{
+				break;
+			}
+
+			if( token == "model" )
+			{
+				lastModel = ParseModel( src );
+
+				// add it to the model manager list
+				renderModelManager->AddModel( lastModel );
+
+				// save it in the list to free when clearing this map
+				localModels.Append( lastModel );
+				continue;
+			}
+
+			if( token == "shadowModel" )
+			{
+				lastModel = ParseShadowModel( src );
+
+				// add it to the model manager list
+				renderModelManager->AddModel( lastModel );
+
+				// save it in the list to free when clearing this map
+				localModels.Append( lastModel );
+				continue;
+			}
+
+			if( token == "interAreaPortals" )
+			{
+				ParseInterAreaPortals( src );
+				continue;
+			}
+
+			if( token == "nodes" )
+			{
+				ParseNodes( src );
+				continue;
+			}
+
+			src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
 		}
 
-		src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
+		delete src;
 	}
 
-	delete src;
-
 	// if it was a trivial map without any areas, create a single area
 	if( !numPortalAreas )
 	{
@@ -650,6 +1154,14 @@ bool idRenderWorldLocal::InitFromMap( const char* name )
 	AddWorldModelEntities();
 	ClearPortalStates();
 
+	// pick up the offline generated static light interactions if present
+	if( r_useInteractionCache.GetBool() )
+	{
+		idStr cacheFilename = name;
+		cacheFilename.SetFileExtension( INTERACTION_CACHE_EXT );
+		interactionCache.Load( cacheFilename );
+	}
+
 	// done!
 	return true;
 }
@@ -668,6 +1180,7 @@ void idRenderWorldLocal::ClearPortalStates()
 	{
 		doublePortals[i].blockingBits = PS_BLOCK_NONE;
 	}
+	portalFlowGeneration++;
 
 	// flood fill all area connections
 	for( i = 0 ; i < numPortalAreas ; i++ )
@@ -56,6 +56,18 @@ typedef struct doublePortal_s
 } doublePortal_t;
 
 
+// world space bounds of all the references in an area, stored as six
+// float arrays padded to CULL_BOUNDS_BATCH so they can be culled in batches
+typedef struct areaCullBounds_s
+{
+	bool			dirty;			// set when a reference is linked or unlinked
+	int				numBounds;		// in the same order as the area reference list
+	int				stride;			// allocated floats per array
+	float* 			bounds;			// minX[stride], minY[], minZ[], maxX[], maxY[], maxZ[]
+	byte* 			cullBits;		// CULL_BOUNDS_* results for the current portal stack
+	idBounds		totalBounds;	// union of all the bounds for culling the whole area at once
+} areaCullBounds_t;
+
 typedef struct portalArea_s
 {
 	int				areaNum;
@@ -65,9 +77,47 @@ typedef struct portalArea_s
 	portal_t* 		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	areaCullBounds_t entityCull;	// rebuilt when entityRefs changes
+	areaCullBounds_t lightCull;		// rebuilt when lightRefs changes
 } portalArea_t;
 
 
+// if we hit this many planes, we will just stop cropping the
+// view down, which is still correct, just conservative
+const int MAX_PORTAL_PLANES	= 20;
+
+// one area visit of a recorded view portal flow, with the planes and
+// scissor rect of the portal stack that reached it
+typedef struct
+{
+	int				areaNum;
+	idScreenRect	rect;
+	int				numPortalPlanes;
+	idPlane			portalPlanes[MAX_PORTAL_PLANES + 1];
+} portalFlowStep_t;
+
+// the view portal flow only depends on the view and the portal states, so
+// the area visits are recorded and replayed while neither of them changes,
+// there is no reuse for a view that moved even slightly
+const int MAX_PORTAL_FLOW_CACHE = 4;	// views rendered each frame, including subviews
+
+typedef struct
+{
+	bool			valid;
+	int				lastUsedFrame;
+	int				generation;				// portalFlowGeneration when recorded
+	int				areaNum;
+	idVec3			origin;
+	int				numPlanes;
+	idPlane			planes[6];
+	float			modelViewMatrix[16];
+	float			projectionMatrix[16];
+	idScreenRect	viewport;
+	idScreenRect	scissor;
+	idList<portalFlowStep_t> steps;
+} portalFlowCache_t;
+
+
 static const int	CHILDREN_HAVE_MULTIPLE_AREAS = -2;
 static const int	AREANUM_SOLID = -1;
 typedef struct
@@ -151,11 +201,17 @@ public:
 
 	idScreenRect* 			areaScreenRect;
 
+	int						portalFlowGeneration;	// incremented when anything the view portal flow depends on changes
+	portalFlowCache_t		portalFlowCache[MAX_PORTAL_FLOW_CACHE];
+	portalFlowCache_t* 		portalFlowRecord;		// the cache entry being recorded by FloodViewThroughArea_r
+
 	doublePortal_t* 		doublePortals;
 	int						numInterAreaPortals;
 
 	idList<idRenderModel*>	localModels;
 
+	idInteractionCache		interactionCache;		// offline generated static light interactions
+
 	idList<idRenderEntityLocal*>	entityDefs;
 	idList<idRenderLightLocal*>		lightDefs;
 
@@ -183,6 +239,11 @@ public:
 	void					SetupAreaRefs();
 	void					ParseInterAreaPortals( idLexer* src );
 	void					ParseNodes( idLexer* src );
+	idRenderModel* 			ReadBinaryModel( idFile* f );
+	idRenderModel* 			ReadBinaryShadowModel( idFile* f );
+	bool					ReadBinaryInterAreaPortals( idFile* f );
+	bool					ReadBinaryNodes( idFile* f );
+	bool					LoadBinaryProc( const char* filename );
 	int						CommonChildrenArea_r( areaNode_t* node );
 	void					FreeWorld();
 	void					ClearWorld();
@@ -199,14 +260,20 @@ public:
 	bool					PortalIsFoggedOut( const portal_t* p );
 	void					FloodViewThroughArea_r( const idVec3 origin, int areaNum, const struct portalStack_s* ps );
 	void					FlowViewThroughPortals( const idVec3 origin, int numPlanes, const idPlane* planes );
+	portalFlowCache_t* 		FindPortalFlowCache( const idVec3& origin, int numPlanes, const idPlane* planes, bool& reused );
+	void					ReplayPortalFlow( const portalFlowCache_t* cache );
+	void					ClearPortalFlowCache();
 	void					FloodLightThroughArea_r( idRenderLightLocal* light, int areaNum, const struct portalStack_s* ps );
 	void					FlowLightThroughPortals( idRenderLightLocal* light );
 	areaNumRef_t* 			FloodFrustumAreas_r( const idFrustum& frustum, const int areaNum, const idBounds& bounds, areaNumRef_t* areas );
 	areaNumRef_t* 			FloodFrustumAreas( const idFrustum& frustum, areaNumRef_t* areas );
 	bool					CullEntityByPortals( const idRenderEntityLocal* entity, const struct portalStack_s* ps );
 	void					AddAreaEntityRefs( int areaNum, const struct portalStack_s* ps );
+	const byte* 			CullAreaEntityBounds( portalArea_t* area, const struct portalStack_s* ps );
 	bool					CullLightByPortals( const idRenderLightLocal* light, const struct portalStack_s* ps );
 	void					AddAreaLightRefs( int areaNum, const struct portalStack_s* ps );
+	const byte* 			CullAreaLightBounds( portalArea_t* area, const struct portalStack_s* ps );
+	void					FreeAreaCullBounds( areaCullBounds_t* cull );
 	void					AddAreaRefs( int areaNum, const struct portalStack_s* ps );
 	void					BuildConnectedAreas_r( int areaNum );
 	void					BuildConnectedAreas();
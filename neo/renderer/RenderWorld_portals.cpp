@@ -41,10 +41,6 @@ in the portal areas that can be seen from the current viewpoint.
 */
 
 
-// if we hit this many planes, we will just stop cropping the
-// view down, which is still correct, just conservative
-const int MAX_PORTAL_PLANES	= 20;
-
 typedef struct portalStack_s
 {
 	portal_t*	p;
@@ -174,6 +170,20 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 
 	area = &portalAreas[ areaNum ];
 
+	tr.pc.c_portalFlowWalks++;
+
+	if( portalFlowRecord )
+	{
+		portalFlowStep_t& step = portalFlowRecord->steps.Alloc();
+		step.areaNum = areaNum;
+		step.rect = ps->rect;
+		step.numPortalPlanes = ps->numPortalPlanes;
+		for( i = 0 ; i < ps->numPortalPlanes ; i++ )
+		{
+			step.portalPlanes[i] = ps->portalPlanes[i];
+		}
+	}
+
 	// cull models and lights to the current collection of planes
 	AddAreaRefs( areaNum, ps );
 
@@ -243,6 +253,12 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 			continue;	// portal not visible
 		}
 
+		// fog density can change every frame, so a flow that depends on it can't be replayed
+		if( portalFlowRecord && p->doublePortal->fogLight )
+		{
+			portalFlowRecord->valid = false;
+		}
+
 		// see if it is fogged out
 		if( PortalIsFoggedOut( p ) )
 		{
@@ -349,11 +365,172 @@ void idRenderWorldLocal::FlowViewThroughPortals( const idVec3 origin, int numPla
 			areaScreenRect[i].Clear();
 		}
 
+		bool reused;
+		portalFlowCache_t* cache = FindPortalFlowCache( origin, numPlanes, planes, reused );
+
+		if( reused )
+		{
+			tr.pc.c_portalFlowReused++;
+			ReplayPortalFlow( cache );
+			return;
+		}
+
 		// flood out through portals, setting area viewCount
+		portalFlowRecord = cache;
 		FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+		portalFlowRecord = NULL;
 	}
 }
 
+/*
+=======================
+idRenderWorldLocal::FindPortalFlowCache
+
+Returns the cache entry recorded for the current view, or the entry the
+flow should be recorded into, which may be NULL if caching is disabled.
+
+Only a view that is exactly unchanged reuses a flow, such as a static camera,
+a paused game or a subview rendered again with the same parms. A moved view
+always floods again: its portal planes pass through the new origin, and it
+can see through portals the recorded flow never reached.
+=======================
+*/
+portalFlowCache_t* idRenderWorldLocal::FindPortalFlowCache( const idVec3& origin, int numPlanes, const idPlane* planes, bool& reused )
+{
+	portalFlowCache_t*	cache;
+	portalFlowCache_t*	oldest;
+	int					i, j;
+
+	reused = false;
+
+	if( !r_usePortalFlowCache.GetBool() || numPlanes > 6 )
+	{
+		return NULL;
+	}
+
+	oldest = NULL;
+	for( i = 0 ; i < MAX_PORTAL_FLOW_CACHE ; i++ )
+	{
+		cache = &portalFlowCache[i];
+
+		// prefer an unused entry for recording, then the least recently used one
+		if( !oldest || ( oldest->valid && ( !cache->valid || cache->lastUsedFrame < oldest->lastUsedFrame ) ) )
+		{
+			oldest = cache;
+		}
+
+		if( !cache->valid || cache->generation != portalFlowGeneration )
+		{
+			continue;
+		}
+		if( cache->areaNum != tr.viewDef->areaNum || cache->numPlanes != numPlanes || cache->origin != origin )
+		{
+			continue;
+		}
+		if( !cache->viewport.Equals( tr.viewDef->viewport ) || !cache->scissor.Equals( tr.viewDef->scissor ) )
+		{
+			continue;
+		}
+		if( memcmp( cache->modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( cache->modelViewMatrix ) ) != 0 ||
+				memcmp( cache->projectionMatrix, tr.viewDef->projectionMatrix, sizeof( cache->projectionMatrix ) ) != 0 )
+		{
+			continue;
+		}
+		for( j = 0 ; j < numPlanes ; j++ )
+		{
+			if( cache->planes[j] != planes[j] )
+			{
+				break;
+			}
+		}
+		if( j < numPlanes )
+		{
+			continue;
+		}
+
+		cache->lastUsedFrame = tr.frameCount;
+		reused = true;
+		return cache;
+	}
+
+	// record into the least recently used entry
+	cache = oldest;
+	cache->valid = true;
+	cache->lastUsedFrame = tr.frameCount;
+	cache->generation = portalFlowGeneration;
+	cache->areaNum = tr.viewDef->areaNum;
+	cache->origin = origin;
+	cache->numPlanes = numPlanes;
+	for( j = 0 ; j < numPlanes ; j++ )
+	{
+		cache->planes[j] = planes[j];
+	}
+	memcpy( cache->modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( cache->modelViewMatrix ) );
+	memcpy( cache->projectionMatrix, tr.viewDef->projectionMatrix, sizeof( cache->projectionMatrix ) );
+	cache->viewport = tr.viewDef->viewport;
+	cache->scissor = tr.viewDef->scissor;
+	cache->steps.SetNum( 0, false );
+
+	return cache;
+}
+
+/*
+=======================
+idRenderWorldLocal::ReplayPortalFlow
+
+Adds the area refs exactly as FloodViewThroughArea_r did when the flow was recorded,
+without clipping any portal windings.
+=======================
+*/
+void idRenderWorldLocal::ReplayPortalFlow( const portalFlowCache_t* cache )
+{
+	portalStack_t	ps;
+	int				i, j;
+
+	ps.p = NULL;
+	ps.next = NULL;
+
+	for( i = 0 ; i < cache->steps.Num() ; i++ )
+	{
+		const portalFlowStep_t& step = cache->steps[i];
+
+		ps.rect = step.rect;
+		ps.numPortalPlanes = step.numPortalPlanes;
+		for( j = 0 ; j < step.numPortalPlanes ; j++ )
+		{
+			ps.portalPlanes[j] = step.portalPlanes[j];
+		}
+
+		AddAreaRefs( step.areaNum, &ps );
+
+		if( areaScreenRect[step.areaNum].IsEmpty() )
+		{
+			areaScreenRect[step.areaNum] = step.rect;
+		}
+		else
+		{
+			areaScreenRect[step.areaNum].Union( step.rect );
+		}
+	}
+}
+
+/*
+=======================
+idRenderWorldLocal::ClearPortalFlowCache
+=======================
+*/
+void idRenderWorldLocal::ClearPortalFlowCache()
+{
+	for( int i = 0 ; i < MAX_PORTAL_FLOW_CACHE ; i++ )
+	{
+		portalFlowCache[i].valid = false;
+		portalFlowCache[i].lastUsedFrame = 0;
+		portalFlowCache[i].steps.Clear();
+	}
+	portalFlowRecord = NULL;
+	portalFlowGeneration++;
+}
+
 //==================================================================================================
 
 
@@ -650,6 +827,179 @@ bool idRenderWorldLocal::CullEntityByPortals( const idRenderEntityLocal* entity,
 	return false;
 }
 
+/*
+================
+R_AllocAreaCullBounds
+
+Makes room for numBounds bounds, padded to full CULL_BOUNDS_BATCH batches.
+================
+*/
+static void R_AllocAreaCullBounds( areaCullBounds_t* cull, int numBounds )
+{
+	int stride = ( numBounds + CULL_BOUNDS_BATCH - 1 ) & ~( CULL_BOUNDS_BATCH - 1 );
+
+	cull->numBounds = numBounds;
+
+	if( stride > cull->stride )
+	{
+		if( cull->bounds )
+		{
+			R_StaticFree( cull->bounds );
+			R_StaticFree( cull->cullBits );
+		}
+		cull->stride = stride;
+		cull->bounds = ( float* )R_StaticAlloc( 6 * stride * sizeof( cull->bounds[0] ) );
+		cull->cullBits = ( byte* )R_StaticAlloc( stride * sizeof( cull->cullBits[0] ) );
+	}
+
+	// the padding is culled along with the real bounds, so keep it valid
+	for( int i = numBounds ; i < stride ; i++ )
+	{
+		for( int j = 0 ; j < 6 ; j++ )
+		{
+			cull->bounds[j * cull->stride + i] = 0.0f;
+		}
+	}
+
+	cull->totalBounds.Clear();
+}
+
+/*
+================
+R_SetAreaCullBounds
+================
+*/
+static void R_SetAreaCullBounds( areaCullBounds_t* cull, int index, const idBounds& bounds )
+{
+	for( int j = 0 ; j < 3 ; j++ )
+	{
+		cull->bounds[j * cull->stride + index] = bounds[0][j];
+		cull->bounds[( 3 + j ) * cull->stride + index] = bounds[1][j];
+	}
+	cull->totalBounds.AddBounds( bounds );
+}
+
+/*
+================
+R_CullAreaBounds
+
+Classifies all the bounds of the area, trying the union of them first.
+================
+*/
+static const byte* R_CullAreaBounds( areaCullBounds_t* cull, int numPlanes, const idPlane* planes )
+{
+	int		i, side;
+	bool	allIn;
+
+	if( cull->numBounds == 0 )
+	{
+		return cull->cullBits;
+	}
+
+	allIn = true;
+	for( i = 0 ; i < numPlanes ; i++ )
+	{
+		side = cull->totalBounds.PlaneSide( planes[i], CULL_BOUNDS_EPSILON );
+		if( side == PLANESIDE_FRONT )
+		{
+			memset( cull->cullBits, CULL_BOUNDS_OUT, cull->numBounds );
+			return cull->cullBits;
+		}
+		if( side != PLANESIDE_BACK )
+		{
+			allIn = false;
+		}
+	}
+
+	if( allIn )
+	{
+		memset( cull->cullBits, CULL_BOUNDS_IN, cull->numBounds );
+		return cull->cullBits;
+	}
+
+	R_CullBoundsSoA( cull->cullBits, cull->bounds, cull->stride, cull->numBounds, numPlanes, planes );
+
+	return cull->cullBits;
+}
+
+/*
+================
+idRenderWorldLocal::FreeAreaCullBounds
+================
+*/
+void idRenderWorldLocal::FreeAreaCullBounds( areaCullBounds_t* cull )
+{
+	if( cull->bounds )
+	{
+		R_StaticFree( cull->bounds );
+		R_StaticFree( cull->cullBits );
+	}
+	cull->dirty = true;
+	cull->numBounds = 0;
+	cull->stride = 0;
+	cull->bounds = NULL;
+	cull->cullBits = NULL;
+	cull->totalBounds.Clear();
+}
+
+/*
+================
+idRenderWorldLocal::CullAreaEntityBounds
+
+Returns a CULL_BOUNDS_* value for each entity reference of the area in list order,
+or NULL if every reference has to go through CullEntityByPortals.
+================
+*/
+const byte* idRenderWorldLocal::CullAreaEntityBounds( portalArea_t* area, const portalStack_t* ps )
+{
+	areaCullBounds_t*	cull;
+	areaReference_t*	ref;
+	idVec3				v, transformed;
+	idBounds			b;
+	int					i, numRefs;
+
+	// the batch results are only guaranteed to match the corner cull
+	if( !r_useBatchCulling.GetBool() || !r_useEntityCulling.GetBool() || r_useCulling.GetInteger() < 2 )
+	{
+		return NULL;
+	}
+
+	cull = &area->entityCull;
+
+	if( cull->dirty )
+	{
+		numRefs = 0;
+		for( ref = area->entityRefs.areaNext ; ref != &area->entityRefs ; ref = ref->areaNext )
+		{
+			numRefs++;
+		}
+
+		R_AllocAreaCullBounds( cull, numRefs );
+
+		// bound the same transformed corners R_CornerCullLocalBox tests
+		for( i = 0, ref = area->entityRefs.areaNext ; ref != &area->entityRefs ; ref = ref->areaNext, i++ )
+		{
+			const idRenderEntityLocal* entity = ref->entity;
+
+			b.Clear();
+			for( int j = 0 ; j < 8 ; j++ )
+			{
+				v[0] = entity->referenceBounds[j & 1][0];
+				v[1] = entity->referenceBounds[( j >> 1 ) & 1][1];
+				v[2] = entity->referenceBounds[( j >> 2 ) & 1][2];
+
+				R_LocalPointToGlobal( entity->modelMatrix, v, transformed );
+				b.AddPoint( transformed );
+			}
+			R_SetAreaCullBounds( cull, i, b );
+		}
+
+		cull->dirty = false;
+	}
+
+	return R_CullAreaBounds( cull, ps->numPortalPlanes, ps->portalPlanes );
+}
+
 /*
 ===================
 AddAreaEntityRefs
@@ -665,10 +1015,14 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t* ps
 	portalArea_t*		area;
 	viewEntity_t*		vEnt;
 	idBounds			b;
+	const byte*			cullBits;
+	int					refNum;
 
 	area = &portalAreas[ areaNum ];
 
-	for( ref = area->entityRefs.areaNext ; ref != &area->entityRefs ; ref = ref->areaNext )
+	cullBits = CullAreaEntityBounds( area, ps );
+
+	for( ref = area->entityRefs.areaNext, refNum = 0 ; ref != &area->entityRefs ; ref = ref->areaNext, refNum++ )
 	{
 		entity = ref->entity;
 
@@ -696,8 +1050,17 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t* ps
 			}
 		}
 
-		// cull reference bounds
-		if( CullEntityByPortals( entity, ps ) )
+		// cull reference bounds, using the batch results when they are conclusive
+		if( cullBits && cullBits[refNum] == CULL_BOUNDS_OUT )
+		{
+			tr.pc.c_box_cull_out++;
+			continue;
+		}
+		if( cullBits && cullBits[refNum] == CULL_BOUNDS_IN )
+		{
+			tr.pc.c_box_cull_in++;
+		}
+		else if( CullEntityByPortals( entity, ps ) )
 		{
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
@@ -805,6 +1168,50 @@ bool idRenderWorldLocal::CullLightByPortals( const idRenderLightLocal* light, co
 	return false;
 }
 
+/*
+================
+idRenderWorldLocal::CullAreaLightBounds
+
+Returns a CULL_BOUNDS_* value for each light reference of the area in list order,
+or NULL if every reference has to go through CullLightByPortals.
+================
+*/
+const byte* idRenderWorldLocal::CullAreaLightBounds( portalArea_t* area, const portalStack_t* ps )
+{
+	areaCullBounds_t*	cull;
+	areaReference_t*	lref;
+	int					i, numRefs;
+
+	if( !r_useBatchCulling.GetBool() || r_useLightCulling.GetInteger() == 0 )
+	{
+		return NULL;
+	}
+
+	cull = &area->lightCull;
+
+	if( cull->dirty )
+	{
+		numRefs = 0;
+		for( lref = area->lightRefs.areaNext ; lref != &area->lightRefs ; lref = lref->areaNext )
+		{
+			numRefs++;
+		}
+
+		R_AllocAreaCullBounds( cull, numRefs );
+
+		// the frustum windings share the frustumTris verts, so this bounds both tests
+		for( i = 0, lref = area->lightRefs.areaNext ; lref != &area->lightRefs ; lref = lref->areaNext, i++ )
+		{
+			R_SetAreaCullBounds( cull, i, lref->light->frustumTris->bounds );
+		}
+
+		cull->dirty = false;
+	}
+
+	// the last stack plane is not used because lights are not near clipped
+	return R_CullAreaBounds( cull, ps->numPortalPlanes - 1, ps->portalPlanes );
+}
+
 /*
 ===================
 AddAreaLightRefs
@@ -818,10 +1225,14 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t* ps
 	portalArea_t*		area;
 	idRenderLightLocal*			light;
 	viewLight_t*			vLight;
+	const byte*			cullBits;
+	int					refNum;
 
 	area = &portalAreas[ areaNum ];
 
-	for( lref = area->lightRefs.areaNext ; lref != &area->lightRefs ; lref = lref->areaNext )
+	cullBits = CullAreaLightBounds( area, ps );
+
+	for( lref = area->lightRefs.areaNext, refNum = 0 ; lref != &area->lightRefs ; lref = lref->areaNext, refNum++ )
 	{
 		light = lref->light;
 
@@ -840,8 +1251,21 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t* ps
 			continue;
 		}
 
-		// cull frustum
-		if( CullLightByPortals( light, ps ) )
+		// cull frustum, using the batch results when they are conclusive
+		if( cullBits && cullBits[refNum] == CULL_BOUNDS_OUT )
+		{
+			if( r_useLightCulling.GetInteger() == 1 )
+			{
+				tr.pc.c_box_cull_out++;
+			}
+			continue;
+		}
+
+		// a light completely inside the portal stack is only known to be
+		// visible for the point check, the exact clip only tests back faces
+		bool exactCull = ( cullBits == NULL || cullBits[refNum] == CULL_BOUNDS_CLIP || r_useLightCulling.GetInteger() >= 2 );
+
+		if( exactCull && CullLightByPortals( light, ps ) )
 		{
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
@@ -1128,6 +1552,7 @@ void		idRenderWorldLocal::SetPortalState( qhandle_t portal, int blockTypes )
 		return;
 	}
 	doublePortals[portal - 1].blockingBits = blockTypes;
+	portalFlowGeneration++;
 
 	// leave the connectedAreaGroup the same on one side,
 	// then flood fill from the other side with a new number for each changed attribute
@@ -1093,6 +1093,41 @@ static void R_EyeballDeform( drawSurf_t* surf )
 //==========================================================================================
 
 
+/*
+=====================
+R_CreateParticlesJob
+
+Creates the verts of one particle stage, the stages are independent
+of each other, so they can be run on the job threads.
+=====================
+*/
+void R_CreateParticlesJob( void* parms )
+{
+	particleJob_t* job = ( particleJob_t* )parms;
+
+	job->tri->numVerts = job->stage->CreateParticles( job->gens, job->numGens, job->tri->verts );
+}
+
+/*
+=====================
+R_RunParticleJobs
+=====================
+*/
+void R_RunParticleJobs( particleJob_t* jobs, int numJobs, int numParticles )
+{
+	if( r_useParticleJobs.GetBool() && numParticles >= r_particleJobThreshold.GetInteger() )
+	{
+		Sys_RunJobs( R_CreateParticlesJob, jobs, sizeof( jobs[0] ), numJobs );
+	}
+	else
+	{
+		for( int i = 0 ; i < numJobs ; i++ )
+		{
+			R_CreateParticlesJob( &jobs[i] );
+		}
+	}
+}
+
 /*
 =====================
 R_ParticleDeform
@@ -1151,6 +1186,13 @@ static void R_ParticleDeform( drawSurf_t* surf, bool useArea )
 	g.origin.Zero();
 	g.axis = mat3_identity;
 
+	// the spawn state of all the live particles is gathered first, so the
+	// expensive part of creating them can be done for whole stages at once
+	int				maxJobs = ( ( useArea ) ? 1 : numSourceTris ) * particleSystem->stages.Num();
+	particleJob_t*	jobs = ( particleJob_t* )R_FrameAlloc( maxJobs * sizeof( jobs[0] ) );
+	int				numJobs = 0;
+	int				numParticles = 0;
+
 	for( int currentTri = 0; currentTri < ( ( useArea ) ? 1 : numSourceTris ); currentTri++ )
 	{
 
@@ -1191,6 +1233,12 @@ static void R_ParticleDeform( drawSurf_t* surf, bool useArea )
 
 			tri->numVerts = 0;
 
+			particleJob_t* job = &jobs[numJobs++];
+			job->stage = stage;
+			job->gens = ( particleGen_t* )R_FrameAlloc( Max( totalParticles, 1 ) * sizeof( job->gens[0] ) );
+			job->numGens = 0;
+			job->tri = tri;
+
 			idRandom	steppingRandom, steppingRandom2;
 
 			int stageAge = g.renderView->time + renderEntity->shaderParms[SHADERPARM_TIMEOFFSET] * 1000 - stage->timeOffset * 1000;
@@ -1295,32 +1343,41 @@ static void R_ParticleDeform( drawSurf_t* surf, bool useArea )
 
 				g.age = g.frac * stage->particleLife;
 
-				// if the particle doesn't get drawn because it is faded out or beyond a kill region,
-				// don't increment the verts
-				tri->numVerts += stage->CreateParticle( &g, tri->verts + tri->numVerts );
+				// the particle is created later, and if it is faded out or beyond
+				// a kill region it won't get any verts
+				job->gens[job->numGens++] = g;
 			}
 
-			if( tri->numVerts > 0 )
+			numParticles += job->numGens;
+		}
+	}
+
+	R_RunParticleJobs( jobs, numJobs, numParticles );
+
+	for( int jobNum = 0 ; jobNum < numJobs ; jobNum++ )
+	{
+		srfTriangles_t* tri = jobs[jobNum].tri;
+
+		if( tri->numVerts > 0 )
+		{
+			// build the index list
+			int	indexes = 0;
+			for( int i = 0 ; i < tri->numVerts ; i += 4 )
 			{
-				// build the index list
-				int	indexes = 0;
-				for( int i = 0 ; i < tri->numVerts ; i += 4 )
-				{
-					tri->indexes[indexes + 0] = i;
-					tri->indexes[indexes + 1] = i + 2;
-					tri->indexes[indexes + 2] = i + 3;
-					tri->indexes[indexes + 3] = i;
-					tri->indexes[indexes + 4] = i + 3;
-					tri->indexes[indexes + 5] = i + 1;
-					indexes += 6;
-				}
-				tri->numIndexes = indexes;
-				tri->ambientCache = vertexCache.AllocFrameTemp( tri->verts, tri->numVerts * sizeof( idDrawVert ) );
-				if( tri->ambientCache )
-				{
-					// add the drawsurf
-					R_AddDrawSurf( tri, surf->space, renderEntity, stage->material, surf->scissorRect );
-				}
+				tri->indexes[indexes + 0] = i;
+				tri->indexes[indexes + 1] = i + 2;
+				tri->indexes[indexes + 2] = i + 3;
+				tri->indexes[indexes + 3] = i;
+				tri->indexes[indexes + 4] = i + 3;
+				tri->indexes[indexes + 5] = i + 1;
+				indexes += 6;
+			}
+			tri->numIndexes = indexes;
+			tri->ambientCache = vertexCache.AllocFrameTemp( tri->verts, tri->numVerts * sizeof( idDrawVert ) );
+			if( tri->ambientCache )
+			{
+				// add the drawsurf
+				R_AddDrawSurf( tri, surf->space, renderEntity, jobs[jobNum].stage->material, surf->scissorRect );
 			}
 		}
 	}
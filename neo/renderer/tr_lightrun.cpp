@@ -643,6 +643,7 @@ void R_CreateLightDefFogPortals( idRenderLightLocal* ldef )
 			if( WindingCompletelyInsideLight( prt->w, ldef ) )
 			{
 				dp->fogLight = ldef;
+				ldef->world->portalFlowGeneration++;
 				dp->nextFoggedPortal = ldef->foggedPortals;
 				ldef->foggedPortals = dp;
 			}
@@ -681,6 +682,7 @@ void R_FreeLightDefDerivedData( idRenderLightLocal* ldef )
 		// unlink from the area
 		lref->areaNext->areaPrev = lref->areaPrev;
 		lref->areaPrev->areaNext = lref->areaNext;
+		lref->area->lightCull.dirty = true;
 
 		// put it back on the free list for reuse
 		ldef->world->areaReferenceAllocator.Free( lref );
@@ -759,6 +761,7 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal* def, bool keepDecals, bool
 		// unlink from the area
 		ref->areaNext->areaPrev = ref->areaPrev;
 		ref->areaPrev->areaNext = ref->areaNext;
+		ref->area->entityCull.dirty = true;
 
 		// put it back on the free list for reuse
 		def->world->areaReferenceAllocator.Free( ref );
@@ -592,9 +592,13 @@ typedef struct
 {
 	int		c_sphere_cull_in, c_sphere_cull_clip, c_sphere_cull_out;
 	int		c_box_cull_in, c_box_cull_out;
+	int		c_portalFlowWalks;		// areas entered by FloodViewThroughArea_r
+	int		c_portalFlowReused;		// views that replayed a cached portal flow
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createLightTris;
 	int		c_createShadowVolumes;
+	int		c_cachedLightTris;		// light tris and shadow volumes taken from the static interaction cache
+	int		c_cachedShadowVolumes;
 	int		c_generateMd5;
 	int		c_entityDefCallbacks;
 	int		c_alloc, c_free;	// counts for R_StaticAllc/R_StaticFree
@@ -913,6 +917,10 @@ extern idCVar r_useIndexBuffers;		// if 0, don't use ARB_vertex_buffer_object fo
 extern idCVar r_useEntityCallbacks;		// if 0, issue the callback immediately at update time, rather than defering
 extern idCVar r_lightAllBackFaces;		// light all the back faces, even when they would be shadowed
 extern idCVar r_useDepthBoundsTest;     // use depth bounds test to reduce shadow fill
+extern idCVar r_useBinaryProc;			// load .bproc files instead of parsing .proc files when up to date
+extern idCVar r_useInteractionCache;	// use the offline generated static light interactions
+extern idCVar r_usePortalFlowCache;	// replay the view portal flow while the view and portal states are unchanged
+extern idCVar r_useBatchCulling;		// classify all entity and light references of an area at once before the exact culling
 
 extern idCVar r_skipPostProcess;		// skip all post-process renderings
 extern idCVar r_skipSuppress;			// ignore the per-view suppressions
@@ -930,6 +938,8 @@ extern idCVar r_skipFogLights;			// skip all fog lights
 extern idCVar r_skipSubviews;			// 1 = don't render any mirrors / cameras / etc
 extern idCVar r_skipGuiShaders;			// 1 = don't render any gui elements on surfaces
 extern idCVar r_skipParticles;			// 1 = don't render any particles
+extern idCVar r_useParticleJobs;		// create the particle stages on the job threads
+extern idCVar r_particleJobThreshold;	// minimum number of particles to use the job threads
 extern idCVar r_skipUpdates;			// 1 = don't accept any entity or light updates, making everything static
 extern idCVar r_skipDeforms;			// leave all deform materials in their original state
 extern idCVar r_skipDynamicTextures;	// don't dynamically create textures
@@ -939,6 +949,7 @@ extern idCVar r_skipSpecular;			// use black for specular
 extern idCVar r_skipDiffuse;			// use black for diffuse
 extern idCVar r_skipOverlays;			// skip overlay surfaces
 extern idCVar r_skipROQ;
+extern idCVar r_cinematicDecodeAhead;	// decode playing cinematics ahead on the cinematic thread
 
 extern idCVar r_ignoreGLErrors;
 
@@ -1166,6 +1177,15 @@ bool R_CullLocalBox( const idBounds& bounds, const float modelMatrix[16], int nu
 bool R_RadiusCullLocalBox( const idBounds& bounds, const float modelMatrix[16], int numPlanes, const idPlane* planes );
 bool R_CornerCullLocalBox( const idBounds& bounds, const float modelMatrix[16], int numPlanes, const idPlane* planes );
 
+// classifies batches of world space bounds stored as six padded float arrays
+// (minX, minY, minZ, maxX, maxY, maxZ) against a set of planes (positive sides are out)
+static const int CULL_BOUNDS_BATCH	= 8;
+static const byte CULL_BOUNDS_CLIP	= 0;	// needs the exact per def test
+static const byte CULL_BOUNDS_OUT	= 1;	// completely on the positive side of at least one plane
+static const byte CULL_BOUNDS_IN	= 2;	// completely on the negative side of all planes
+static const float CULL_BOUNDS_EPSILON = 1.0f;	// keeps the batch results conservative with respect to the exact tests
+void R_CullBoundsSoA( byte* cullBits, const float* soaBounds, int stride, int numBounds, int numPlanes, const idPlane* planes );
+
 void R_AxisToModelMatrix( const idMat3& axis, const idVec3& origin, float modelMatrix[16] );
 
 // note that many of these assume a normalized matrix, and will not work with scaled axis
@@ -1682,6 +1702,18 @@ TR_DEFORM
 
 void R_DeformDrawSurf( drawSurf_t* drawSurf );
 
+// the particles of one stage, gathered on the main thread and created on the job threads
+typedef struct
+{
+	const idParticleStage* 	stage;
+	particleGen_t* 			gens;
+	int						numGens;
+	srfTriangles_t* 		tri;			// tri->verts receives the particles and tri->numVerts is set
+} particleJob_t;
+
+void R_CreateParticlesJob( void* parms );
+void R_RunParticleJobs( particleJob_t* jobs, int numJobs, int numParticles );
+
 /*
 =============================================================
 
@@ -36,6 +36,10 @@ If you have questions concerning this license or the applicable additional terms
 #if defined(MACOS_X) && defined(__i386__)
 	#include <xmmintrin.h>
 #endif
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+	#define CULL_BOUNDS_SSE
+	#include <xmmintrin.h>
+#endif
 
 //====================================================================
 
@@ -751,6 +755,117 @@ bool R_CullLocalBox( const idBounds& bounds, const float modelMatrix[16], int nu
 	return R_CornerCullLocalBox( bounds, modelMatrix, numPlanes, planes );
 }
 
+/*
+=================
+R_CullBoundsSoA
+
+Classifies numBounds world space bounds against the planes, CULL_BOUNDS_BATCH at a time.
+The bounds are stored as six float arrays of stride floats each, and stride must be
+a multiple of CULL_BOUNDS_BATCH with valid bounds in the padding.
+A bounds is CULL_BOUNDS_OUT when it is completely in front of at least one plane, and
+CULL_BOUNDS_IN when it is completely behind all the planes, both with CULL_BOUNDS_EPSILON
+to spare, so the exact tests will always agree. Everything else is CULL_BOUNDS_CLIP.
+=================
+*/
+void R_CullBoundsSoA( byte* cullBits, const float* soaBounds, int stride, int numBounds, int numPlanes, const idPlane* planes )
+{
+	int				i, j, k;
+	int				outBits, clipBits;
+	const float*	mins[3];
+	const float*	maxs[3];
+	const float*	nearest[3];
+	const float*	farthest[3];
+
+	assert( ( stride % CULL_BOUNDS_BATCH ) == 0 && numBounds <= stride );
+
+	for( k = 0 ; k < 3 ; k++ )
+	{
+		mins[k] = soaBounds + k * stride;
+		maxs[k] = soaBounds + ( 3 + k ) * stride;
+	}
+
+	for( i = 0 ; i < numBounds ; i += CULL_BOUNDS_BATCH )
+	{
+#ifdef CULL_BOUNDS_SSE
+		const __m128 epsilon = _mm_set1_ps( CULL_BOUNDS_EPSILON );
+		const __m128 negEpsilon = _mm_set1_ps( -CULL_BOUNDS_EPSILON );
+		__m128 out0 = _mm_setzero_ps();
+		__m128 out1 = _mm_setzero_ps();
+		__m128 clip0 = _mm_setzero_ps();
+		__m128 clip1 = _mm_setzero_ps();
+
+		for( j = 0 ; j < numPlanes ; j++ )
+		{
+			const idPlane& plane = planes[j];
+
+			// the corner nearest to the negative side decides if the bounds is out,
+			// the farthest one decides if it is completely in
+			for( k = 0 ; k < 3 ; k++ )
+			{
+				nearest[k] = ( plane[k] > 0.0f ) ? mins[k] : maxs[k];
+				farthest[k] = ( plane[k] > 0.0f ) ? maxs[k] : mins[k];
+			}
+
+			const __m128 a = _mm_set1_ps( plane[0] );
+			const __m128 b = _mm_set1_ps( plane[1] );
+			const __m128 c = _mm_set1_ps( plane[2] );
+			const __m128 d = _mm_set1_ps( plane[3] );
+
+			__m128 near0 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_loadu_ps( nearest[0] + i + 0 ) ), _mm_mul_ps( b, _mm_loadu_ps( nearest[1] + i + 0 ) ) ), _mm_mul_ps( c, _mm_loadu_ps( nearest[2] + i + 0 ) ) ), d );
+			__m128 near1 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_loadu_ps( nearest[0] + i + 4 ) ), _mm_mul_ps( b, _mm_loadu_ps( nearest[1] + i + 4 ) ) ), _mm_mul_ps( c, _mm_loadu_ps( nearest[2] + i + 4 ) ) ), d );
+			__m128 far0 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_loadu_ps( farthest[0] + i + 0 ) ), _mm_mul_ps( b, _mm_loadu_ps( farthest[1] + i + 0 ) ) ), _mm_mul_ps( c, _mm_loadu_ps( farthest[2] + i + 0 ) ) ), d );
+			__m128 far1 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, _mm_loadu_ps( farthest[0] + i + 4 ) ), _mm_mul_ps( b, _mm_loadu_ps( farthest[1] + i + 4 ) ) ), _mm_mul_ps( c, _mm_loadu_ps( farthest[2] + i + 4 ) ) ), d );
+
+			out0 = _mm_or_ps( out0, _mm_cmpgt_ps( near0, epsilon ) );
+			out1 = _mm_or_ps( out1, _mm_cmpgt_ps( near1, epsilon ) );
+			clip0 = _mm_or_ps( clip0, _mm_cmpge_ps( far0, negEpsilon ) );
+			clip1 = _mm_or_ps( clip1, _mm_cmpge_ps( far1, negEpsilon ) );
+		}
+
+		outBits = _mm_movemask_ps( out0 ) | ( _mm_movemask_ps( out1 ) << 4 );
+		clipBits = _mm_movemask_ps( clip0 ) | ( _mm_movemask_ps( clip1 ) << 4 );
+#else
+		outBits = 0;
+		clipBits = 0;
+
+		for( j = 0 ; j < numPlanes ; j++ )
+		{
+			const idPlane& plane = planes[j];
+
+			for( k = 0 ; k < 3 ; k++ )
+			{
+				nearest[k] = ( plane[k] > 0.0f ) ? mins[k] : maxs[k];
+				farthest[k] = ( plane[k] > 0.0f ) ? maxs[k] : mins[k];
+			}
+
+			for( k = 0 ; k < CULL_BOUNDS_BATCH ; k++ )
+			{
+				float dNear = plane[0] * nearest[0][i + k] + plane[1] * nearest[1][i + k] + plane[2] * nearest[2][i + k] + plane[3];
+				float dFar = plane[0] * farthest[0][i + k] + plane[1] * farthest[1][i + k] + plane[2] * farthest[2][i + k] + plane[3];
+				outBits |= ( dNear > CULL_BOUNDS_EPSILON ) << k;
+				clipBits |= ( dFar >= -CULL_BOUNDS_EPSILON ) << k;
+			}
+		}
+#endif
+
+		for( k = 0 ; k < CULL_BOUNDS_BATCH ; k++ )
+		{
+			if( outBits & ( 1 << k ) )
+			{
+				cullBits[i + k] = CULL_BOUNDS_OUT;
+			}
+			else if( clipBits & ( 1 << k ) )
+			{
+				cullBits[i + k] = CULL_BOUNDS_CLIP;
+			}
+			else
+			{
+				cullBits[i + k] = CULL_BOUNDS_IN;
+			}
+		}
+	}
+}
+
 /*
 ==========================
 R_TransformModelToClip
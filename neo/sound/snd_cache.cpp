@@ -335,6 +335,9 @@ idSoundSample::idSoundSample()
 	onDemand = false;
 	purged = false;
 	levelLoadReferenced = false;
+	decodeHits = 0;
+	decodeMisses = 0;
+	decodeMsec = 0.0f;
 }
 
 /*
@@ -494,8 +497,27 @@ Loads based on name, possibly doing a MakeDefault if necessary
 */
 void idSoundSample::Load()
 {
-	defaultSound = false;
+	// the decode thread skips purged samples, so keep it away from
+	// nonCacheData until the data is complete
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+	purged = true;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+	LoadData();
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 	purged = false;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+}
+
+/*
+===================
+idSoundSample::LoadData
+===================
+*/
+void idSoundSample::LoadData()
+{
+	defaultSound = false;
 	hardwareBuffer = false;
 
 	timestamp = GetNewTimeStamp();
@@ -767,8 +789,11 @@ void idSoundSample::PurgeSoundSample()
 
 	if( nonCacheData )
 	{
+		// the decode thread checks purged before it reads the data
+		Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 		soundCacheAllocator.Free( nonCacheData );
 		nonCacheData = NULL;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
 	}
 }
 
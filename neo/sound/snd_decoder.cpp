@@ -309,6 +309,30 @@ int idWaveFile::CloseOGG()
 ===================================================================================
 */
 
+/*
+===================================================================================
+
+  OGG channels are decoded ahead of the mixer by a thread of their own. After each
+  request the decoder expects the next one to continue where it ended with the same
+  length, and the thread decodes up to DECODE_AHEAD_BLOCKS of those into blocks from
+  a pool of s_decodeAheadBlocks. A request that doesn't match the first block ahead
+  drops them and is decoded on the mixer thread as before. All of it is guarded by
+  CRITICAL_SECTION_ONE, which the decoders already lock around the OGG streams.
+
+===================================================================================
+*/
+
+const int DECODE_AHEAD_BLOCKS				= 3;
+const int DECODE_BLOCK_SAMPLES				= MIXBUFFER_SAMPLES * 2;	// a stereo mix buffer
+
+typedef struct decodeBlock_s
+{
+	int						offset44k;
+	int						readSamples44k;
+	float* 					samples;
+	struct decodeBlock_s* 	next;				// in the free list
+} decodeBlock_t;
+
 class idSampleDecoderLocal : public idSampleDecoder
 {
 public:
@@ -321,6 +345,16 @@ public:
 	int						DecodePCM( idSoundSample* sample, int sampleOffset44k, int sampleCount44k, float* dest );
 	int						DecodeOGG( idSoundSample* sample, int sampleOffset44k, int sampleCount44k, float* dest );
 
+	bool					NeedsDecodeAhead() const;
+	void					DecodeAheadBlock();
+	void					StartDecodeAhead( idSoundSample* sample, int sampleOffset44k, int sampleCount44k );
+	void					StopDecodeAhead();
+
+	static int				DecodeAheadThread( void* parm );
+
+	idSampleDecoderLocal* 	aheadNext;			// in the list the decode thread works through
+	idSampleDecoderLocal* 	aheadPrev;
+
 private:
 	bool					failed;				// set if decoding failed
 	int						lastFormat;			// last format being decoded
@@ -330,10 +364,22 @@ private:
 	idFile_Memory			file;				// encoded file in memory
 
 	OggVorbis_File			ogg;				// OggVorbis file
+
+	bool					aheadFailed;		// stop decoding ahead until the mixer catches up
+	int						aheadOffset44k;		// where the next block ahead starts
+	int						aheadCount44k;		// length of the blocks ahead
+	int						numAheadBlocks;
+	decodeBlock_t* 			aheadBlocks[DECODE_AHEAD_BLOCKS];
 };
 
 idBlockAlloc<idSampleDecoderLocal, 64>		sampleDecoderAllocator;
 
+static float* 					decodeBlockSamples;
+static decodeBlock_t* 			decodeBlocks;
+static decodeBlock_t* 			freeDecodeBlocks;
+static idSampleDecoderLocal		decodeAheadList;		// sentinel, the decoders with blocks to decode ahead
+static xthreadInfo				decodeAheadThread;
+
 /*
 ====================
 idSampleDecoder::Init
@@ -344,6 +390,31 @@ void idSampleDecoder::Init()
 	decoderMemoryAllocator.Init();
 	decoderMemoryAllocator.SetLockMemory( true );
 	decoderMemoryAllocator.SetFixedBlocks( idSoundSystemLocal::s_realTimeDecoding.GetBool() ? 10 : 1 );
+
+	decodeAheadList.aheadNext = &decodeAheadList;
+	decodeAheadList.aheadPrev = &decodeAheadList;
+
+	int numBlocks = idSoundSystemLocal::s_decodeAheadBlocks.GetInteger();
+	if( numBlocks <= 0 )
+	{
+		return;
+	}
+
+	decodeBlockSamples = ( float* )Mem_Alloc16( numBlocks * DECODE_BLOCK_SAMPLES * sizeof( float ) );
+	decodeBlocks = ( decodeBlock_t* )Mem_Alloc( numBlocks * sizeof( decodeBlock_t ) );
+	freeDecodeBlocks = NULL;
+	for( int i = numBlocks - 1; i >= 0; i-- )
+	{
+		decodeBlocks[i].samples = decodeBlockSamples + i * DECODE_BLOCK_SAMPLES;
+		decodeBlocks[i].next = freeDecodeBlocks;
+		freeDecodeBlocks = &decodeBlocks[i];
+	}
+
+	// the thread stays around after a shutdown, waiting for decoders to show up again
+	if( !decodeAheadThread.threadHandle )
+	{
+		Sys_CreateThread( ( xthread_t )idSampleDecoderLocal::DecodeAheadThread, NULL, THREAD_NORMAL, decodeAheadThread, "decoder", g_threads, &g_thread_count );
+	}
 }
 
 /*
@@ -353,6 +424,21 @@ idSampleDecoder::Shutdown
 */
 void idSampleDecoder::Shutdown()
 {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+	while( decodeAheadList.aheadNext != &decodeAheadList )
+	{
+		decodeAheadList.aheadNext->StopDecodeAhead();
+	}
+	if( decodeBlocks )
+	{
+		Mem_Free( decodeBlocks );
+		Mem_Free16( decodeBlockSamples );
+		decodeBlocks = NULL;
+		decodeBlockSamples = NULL;
+		freeDecodeBlocks = NULL;
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
 	decoderMemoryAllocator.Shutdown();
 	sampleDecoderAllocator.Shutdown();
 }
@@ -413,6 +499,13 @@ void idSampleDecoderLocal::Clear()
 	lastSample = NULL;
 	lastSampleOffset = 0;
 	lastDecodeTime = 0;
+
+	aheadNext = NULL;
+	aheadPrev = NULL;
+	aheadFailed = false;
+	aheadOffset44k = 0;
+	aheadCount44k = 0;
+	numAheadBlocks = 0;
 }
 
 /*
@@ -424,6 +517,8 @@ void idSampleDecoderLocal::ClearDecoder()
 {
 	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 
+	StopDecodeAhead();
+
 	switch( lastFormat )
 	{
 		case WAVE_FORMAT_TAG_PCM:
@@ -488,6 +583,8 @@ void idSampleDecoderLocal::Decode( idSoundSample* sample, int sampleOffset44k, i
 	// samples can be decoded both from the sound thread and the main thread for shakes
 	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 
+	bool wakeDecodeThread = false;
+
 	switch( sample->objectInfo.wFormatTag )
 	{
 		case WAVE_FORMAT_TAG_PCM:
@@ -497,7 +594,35 @@ void idSampleDecoderLocal::Decode( idSoundSample* sample, int sampleOffset44k, i
 		}
 		case WAVE_FORMAT_TAG_OGG:
 		{
-			readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+			if( numAheadBlocks && aheadBlocks[0]->offset44k == sampleOffset44k && aheadCount44k == sampleCount44k )
+			{
+				// the decode thread got here first
+				decodeBlock_t* block = aheadBlocks[0];
+				readSamples44k = block->readSamples44k;
+				memcpy( dest, block->samples, readSamples44k * sizeof( dest[0] ) );
+
+				numAheadBlocks--;
+				memmove( aheadBlocks, aheadBlocks + 1, numAheadBlocks * sizeof( aheadBlocks[0] ) );
+				block->next = freeDecodeBlocks;
+				freeDecodeBlocks = block;
+
+				sample->decodeHits++;
+			}
+			else
+			{
+				StopDecodeAhead();
+
+				double start = Sys_GetClockTicks();
+				readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+				sample->decodeMsec += ( Sys_GetClockTicks() - start ) * 1000.0 / Sys_ClockTicksPerSecond();
+				sample->decodeMisses++;
+
+				if( !failed && readSamples44k == sampleCount44k )
+				{
+					StartDecodeAhead( sample, sampleOffset44k + sampleCount44k, sampleCount44k );
+				}
+			}
+			wakeDecodeThread = NeedsDecodeAhead();
 			break;
 		}
 		default:
@@ -509,6 +634,11 @@ void idSampleDecoderLocal::Decode( idSoundSample* sample, int sampleOffset44k, i
 
 	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
 
+	if( wakeDecodeThread )
+	{
+		Sys_TriggerEvent( TRIGGER_EVENT_FOUR );
+	}
+
 	if( readSamples44k < sampleCount44k )
 	{
 		memset( dest + readSamples44k, 0, ( sampleCount44k - readSamples44k ) * sizeof( dest[0] ) );
@@ -639,3 +769,152 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample* sample, int sampleOffset44k,
 
 	return ( readSamples << shift );
 }
+
+/*
+====================
+idSampleDecoderLocal::StartDecodeAhead
+
+Puts the decoder on the decode thread's list, expecting the mixer to ask for
+sampleCount44k samples at sampleOffset44k next, called with CRITICAL_SECTION_ONE held
+====================
+*/
+void idSampleDecoderLocal::StartDecodeAhead( idSoundSample* sample, int sampleOffset44k, int sampleCount44k )
+{
+	if( !decodeBlocks || sampleCount44k > DECODE_BLOCK_SAMPLES )
+	{
+		return;
+	}
+
+	aheadFailed = false;
+	aheadOffset44k = sampleOffset44k;
+	aheadCount44k = sampleCount44k;
+
+	if( !aheadNext )
+	{
+		aheadNext = &decodeAheadList;
+		aheadPrev = decodeAheadList.aheadPrev;
+		aheadPrev->aheadNext = this;
+		decodeAheadList.aheadPrev = this;
+	}
+}
+
+/*
+====================
+idSampleDecoderLocal::StopDecodeAhead
+
+Drops the blocks decoded ahead and takes the decoder off the decode thread's list,
+called with CRITICAL_SECTION_ONE held
+====================
+*/
+void idSampleDecoderLocal::StopDecodeAhead()
+{
+	for( int i = 0; i < numAheadBlocks; i++ )
+	{
+		aheadBlocks[i]->next = freeDecodeBlocks;
+		freeDecodeBlocks = aheadBlocks[i];
+	}
+	numAheadBlocks = 0;
+
+	if( aheadNext )
+	{
+		aheadNext->aheadPrev = aheadPrev;
+		aheadPrev->aheadNext = aheadNext;
+		aheadNext = NULL;
+		aheadPrev = NULL;
+	}
+}
+
+/*
+====================
+idSampleDecoderLocal::NeedsDecodeAhead
+====================
+*/
+bool idSampleDecoderLocal::NeedsDecodeAhead() const
+{
+	if( !aheadNext || aheadFailed || !freeDecodeBlocks || numAheadBlocks >= DECODE_AHEAD_BLOCKS )
+	{
+		return false;
+	}
+	if( !lastSample || lastSample->purged || !lastSample->nonCacheData )
+	{
+		return false;
+	}
+	// never decode past the end, that marks the decoder as failed
+	return ( aheadOffset44k + aheadCount44k <= lastSample->LengthIn44kHzSamples() );
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodeAheadBlock
+
+Decodes the next block ahead on the decode thread, called with CRITICAL_SECTION_ONE held
+====================
+*/
+void idSampleDecoderLocal::DecodeAheadBlock()
+{
+	decodeBlock_t* block = freeDecodeBlocks;
+	freeDecodeBlocks = block->next;
+
+	double start = Sys_GetClockTicks();
+	block->offset44k = aheadOffset44k;
+	block->readSamples44k = DecodeOGG( lastSample, aheadOffset44k, aheadCount44k, block->samples );
+	lastSample->decodeMsec += ( Sys_GetClockTicks() - start ) * 1000.0 / Sys_ClockTicksPerSecond();
+
+	if( failed || block->readSamples44k < aheadCount44k )
+	{
+		// leave the error to the mixer, it decodes this part itself
+		failed = false;
+		aheadFailed = true;
+		block->next = freeDecodeBlocks;
+		freeDecodeBlocks = block;
+		return;
+	}
+
+	aheadBlocks[numAheadBlocks++] = block;
+	aheadOffset44k += aheadCount44k;
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodeAheadThread
+
+Decodes one block at a time for the first decoder that wants one, and moves
+it to the end of the list so every channel gets its turn. The lock is only held
+for a single block, so the mixer never waits long on it.
+====================
+*/
+int idSampleDecoderLocal::DecodeAheadThread( void* parm )
+{
+	while( 1 )
+	{
+		idSampleDecoderLocal* decoder = NULL;
+
+		Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+		for( idSampleDecoderLocal* d = decodeAheadList.aheadNext; d != &decodeAheadList; d = d->aheadNext )
+		{
+			if( d->NeedsDecodeAhead() )
+			{
+				decoder = d;
+				break;
+			}
+		}
+		if( decoder )
+		{
+			decoder->DecodeAheadBlock();
+
+			decoder->aheadNext->aheadPrev = decoder->aheadPrev;
+			decoder->aheadPrev->aheadNext = decoder->aheadNext;
+			decoder->aheadNext = &decodeAheadList;
+			decoder->aheadPrev = decodeAheadList.aheadPrev;
+			decoder->aheadPrev->aheadNext = decoder;
+			decodeAheadList.aheadPrev = decoder;
+		}
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+		if( !decoder )
+		{
+			Sys_WaitForEvent( TRIGGER_EVENT_FOUR );
+		}
+	}
+	return 0;
+}
@@ -627,6 +627,20 @@ typedef struct soundPortalTrace_s
 	const struct soundPortalTrace_s*	prevStack;
 } soundPortalTrace_t;
 
+// a portal seen from one of its areas, in the order idRenderWorld::GetPortal returns them
+typedef struct
+{
+	int					area;
+	int					otherArea;
+	int					reverse;			// the same portal seen from otherArea
+	int					firstGap;			// distances to the portals of area, in graphGaps
+	const idWinding*	w;					// to notice a new map
+	int					blockingBits;
+	idBounds			bounds;
+	float				bound;				// nothing entering otherArea here reaches the listener in less
+	bool				queued;
+} soundGraphExit_t;
+
 class idSoundWorldLocal : public idSoundWorld
 {
 public:
@@ -699,11 +713,15 @@ public:
 
 	idSoundEmitterLocal* 	AllocLocalSoundEmitter();
 	void					CalcEars( int numSpeakers, idVec3 realOrigin, idVec3 listenerPos, idMat3 listenerAxis, float ears[6], float spatialize );
-	void					AddChannelContribution( idSoundEmitterLocal* sound, idSoundChannel* chan,
+	bool					AddChannelContribution( idSoundEmitterLocal* sound, idSoundChannel* chan,
 			int current44kHz, int numSpeakers, float* finalMixBuffer );
+	int						MixEmitters( int firstEmitter, int numEmitters, int current44kHz, int numSpeakers, float* finalMixBuffer );
+	void					MixLoopJobs( int current44kHz, int numSpeakers, float* finalMixBuffer, int mixThreshold );
 	void					MixLoop( int current44kHz, int numSpeakers, float* finalMixBuffer );
 	void					AVIUpdate();
 	void					ResolveOrigin( const int stackDepth, const soundPortalTrace_t* prevStack, const int soundArea, const float dist, const idVec3& soundOrigin, idSoundEmitterLocal* def );
+	void					BuildPortalGraph();
+	void					UpdatePortalGraph();
 	float					FindAmplitude( idSoundEmitterLocal* sound, const int localTime, const idVec3* listenerPosition, const s_channelType channel, bool shakesOnly );
 
 	//============================================
@@ -726,6 +744,16 @@ public:
 
 	idList<idSoundEmitterLocal*>emitters;
 
+	// lower bounds of the portal distances to the listener, so ResolveOrigin
+	// only follows the portal chains that can still beat the best one found
+	idList<soundGraphExit_t>	graphExits;
+	idList<int>				graphAreaExits;		// first exit of each area, numAreas + 1 entries
+	idList<float>			graphGaps;			// between the bounds of two portals of the same area
+	idList<float>			graphAreaBound;		// from anywhere in the area to the listener
+	idList<int>				graphQueue;
+	int						graphListenerArea;	// -1 if the bounds aren't valid
+	float					graphDoorDistance;
+
 	idSoundFade				soundClassFade[SOUND_MAX_CLASSES];	// for global sound fading
 
 	// avi stuff
@@ -890,6 +918,8 @@ public:
 	static idCVar			s_force22kHz;
 	static idCVar			s_clipVolumes;
 	static idCVar			s_realTimeDecoding;
+	static idCVar			s_mixJobThreshold;
+	static idCVar			s_decodeAheadBlocks;
 	static idCVar			s_libOpenAL;
 	static idCVar			s_useOpenAL;
 	static idCVar			s_useEAXReverb;
@@ -943,10 +973,15 @@ public:
 	bool					purged;
 	bool					levelLoadReferenced;		// so we can tell which samples aren't needed any more
 
+	int						decodeHits;					// mixer requests the decode thread had ready
+	int						decodeMisses;				// mixer requests decoded on the mixer thread
+	float					decodeMsec;					// time spent decoding on either thread
+
 	int						LengthIn44kHzSamples() const;
 	ID_TIME_T		 			GetNewTimeStamp() const;
 	void					MakeDefault();				// turns it into a beep
 	void					Load();						// loads the current sound based on name
+	void					LoadData();					// does the loading for Load while the sample reads as purged
 	void					Reload( bool force );		// reloads if timestamp has changed, or always if force
 	void					PurgeSoundSample();			// frees all data
 	void					CheckForDownSample();		// down sample if required
@@ -60,6 +60,8 @@ idCVar idSoundSystemLocal::s_numberOfSpeakers( "s_numberOfSpeakers", "2", CVAR_S
 idCVar idSoundSystemLocal::s_force22kHz( "s_force22kHz", "0", CVAR_SOUND | CVAR_BOOL, "" );
 idCVar idSoundSystemLocal::s_clipVolumes( "s_clipVolumes", "1", CVAR_SOUND | CVAR_BOOL, "" );
 idCVar idSoundSystemLocal::s_realTimeDecoding( "s_realTimeDecoding", "1", CVAR_SOUND | CVAR_BOOL | CVAR_INIT, "" );
+idCVar idSoundSystemLocal::s_decodeAheadBlocks( "s_decodeAheadBlocks", "256", CVAR_SOUND | CVAR_INTEGER | CVAR_INIT, "blocks of samples the decode thread may keep decoded ahead of the mixer for all OGG channels, 0 = decode on the mixer thread" );
+idCVar idSoundSystemLocal::s_mixJobThreshold( "s_mixJobThreshold", "32", CVAR_SOUND | CVAR_INTEGER, "mix the channels on the job threads when at least this many are playing, 0 = never" );
 
 idCVar idSoundSystemLocal::s_slowAttenuate( "s_slowAttenuate", "1", CVAR_SOUND | CVAR_BOOL, "slowmo sounds attenuate over shorted distance" );
 idCVar idSoundSystemLocal::s_enviroSuitCutoffFreq( "s_enviroSuitCutoffFreq", "2000", CVAR_SOUND | CVAR_FLOAT, "" );
@@ -158,6 +160,10 @@ void ListSounds_f( const idCmdArgs& args )
 		common->Printf( "%s %dkHz %6dms %5dkB %4s %s%s\n", stereo, sample->objectInfo.nSamplesPerSec / 1000,
 						soundSystemLocal.SamplesToMilliseconds( sample->LengthIn44kHzSamples() ),
 						sample->objectMemSize >> 10, format, sample->name.c_str(), defaulted );
+		if( sample->decodeHits || sample->decodeMisses )
+		{
+			common->Printf( "           %6d decoded ahead %6d on the mixer %8.2fms decoding\n", sample->decodeHits, sample->decodeMisses, sample->decodeMsec );
+		}
 
 		if( !sample->purged )
 		{
@@ -522,6 +528,9 @@ void idSoundSystemLocal::Shutdown()
 		}
 	}
 
+	// the decode thread reads the samples, stop it before they are freed
+	idSampleDecoder::Shutdown();
+
 	// destroy all the sounds (hardware buffers as well)
 	delete soundCache;
 	soundCache = NULL;
@@ -539,8 +548,6 @@ void idSoundSystemLocal::Shutdown()
 	}
 
 	Sys_FreeOpenAL();
-
-	idSampleDecoder::Shutdown();
 }
 
 /*
@@ -70,6 +70,9 @@ void idSoundWorldLocal::Init( idRenderWorld* renderWorld )
 
 	localSound = NULL;
 
+	graphListenerArea	= -1;
+	graphDoorDistance	= 0.0f;
+
 	slowmoActive		= false;
 	slowmoSpeed			= 0;
 	enviroSuitActive	= false;
@@ -121,6 +124,13 @@ void idSoundWorldLocal::Shutdown()
 		}
 	}
 	localSound = NULL;
+
+	graphExits.Clear();
+	graphAreaExits.Clear();
+	graphGaps.Clear();
+	graphAreaBound.Clear();
+	graphQueue.Clear();
+	graphListenerArea = -1;
 }
 
 /*
@@ -143,6 +153,11 @@ void idSoundWorldLocal::ClearAllSoundEmitters()
 	}
 	localSound = NULL;
 
+	// this is called when a new map is loaded, whose areas and portals can
+	// match the old one in number, so make UpdatePortalGraph start over
+	graphAreaExits.SetNum( 0, false );
+	graphListenerArea = -1;
+
 	Sys_LeaveCriticalSection();
 }
 
@@ -450,7 +465,7 @@ for AVIdemo writing
 */
 void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float* finalMixBuffer )
 {
-	int i, j;
+	int j;
 	idSoundEmitterLocal* sound;
 
 	// if noclip flying outside the world, leave silence
@@ -550,15 +565,48 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float* final
 					continue;
 				}
 
-				AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer );
+				if( AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer ) )
+				{
+					soundSystemLocal.soundStats.activeSounds++;
+				}
 			}
 		}
 		return;
 	}
 
-	for( i = 1; i < emitters.Num(); i++ )
+	// the OpenAL path talks to the AL context for every channel, so only the
+	// software mixer is split across the job threads
+	int mixThreshold = idSoundSystemLocal::s_mixJobThreshold.GetInteger();
+	if( idSoundSystemLocal::useOpenAL || mixThreshold <= 0 || !Sys_NumJobThreads() )
+	{
+		soundSystemLocal.soundStats.activeSounds += MixEmitters( 1, emitters.Num() - 1, current44kHz, numSpeakers, finalMixBuffer );
+	}
+	else
+	{
+		MixLoopJobs( current44kHz, numSpeakers, finalMixBuffer, mixThreshold );
+	}
+
+	if( !idSoundSystemLocal::useOpenAL && enviroSuitActive )
+	{
+		soundSystemLocal.DoEnviroSuit( finalMixBuffer, MIXBUFFER_SAMPLES, numSpeakers );
+	}
+}
+
+/*
+===================
+idSoundWorldLocal::MixEmitters
+
+Adds every triggered channel of the emitters in the range to finalMixBuffer,
+returns the number of channels that were mixed
+===================
+*/
+int idSoundWorldLocal::MixEmitters( int firstEmitter, int numEmitters, int current44kHz, int numSpeakers, float* finalMixBuffer )
+{
+	int activeSounds = 0;
+
+	for( int i = firstEmitter; i < firstEmitter + numEmitters; i++ )
 	{
-		sound = emitters[i];
+		idSoundEmitterLocal* sound = emitters[i];
 
 		if( !sound )
 		{
@@ -570,7 +618,7 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float* final
 			continue;
 		}
 		// run through all the channels
-		for( j = 0; j < SOUND_MAX_CHANNELS ; j++ )
+		for( int j = 0; j < SOUND_MAX_CHANNELS ; j++ )
 		{
 			idSoundChannel*	chan = &sound->channels[j];
 
@@ -581,13 +629,135 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float* final
 				continue;
 			}
 
-			AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer );
+			if( AddChannelContribution( sound, chan, current44kHz, numSpeakers, finalMixBuffer ) )
+			{
+				activeSounds++;
+			}
 		}
 	}
+	return activeSounds;
+}
 
-	if( !idSoundSystemLocal::useOpenAL && enviroSuitActive )
+/*
+===================
+idSoundWorldLocal::MixLoopJobs
+
+Splits the emitters into ranges with about the same number of triggered channels
+and mixes each range on a job thread into its own buffer, the buffers are summed
+into finalMixBuffer afterwards. An emitter is always mixed by a single job, so its
+channels and slowmo state are never shared between threads, and the decoders
+already serialize themselves.
+===================
+*/
+const int MAX_MIX_JOBS = 8;
+
+typedef struct
+{
+	idSoundWorldLocal*	world;
+	int					firstEmitter;
+	int					numEmitters;
+	int					current44kHz;
+	int					numSpeakers;
+	float*				mixBuffer;
+	int					activeSounds;
+} mixJob_t;
+
+static ALIGN16( float mixJobBuffers[MAX_MIX_JOBS - 1][MIXBUFFER_SAMPLES * 6] );
+
+static void MixEmittersJob( void* parms )
+{
+	mixJob_t* job = ( mixJob_t* )parms;
+
+	job->activeSounds = job->world->MixEmitters( job->firstEmitter, job->numEmitters, job->current44kHz, job->numSpeakers, job->mixBuffer );
+}
+
+void idSoundWorldLocal::MixLoopJobs( int current44kHz, int numSpeakers, float* finalMixBuffer, int mixThreshold )
+{
+	mixJob_t	jobs[MAX_MIX_JOBS];
+	int			i, j;
+
+	int numChannels = 0;
+	for( i = 1; i < emitters.Num(); i++ )
 	{
-		soundSystemLocal.DoEnviroSuit( finalMixBuffer, MIXBUFFER_SAMPLES, numSpeakers );
+		idSoundEmitterLocal* sound = emitters[i];
+		if( sound && sound->playing )
+		{
+			for( j = 0; j < SOUND_MAX_CHANNELS; j++ )
+			{
+				if( sound->channels[j].triggerState )
+				{
+					numChannels++;
+				}
+			}
+		}
+	}
+
+	int numJobs = idMath::ClampInt( 1, MAX_MIX_JOBS, Sys_NumJobThreads() + 1 );
+	if( numChannels < mixThreshold || numJobs == 1 )
+	{
+		soundSystemLocal.soundStats.activeSounds += MixEmitters( 1, emitters.Num() - 1, current44kHz, numSpeakers, finalMixBuffer );
+		return;
+	}
+
+	// cut the emitter list where each range has its share of the channels,
+	// the last range takes whatever is left
+	int maxJobs = numJobs;
+	int channelsPerJob = ( numChannels + maxJobs - 1 ) / maxJobs;
+	int jobChannels = 0;
+	numJobs = 0;
+	jobs[0].firstEmitter = 1;
+	for( i = 1; i < emitters.Num(); i++ )
+	{
+		idSoundEmitterLocal* sound = emitters[i];
+		if( sound && sound->playing )
+		{
+			for( j = 0; j < SOUND_MAX_CHANNELS; j++ )
+			{
+				if( sound->channels[j].triggerState )
+				{
+					jobChannels++;
+				}
+			}
+		}
+		if( ( jobChannels >= channelsPerJob && numJobs < maxJobs - 1 ) || i == emitters.Num() - 1 )
+		{
+			jobs[numJobs].numEmitters = i + 1 - jobs[numJobs].firstEmitter;
+			numJobs++;
+			if( numJobs < maxJobs )
+			{
+				jobs[numJobs].firstEmitter = i + 1;
+			}
+			jobChannels = 0;
+		}
+	}
+
+	// the first job adds straight into the final buffer
+	for( i = 0; i < numJobs; i++ )
+	{
+		jobs[i].world = this;
+		jobs[i].current44kHz = current44kHz;
+		jobs[i].numSpeakers = numSpeakers;
+		jobs[i].activeSounds = 0;
+		if( i == 0 )
+		{
+			jobs[i].mixBuffer = finalMixBuffer;
+		}
+		else
+		{
+			jobs[i].mixBuffer = mixJobBuffers[i - 1];
+			SIMDProcessor->Memset( jobs[i].mixBuffer, 0, MIXBUFFER_SAMPLES * sizeof( float ) * numSpeakers );
+		}
+	}
+
+	Sys_RunJobs( MixEmittersJob, jobs, sizeof( jobs[0] ), numJobs );
+
+	for( i = 0; i < numJobs; i++ )
+	{
+		if( i > 0 )
+		{
+			SIMDProcessor->Add( finalMixBuffer, finalMixBuffer, jobs[i].mixBuffer, MIXBUFFER_SAMPLES * numSpeakers );
+		}
+		soundSystemLocal.soundStats.activeSounds += jobs[i].activeSounds;
 	}
 }
 
@@ -821,6 +991,13 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		return;
 	}
 
+	bool useGraph = ( graphListenerArea == listenerArea && soundArea < graphAreaBound.Num() );
+	if( useGraph && dist + graphAreaBound[soundArea] >= def->distance )
+	{
+		// every way out of here is too long
+		return;
+	}
+
 	if( soundArea == listenerArea )
 	{
 		float	fullDist = dist + ( soundOrigin - listenerQU ).LengthFast();
@@ -864,6 +1041,16 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 			otherArea = re.areas[1];
 		}
 
+		float exitBound = 0.0f;
+		if( useGraph )
+		{
+			exitBound = graphExits[ graphAreaExits[soundArea] + p ].bound;
+			if( dist + occlusionDistance + exitBound >= def->distance )
+			{
+				continue;
+			}
+		}
+
 		// if this area is already in our portal chain, don't bother looking into it
 		const soundPortalTrace_t* prev;
 		for( prev = prevStack ; prev ; prev = prev->prevStack )
@@ -978,11 +1165,219 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		idVec3 tlen = source - soundOrigin;
 		float tlenLength = tlen.LengthFast();
 
+		if( dist + tlenLength + occlusionDistance + exitBound >= def->distance )
+		{
+			continue;
+		}
+
 		ResolveOrigin( stackDepth + 1, &newStack, otherArea, dist + tlenLength + occlusionDistance, source, def );
 	}
 }
 
 
+/*
+===================
+idSoundWorldLocal::BuildPortalGraph
+
+Lists every portal from both of its areas with the distances between the
+portals of each area, which only change with the map
+===================
+*/
+static float BoundsGap( const idBounds& a, const idBounds& b )
+{
+	idVec3 gap;
+
+	for( int i = 0 ; i < 3 ; i++ )
+	{
+		gap[i] = Max( 0.0f, Max( a[0][i] - b[1][i], b[0][i] - a[1][i] ) );
+	}
+	return gap.Length();
+}
+
+void idSoundWorldLocal::BuildPortalGraph()
+{
+	int numAreas = rw->NumAreas();
+
+	graphExits.SetNum( 0, false );
+	graphAreaExits.SetNum( numAreas + 1, false );
+	graphGaps.SetNum( 0, false );
+	graphAreaBound.SetNum( numAreas, false );
+
+	for( int area = 0 ; area < numAreas ; area++ )
+	{
+		graphAreaExits[area] = graphExits.Num();
+
+		int numPortals = rw->NumPortalsInArea( area );
+		for( int p = 0 ; p < numPortals ; p++ )
+		{
+			exitPortal_t re = rw->GetPortal( area, p );
+
+			soundGraphExit_t& exit = graphExits.Alloc();
+			exit.area = area;
+			exit.otherArea = ( re.areas[0] == area ) ? re.areas[1] : re.areas[0];
+			exit.reverse = -1;
+			exit.w = re.w;
+			exit.blockingBits = re.blockingBits;
+			exit.bounds.Clear();
+			for( int i = 0 ; i < re.w->GetNumPoints() ; i++ )
+			{
+				exit.bounds.AddPoint( ( *re.w )[i].ToVec3() );
+			}
+			// ResolveOrigin slides its points into the portal one edge at a time,
+			// which can leave them a little outside on odd shaped portals
+			exit.bounds.ExpandSelf( 16.0f );
+		}
+	}
+	graphAreaExits[numAreas] = graphExits.Num();
+
+	for( int area = 0 ; area < numAreas ; area++ )
+	{
+		int first = graphAreaExits[area];
+		int num = graphAreaExits[area + 1] - first;
+
+		for( int i = 0 ; i < num ; i++ )
+		{
+			soundGraphExit_t& exit = graphExits[first + i];
+
+			// the portal is listed under the same handle from the other side
+			exitPortal_t re = rw->GetPortal( area, i );
+			int otherFirst = graphAreaExits[exit.otherArea];
+			for( int j = 0 ; j < graphAreaExits[exit.otherArea + 1] - otherFirst ; j++ )
+			{
+				if( rw->GetPortal( exit.otherArea, j ).portalHandle == re.portalHandle )
+				{
+					exit.reverse = otherFirst + j;
+					break;
+				}
+			}
+
+			exit.firstGap = graphGaps.Num();
+			for( int j = 0 ; j < num ; j++ )
+			{
+				graphGaps.Append( BoundsGap( exit.bounds, graphExits[first + j].bounds ) );
+			}
+		}
+	}
+
+	graphListenerArea = -1;
+}
+
+/*
+===================
+idSoundWorldLocal::UpdatePortalGraph
+
+Finds the lower bounds for the current listener area, again whenever a portal
+opens or closes. Sound entering an area through one portal has to cross the area
+to another portal, at least the gap between their bounds, and pays
+s_doorDistanceAdd for each closed one, until it enters the listener area.
+===================
+*/
+void idSoundWorldLocal::UpdatePortalGraph()
+{
+	int i, j;
+
+	if( !rw || listenerArea < 0 )
+	{
+		graphListenerArea = -1;
+		return;
+	}
+
+	int numAreas = rw->NumAreas();
+	bool rebuild = ( graphAreaExits.Num() != numAreas + 1 );
+	bool changed = ( graphListenerArea != listenerArea || graphDoorDistance != idSoundSystemLocal::s_doorDistanceAdd.GetFloat() );
+
+	for( i = 0 ; i < numAreas && !rebuild ; i++ )
+	{
+		int first = graphAreaExits[i];
+		if( rw->NumPortalsInArea( i ) != graphAreaExits[i + 1] - first )
+		{
+			rebuild = true;
+			break;
+		}
+		for( j = first ; j < graphAreaExits[i + 1] ; j++ )
+		{
+			exitPortal_t re = rw->GetPortal( i, j - first );
+			if( re.w != graphExits[j].w )
+			{
+				rebuild = true;
+				break;
+			}
+			if( re.blockingBits != graphExits[j].blockingBits )
+			{
+				graphExits[j].blockingBits = re.blockingBits;
+				changed = true;
+			}
+		}
+	}
+
+	if( rebuild )
+	{
+		BuildPortalGraph();
+		changed = true;
+	}
+	if( !changed )
+	{
+		return;
+	}
+
+	graphListenerArea = listenerArea;
+	graphDoorDistance = idSoundSystemLocal::s_doorDistanceAdd.GetFloat();
+
+	// work back from the portals into the listener area
+	graphQueue.SetNum( 0, false );
+	for( i = 0 ; i < graphExits.Num() ; i++ )
+	{
+		soundGraphExit_t& exit = graphExits[i];
+		exit.queued = ( exit.otherArea == listenerArea );
+		exit.bound = exit.queued ? 0.0f : idMath::INFINITY;
+		if( exit.queued )
+		{
+			graphQueue.Append( i );
+		}
+	}
+
+	for( int head = 0 ; head < graphQueue.Num() ; head++ )
+	{
+		const soundGraphExit_t& out = graphExits[ graphQueue[head] ];
+		graphExits[ graphQueue[head] ].queued = false;
+
+		float occlusionDistance = ( out.blockingBits & ( PS_BLOCK_VIEW | PS_BLOCK_AIR ) ) ? graphDoorDistance : 0.0f;
+		int first = graphAreaExits[out.area];
+		int outIndex = graphQueue[head] - first;
+
+		// every portal into out.area can get here across the area
+		for( i = first ; i < graphAreaExits[out.area + 1] ; i++ )
+		{
+			int in = graphExits[i].reverse;
+			if( in < 0 || graphExits[in].otherArea == listenerArea )
+			{
+				continue;
+			}
+			float bound = graphGaps[ graphExits[i].firstGap + outIndex ] + occlusionDistance + out.bound;
+			if( bound < graphExits[in].bound )
+			{
+				graphExits[in].bound = bound;
+				if( !graphExits[in].queued )
+				{
+					graphExits[in].queued = true;
+					graphQueue.Append( in );
+				}
+			}
+		}
+	}
+
+	for( i = 0 ; i < numAreas ; i++ )
+	{
+		float bound = ( i == listenerArea ) ? 0.0f : idMath::INFINITY;
+		for( j = graphAreaExits[i] ; j < graphAreaExits[i + 1] ; j++ )
+		{
+			float occlusionDistance = ( graphExits[j].blockingBits & ( PS_BLOCK_VIEW | PS_BLOCK_AIR ) ) ? graphDoorDistance : 0.0f;
+			bound = Min( bound, occlusionDistance + graphExits[j].bound );
+		}
+		graphAreaBound[i] = bound;
+	}
+}
+
 /*
 ===================
 idSoundWorldLocal::PlaceListener
@@ -1088,6 +1483,8 @@ void idSoundWorldLocal::ForegroundUpdate( int current44kHzTime )
 		current44kHzTime = lastAVI44kHz;
 	}
 
+	UpdatePortalGraph();
+
 	//
 	// check to see if each sound is visible or not
 	// speed up by checking maxdistance to origin
@@ -1757,13 +2154,14 @@ void idSoundWorldLocal::CalcEars( int numSpeakers, idVec3 spatializedOrigin, idV
 idSoundWorldLocal::AddChannelContribution
 
 Adds the contribution of a single sound channel to finalMixBuffer
-this is called from the async thread
+this is called from the async thread, and from the job threads while it waits
+for them, returns false if the channel wasn't audible
 
 Mixes MIXBUFFER_SAMPLES samples starting at current44kHz sample time into
 finalMixBuffer
 ===============
 */
-void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSoundChannel* chan,
+bool idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSoundChannel* chan,
 		int current44kHz, int numSpeakers, float* finalMixBuffer )
 {
 	int j;
@@ -1781,13 +2179,13 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSo
 	idSoundSample* sample = chan->leadinSample;
 	if( sample == NULL )
 	{
-		return;
+		return false;
 	}
 
 	// if you don't want to hear all the beeps from missing sounds
 	if( sample->defaultSound && !idSoundSystemLocal::s_playDefaultSound.GetBool() )
 	{
-		return;
+		return false;
 	}
 
 	// get the actual shader
@@ -1796,7 +2194,7 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSo
 	// this might happen if the foreground thread just deleted the sound emitter
 	if( !shader )
 	{
-		return;
+		return false;
 	}
 
 	float maxd = parms->maxDistance;
@@ -1925,7 +2323,7 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSo
 	//
 	if( volume < SND_EPSILON && chan->lastVolume < SND_EPSILON )
 	{
-		return;
+		return false;
 	}
 	chan->lastVolume = volume;
 
@@ -2187,8 +2585,7 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal* sound, idSo
 
 	}
 
-	soundSystemLocal.soundStats.activeSounds++;
-
+	return true;
 }
 
 /*
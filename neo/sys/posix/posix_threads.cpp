@@ -268,6 +268,180 @@ const char* Sys_GetThreadName( int* index )
 	return "main";
 }
 
+/*
+======================================================
+parallel jobs
+the workers and the submitting thread pull jobs from the
+current list until it is empty, jobLock protects the list
+======================================================
+*/
+
+static xthreadInfo		jobThreads[ MAX_JOB_THREADS ];
+static int				numJobThreads;
+static pthread_mutex_t	jobLock;
+static pthread_mutex_t	jobSubmitLock;		// held while a list is running
+static pthread_cond_t	jobStartCond;
+static pthread_cond_t	jobDoneCond;
+static jobRun_t			jobFunction;
+static byte* 			jobParms;
+static int				jobParmSize;
+static int				jobCount;			// number of jobs in the current list
+static int				jobNext;			// next job to pick up
+static int				jobsDone;
+static bool				jobShutdown;
+
+/*
+==================
+Sys_JobThread
+==================
+*/
+static unsigned int Sys_JobThread( void* parms )
+{
+	pthread_mutex_lock( &jobLock );
+	while( !jobShutdown )
+	{
+		if( jobNext >= jobCount )
+		{
+			pthread_cond_wait( &jobStartCond, &jobLock );
+			continue;
+		}
+
+		jobRun_t function = jobFunction;
+		void* jobParm = jobParms + jobNext * jobParmSize;
+		jobNext++;
+
+		pthread_mutex_unlock( &jobLock );
+		function( jobParm );
+		pthread_mutex_lock( &jobLock );
+
+		if( ++jobsDone == jobCount )
+		{
+			pthread_cond_signal( &jobDoneCond );
+		}
+	}
+	pthread_mutex_unlock( &jobLock );
+
+	return 0;
+}
+
+/*
+==================
+Sys_StartJobThreads
+==================
+*/
+void Sys_StartJobThreads( int numThreads )
+{
+	if( numJobThreads )
+	{
+		return;
+	}
+
+	if( numThreads < 0 )
+	{
+		numThreads = sysconf( _SC_NPROCESSORS_ONLN ) - 1;
+	}
+	numThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, numThreads );
+
+	jobShutdown = false;
+	for( int i = 0; i < numThreads; i++ )
+	{
+		Sys_CreateThread( ( xthread_t )Sys_JobThread, NULL, THREAD_NORMAL, jobThreads[i], "Job", g_threads, &g_thread_count );
+	}
+	numJobThreads = numThreads;
+
+	common->Printf( "%d job threads started\n", numJobThreads );
+}
+
+/*
+==================
+Sys_ShutdownJobThreads
+==================
+*/
+void Sys_ShutdownJobThreads()
+{
+	if( !numJobThreads )
+	{
+		return;
+	}
+
+	pthread_mutex_lock( &jobLock );
+	jobShutdown = true;
+	pthread_cond_broadcast( &jobStartCond );
+	pthread_mutex_unlock( &jobLock );
+
+	// the workers return by themselves, so don't cancel them like Sys_DestroyThread
+	for( int i = 0; i < numJobThreads; i++ )
+	{
+		pthread_join( ( pthread_t )jobThreads[i].threadHandle, NULL );
+		jobThreads[i].threadHandle = 0;
+	}
+	numJobThreads = 0;
+}
+
+/*
+==================
+Sys_NumJobThreads
+==================
+*/
+int Sys_NumJobThreads()
+{
+	return numJobThreads;
+}
+
+/*
+==================
+Sys_RunJobs
+==================
+*/
+void Sys_RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs )
+{
+	int i;
+
+	// run everything on the calling thread if nothing can help, or if a list is
+	// already running, which also covers jobs that submit jobs themselves
+	if( numJobThreads == 0 || numJobs <= 1 || pthread_mutex_trylock( &jobSubmitLock ) != 0 )
+	{
+		for( i = 0; i < numJobs; i++ )
+		{
+			function( ( byte* )parms + i * parmSize );
+		}
+		return;
+	}
+
+	pthread_mutex_lock( &jobLock );
+	jobFunction = function;
+	jobParms = ( byte* )parms;
+	jobParmSize = parmSize;
+	jobCount = numJobs;
+	jobNext = 0;
+	jobsDone = 0;
+	pthread_cond_broadcast( &jobStartCond );
+
+	// help out until the list is empty
+	while( jobNext < jobCount )
+	{
+		void* jobParm = jobParms + jobNext * jobParmSize;
+		jobNext++;
+
+		pthread_mutex_unlock( &jobLock );
+		function( jobParm );
+		pthread_mutex_lock( &jobLock );
+
+		jobsDone++;
+	}
+
+	// wait for the jobs still running on the workers
+	while( jobsDone < jobCount )
+	{
+		pthread_cond_wait( &jobDoneCond, &jobLock );
+	}
+	jobCount = 0;
+	jobNext = 0;
+	pthread_mutex_unlock( &jobLock );
+
+	pthread_mutex_unlock( &jobSubmitLock );
+}
+
 /*
 =========================================================
 Async Thread
@@ -321,6 +495,12 @@ void Posix_InitPThreads()
 		waiting[i] = false;
 	}
 
+	// init the job list
+	pthread_mutex_init( &jobLock, NULL );
+	pthread_mutex_init( &jobSubmitLock, NULL );
+	pthread_cond_init( &jobStartCond, NULL );
+	pthread_cond_init( &jobDoneCond, NULL );
+
 	// init threads table
 	for( i = 0; i < MAX_THREADS; i++ )
 	{
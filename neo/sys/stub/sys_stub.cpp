@@ -69,6 +69,27 @@ void Sys_DestroyThread( xthreadInfo& info )
 {
 }
 
+void Sys_StartJobThreads( int numThreads )
+{
+}
+
+void Sys_ShutdownJobThreads()
+{
+}
+
+int Sys_NumJobThreads()
+{
+	return 0;
+}
+
+void Sys_RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs )
+{
+	for( int i = 0; i < numJobs; i++ )
+	{
+		function( ( byte* )parms + i * parmSize );
+	}
+}
+
 void	Sys_FlushCacheMemory( void* base, int bytes )
 {
 }
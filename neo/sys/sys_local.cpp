@@ -180,6 +180,16 @@ void idSysLocal::FPU_EnableExceptions( int exceptions )
 	Sys_FPU_EnableExceptions( exceptions );
 }
 
+int idSysLocal::NumJobThreads()
+{
+	return Sys_NumJobThreads();
+}
+
+void idSysLocal::RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs )
+{
+	Sys_RunJobs( function, parms, parmSize, numJobs );
+}
+
 /*
 =================
 Sys_TimeStampToStr
@@ -72,6 +72,9 @@ public:
 
 	virtual void			OpenURL( const char* url, bool quit );
 	virtual void			StartProcess( const char* exeName, bool quit );
+
+	virtual int				NumJobThreads();
+	virtual void			RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs );
 };
 
 #endif /* !__SYS_LOCAL__ */
@@ -56,6 +56,7 @@ If you have questions concerning this license or the applicable additional terms
 
 	#define ID_INLINE						__forceinline
 	#define ID_STATIC_TEMPLATE				static
+	#define ID_THREAD_LOCAL					__declspec( thread )
 
 	#define assertmem( x, y )				assert( _CrtIsValidPointer( x, y, true ) )
 
@@ -94,6 +95,7 @@ If you have questions concerning this license or the applicable additional terms
 
 	#define ID_INLINE						inline
 	#define ID_STATIC_TEMPLATE
+	#define ID_THREAD_LOCAL					__thread
 
 	#define assertmem( x, y )
 
@@ -128,6 +130,7 @@ If you have questions concerning this license or the applicable additional terms
 
 	#define ID_INLINE						inline
 	#define ID_STATIC_TEMPLATE
+	#define ID_THREAD_LOCAL					__thread
 
 	#define assertmem( x, y )
 
@@ -536,19 +539,32 @@ enum
 void				Sys_EnterCriticalSection( int index = CRITICAL_SECTION_ZERO );
 void				Sys_LeaveCriticalSection( int index = CRITICAL_SECTION_ZERO );
 
-const int MAX_TRIGGER_EVENTS		= 4;
+const int MAX_TRIGGER_EVENTS		= 5;
 
 enum
 {
 	TRIGGER_EVENT_ZERO = 0,
 	TRIGGER_EVENT_ONE,
 	TRIGGER_EVENT_TWO,
-	TRIGGER_EVENT_THREE
+	TRIGGER_EVENT_THREE,
+	TRIGGER_EVENT_FOUR
 };
 
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+// a fixed pool of worker threads helps the calling thread run lists of independent
+// jobs, Sys_RunJobs returns when all of them are done, the jobs are run on the calling
+// thread alone when there are no workers or another list is already running
+typedef void ( *jobRun_t )( void* );
+
+const int MAX_JOB_THREADS			= 8;
+
+void				Sys_StartJobThreads( int numThreads );	// -1 = one less than the number of processors
+void				Sys_ShutdownJobThreads();
+int					Sys_NumJobThreads();
+void				Sys_RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs );
+
 /*
 ==============================================================
 
@@ -592,6 +608,10 @@ public:
 
 	virtual void			OpenURL( const char* url, bool quit ) = 0;
 	virtual void			StartProcess( const char* exePath, bool quit ) = 0;
+
+	// lets the game use the job threads, see Sys_RunJobs
+	virtual int				NumJobThreads() = 0;
+	virtual void			RunJobs( jobRun_t function, void* parms, int parmSize, int numJobs ) = 0;
 };
 
 extern idSys* 				sys;
@@ -151,7 +151,7 @@ typedef struct
 	static idCVar	win_allowMultipleInstances;
 
 	CRITICAL_SECTION criticalSections[MAX_CRITICAL_SECTIONS];
-	HANDLE			backgroundDownloadSemaphore;
+	HANDLE			triggerEvents[MAX_TRIGGER_EVENTS];
 
 	HINSTANCE		hInstDI;			// direct input
 
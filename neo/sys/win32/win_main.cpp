@@ -182,12 +182,8 @@ Sys_WaitForEvent
 ==================
 */
 void Sys_WaitForEvent( int index ) {
-	assert( index == 0 );
-	if ( !win32.backgroundDownloadSemaphore ) {
-		win32.backgroundDownloadSemaphore = CreateEvent( NULL, TRUE, FALSE, NULL );
-	}
-	WaitForSingleObject( win32.backgroundDownloadSemaphore, INFINITE );
-	ResetEvent( win32.backgroundDownloadSemaphore );
+	assert( index >= 0 && index < MAX_TRIGGER_EVENTS );
+	WaitForSingleObject( win32.triggerEvents[index], INFINITE );
 }
 
 /*
@@ -196,12 +192,186 @@ Sys_TriggerEvent
 ==================
 */
 void Sys_TriggerEvent( int index ) {
-	assert( index == 0 );
-	SetEvent( win32.backgroundDownloadSemaphore );
+	assert( index >= 0 && index < MAX_TRIGGER_EVENTS );
+	SetEvent( win32.triggerEvents[index] );
 }
 
 
 
+/*
+======================================================
+parallel jobs
+the workers and the submitting thread pull jobs from the
+current list until it is empty, jobLock protects the list
+======================================================
+*/
+
+static xthreadInfo			jobThreads[ MAX_JOB_THREADS ];
+static int					numJobThreads;
+static CRITICAL_SECTION		jobLock;
+static HANDLE				jobStartSemaphore;	// released once per worker for every list
+static HANDLE				jobDoneEvent;		// set by the worker that finishes the last job
+static volatile LONG		jobSubmitted;		// set while a list is running
+static jobRun_t				jobFunction;
+static byte *				jobParms;
+static int					jobParmSize;
+static int					jobCount;			// number of jobs in the current list
+static int					jobNext;			// next job to pick up
+static int					jobsDone;
+static bool					jobShutdown;
+
+/*
+==================
+Sys_JobThread
+==================
+*/
+static unsigned int Sys_JobThread( void *parms ) {
+	while ( 1 ) {
+		WaitForSingleObject( jobStartSemaphore, INFINITE );
+		if ( jobShutdown ) {
+			break;
+		}
+
+		EnterCriticalSection( &jobLock );
+		while ( jobNext < jobCount ) {
+			jobRun_t function = jobFunction;
+			void *jobParm = jobParms + jobNext * jobParmSize;
+			jobNext++;
+
+			LeaveCriticalSection( &jobLock );
+			function( jobParm );
+			EnterCriticalSection( &jobLock );
+
+			if ( ++jobsDone == jobCount ) {
+				SetEvent( jobDoneEvent );
+			}
+		}
+		LeaveCriticalSection( &jobLock );
+	}
+
+	return 0;
+}
+
+/*
+==================
+Sys_StartJobThreads
+==================
+*/
+void Sys_StartJobThreads( int numThreads ) {
+	if ( numJobThreads ) {
+		return;
+	}
+
+	if ( numThreads < 0 ) {
+		SYSTEM_INFO info;
+		GetSystemInfo( &info );
+		numThreads = info.dwNumberOfProcessors - 1;
+	}
+	numThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, numThreads );
+	if ( !numThreads ) {
+		return;
+	}
+
+	InitializeCriticalSection( &jobLock );
+	jobStartSemaphore = CreateSemaphore( NULL, 0, 0x7fffffff, NULL );
+	jobDoneEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+	jobShutdown = false;
+	for ( int i = 0; i < numThreads; i++ ) {
+		Sys_CreateThread( (xthread_t)Sys_JobThread, NULL, THREAD_NORMAL, jobThreads[i], "Job", g_threads, &g_thread_count );
+	}
+	numJobThreads = numThreads;
+
+	common->Printf( "%d job threads started\n", numJobThreads );
+}
+
+/*
+==================
+Sys_ShutdownJobThreads
+==================
+*/
+void Sys_ShutdownJobThreads() {
+	if ( !numJobThreads ) {
+		return;
+	}
+
+	jobShutdown = true;
+	ReleaseSemaphore( jobStartSemaphore, numJobThreads, NULL );
+
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		Sys_DestroyThread( jobThreads[i] );
+	}
+	numJobThreads = 0;
+
+	CloseHandle( jobStartSemaphore );
+	CloseHandle( jobDoneEvent );
+	DeleteCriticalSection( &jobLock );
+}
+
+/*
+==================
+Sys_NumJobThreads
+==================
+*/
+int Sys_NumJobThreads() {
+	return numJobThreads;
+}
+
+/*
+==================
+Sys_RunJobs
+==================
+*/
+void Sys_RunJobs( jobRun_t function, void *parms, int parmSize, int numJobs ) {
+	int i;
+
+	// run everything on the calling thread if nothing can help, or if a list is
+	// already running, which also covers jobs that submit jobs themselves
+	if ( numJobThreads == 0 || numJobs <= 1 || InterlockedCompareExchange( &jobSubmitted, 1, 0 ) != 0 ) {
+		for ( i = 0; i < numJobs; i++ ) {
+			function( (byte *)parms + i * parmSize );
+		}
+		return;
+	}
+
+	EnterCriticalSection( &jobLock );
+	jobFunction = function;
+	jobParms = (byte *)parms;
+	jobParmSize = parmSize;
+	jobCount = numJobs;
+	jobNext = 0;
+	jobsDone = 0;
+	// the previous list may have finished on a worker without anyone waiting for it
+	ResetEvent( jobDoneEvent );
+	ReleaseSemaphore( jobStartSemaphore, numJobThreads, NULL );
+
+	// help out until the list is empty
+	while ( jobNext < jobCount ) {
+		void *jobParm = jobParms + jobNext * jobParmSize;
+		jobNext++;
+
+		LeaveCriticalSection( &jobLock );
+		function( jobParm );
+		EnterCriticalSection( &jobLock );
+
+		jobsDone++;
+	}
+
+	// wait for the jobs still running on the workers
+	bool wait = ( jobsDone < jobCount );
+	LeaveCriticalSection( &jobLock );
+	if ( wait ) {
+		WaitForSingleObject( jobDoneEvent, INFINITE );
+	}
+
+	EnterCriticalSection( &jobLock );
+	jobCount = 0;
+	jobNext = 0;
+	LeaveCriticalSection( &jobLock );
+
+	InterlockedExchange( &jobSubmitted, 0 );
+}
+
 #pragma optimize( "", on )
 
 #ifdef DEBUG
@@ -1393,6 +1563,11 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 		InitializeCriticalSection( &win32.criticalSections[i] );
 	}
 
+	// auto reset, a trigger without a waiter stays set until the next wait like the posix version
+	for ( int i = 0; i < MAX_TRIGGER_EVENTS; i++ ) {
+		win32.triggerEvents[i] = CreateEvent( NULL, FALSE, FALSE, NULL );
+	}
+
 	// get the initial time base
 	Sys_Milliseconds();
 
@@ -167,6 +167,7 @@ void DmapHelp()
 		"noCurves          = don't process curves\n"
 		"noCM              = don't create collision map\n"
 		"noAAS             = don't create AAS files\n"
+		"binaryProc        = also write a binary .bproc file\n"
 
 	);
 }
@@ -198,6 +199,7 @@ void ResetDmapGlobals()
 	dmapGlobals.noClipSides = false;
 	dmapGlobals.noLightCarve = false;
 	dmapGlobals.noShadow = false;
+	dmapGlobals.binaryProc = false;
 	dmapGlobals.shadowOptLevel = SO_NONE;
 	dmapGlobals.drawBounds.Clear();
 	dmapGlobals.drawflag = false;
@@ -330,6 +332,11 @@ void Dmap( const idCmdArgs& args )
 			noCM = true;
 			common->Printf( "noCM = true\n" );
 		}
+		else if( !idStr::Icmp( s, "binaryProc" ) )
+		{
+			dmapGlobals.binaryProc = true;
+			common->Printf( "binaryProc = true\n" );
+		}
 		else if( !idStr::Icmp( s, "noAAS" ) )
 		{
 			noAAS = true;
@@ -278,6 +278,7 @@ typedef struct
 	bool	noLightCarve;		// extra triangle subdivision by light frustums
 	shadowOptLevel_t	shadowOptLevel;
 	bool	noShadow;			// don't create optimized shadow volumes
+	bool	binaryProc;			// also write a binary .bproc file for faster loading
 
 	idBounds	drawBounds;
 	bool	drawflag;
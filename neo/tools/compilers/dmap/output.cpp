@@ -48,6 +48,7 @@ should we try and snap values very close to 0.5, 0.25, 0.125, etc ?
 #endif
 
 			static	idFile*	procFile;
+static	idFile*	bprocFile;		// optional binary copy of procFile
 
 #define	AREANUM_DIFFERENT	-2
 /*
@@ -103,6 +104,36 @@ static void WriteFloat( idFile* f, float v )
 	}
 }
 
+/*
+====================
+WriteBinaryFloats
+
+Writes the values WriteFloat's text reads back as, so the bproc file has
+exactly the same geometry as the proc file and the collision model
+====================
+*/
+static void WriteBinaryFloats( idFile* f, int x, const float* m )
+{
+	int		i;
+	float	v;
+	char	buf[64];
+
+	for( i = 0; i < x; i++ )
+	{
+		if( idMath::Fabs( m[i] - idMath::Rint( m[i] ) ) < 0.001 )
+		{
+			v = idMath::Rint( m[i] );
+		}
+		else
+		{
+			// the same precision FS_WriteFloatString gives %f
+			idStr::snPrintf( buf, sizeof( buf ), "%1.10f", m[i] );
+			v = ( float )atof( buf );
+		}
+		f->WriteFloat( v );
+	}
+}
+
 void Write1DMatrix( idFile* f, int x, float* m )
 {
 	int		i;
@@ -348,6 +379,37 @@ static void WriteUTriangles( const srfTriangles_t* uTris )
 }
 
 
+/*
+====================
+WriteBinaryUTriangles
+
+Writes binary verts and indexes to the bproc file
+====================
+*/
+static void WriteBinaryUTriangles( const srfTriangles_t* uTris )
+{
+	int			i;
+
+	bprocFile->WriteInt( uTris->numVerts );
+	bprocFile->WriteInt( uTris->numIndexes );
+
+	for( i = 0 ; i < uTris->numVerts ; i++ )
+	{
+		const idDrawVert* dv;
+
+		dv = &uTris->verts[i];
+
+		WriteBinaryFloats( bprocFile, 3, dv->xyz.ToFloatPtr() );
+		WriteBinaryFloats( bprocFile, 2, dv->st.ToFloatPtr() );
+		WriteBinaryFloats( bprocFile, 3, dv->normal.ToFloatPtr() );
+	}
+
+	for( i = 0 ; i < uTris->numIndexes ; i++ )
+	{
+		bprocFile->WriteInt( uTris->indexes[i] );
+	}
+}
+
 /*
 ====================
 WriteShadowTriangles
@@ -400,6 +462,34 @@ static void WriteShadowTriangles( const srfTriangles_t* tri )
 }
 
 
+/*
+====================
+WriteBinaryShadowTriangles
+
+Writes binary verts and indexes to the bproc file
+====================
+*/
+static void WriteBinaryShadowTriangles( const srfTriangles_t* tri )
+{
+	int			i;
+
+	bprocFile->WriteInt( tri->numVerts );
+	bprocFile->WriteInt( tri->numShadowIndexesNoCaps );
+	bprocFile->WriteInt( tri->numShadowIndexesNoFrontCaps );
+	bprocFile->WriteInt( tri->numIndexes );
+	bprocFile->WriteInt( tri->shadowCapPlaneBits );
+
+	for( i = 0 ; i < tri->numVerts ; i++ )
+	{
+		WriteBinaryFloats( bprocFile, 3, tri->shadowVertexes[i].xyz.ToFloatPtr() );
+	}
+
+	for( i = 0 ; i < tri->numIndexes ; i++ )
+	{
+		bprocFile->WriteInt( tri->indexes[i] );
+	}
+}
+
 /*
 =======================
 GroupsAreSurfaceCompatible
@@ -458,6 +548,12 @@ static void WriteOutputSurfaces( int entityNum, int areaNum )
 	{
 		procFile->WriteFloatString( "model { /* name = */ \"_area%i\" /* numSurfaces = */ %i\n\n",
 									areaNum, numSurfaces );
+		if( bprocFile )
+		{
+			bprocFile->WriteInt( BPROC_CHUNK_MODEL );
+			bprocFile->WriteString( va( "_area%i", areaNum ) );
+			bprocFile->WriteInt( numSurfaces );
+		}
 	}
 	else
 	{
@@ -470,6 +566,12 @@ static void WriteOutputSurfaces( int entityNum, int areaNum )
 		}
 		procFile->WriteFloatString( "model { /* name = */ \"%s\" /* numSurfaces = */ %i\n\n",
 									name, numSurfaces );
+		if( bprocFile )
+		{
+			bprocFile->WriteInt( BPROC_CHUNK_MODEL );
+			bprocFile->WriteString( name );
+			bprocFile->WriteInt( numSurfaces );
+		}
 	}
 
 	surfaceNum = 0;
@@ -543,12 +645,20 @@ static void WriteOutputSurfaces( int entityNum, int areaNum )
 		procFile->WriteFloatString( "/* surface %i */ { ", surfaceNum );
 		surfaceNum++;
 		procFile->WriteFloatString( "\"%s\" ", ambient->material->GetName() );
+		if( bprocFile )
+		{
+			bprocFile->WriteString( ambient->material->GetName() );
+		}
 
 		uTri = ShareMapTriVerts( ambient );
 		FreeTriList( ambient );
 
 		CleanupUTriangles( uTri );
 		WriteUTriangles( uTri );
+		if( bprocFile )
+		{
+			WriteBinaryUTriangles( uTri );
+		}
 		R_FreeStaticTriSurf( uTri );
 
 		procFile->WriteFloatString( "}\n\n" );
@@ -574,6 +684,12 @@ static void WriteNode_r( node_t* node )
 		// we shouldn't get here unless the entire world
 		// was a single leaf
 		procFile->WriteFloatString( "/* node 0 */ ( 0 0 0 0 ) -1 -1\n" );
+		if( bprocFile )
+		{
+			bprocFile->WriteVec4( vec4_zero );
+			bprocFile->WriteInt( -1 );
+			bprocFile->WriteInt( -1 );
+		}
 		return;
 	}
 
@@ -594,6 +710,12 @@ static void WriteNode_r( node_t* node )
 	procFile->WriteFloatString( "/* node %i */ ", node->nodeNumber );
 	Write1DMatrix( procFile, 4, plane->ToFloatPtr() );
 	procFile->WriteFloatString( "%i %i\n", child[0], child[1] );
+	if( bprocFile )
+	{
+		WriteBinaryFloats( bprocFile, 4, plane->ToFloatPtr() );
+		bprocFile->WriteInt( child[0] );
+		bprocFile->WriteInt( child[1] );
+	}
 
 	if( child[0] > 0 )
 	{
@@ -637,6 +759,11 @@ static void WriteOutputNodes( node_t* node )
 	procFile->WriteFloatString( "/* node format is: ( planeVector ) positiveChild negativeChild */\n" );
 	procFile->WriteFloatString( "/* a child number of 0 is an opaque, solid area */\n" );
 	procFile->WriteFloatString( "/* negative child numbers are areas: (-1-child) */\n" );
+	if( bprocFile )
+	{
+		bprocFile->WriteInt( BPROC_CHUNK_NODES );
+		bprocFile->WriteInt( numNodes );
+	}
 
 	WriteNode_r( node );
 
@@ -657,6 +784,12 @@ static void WriteOutputPortals( uEntity_t* e )
 	procFile->WriteFloatString( "interAreaPortals { /* numAreas = */ %i /* numIAP = */ %i\n\n",
 								e->numAreas, numInterAreaPortals );
 	procFile->WriteFloatString( "/* interAreaPortal format is: numPoints positiveSideArea negativeSideArea ( point) ... */\n" );
+	if( bprocFile )
+	{
+		bprocFile->WriteInt( BPROC_CHUNK_INTER_AREA_PORTALS );
+		bprocFile->WriteInt( e->numAreas );
+		bprocFile->WriteInt( numInterAreaPortals );
+	}
 	for( i = 0 ; i < numInterAreaPortals ; i++ )
 	{
 		iap = &interAreaPortals[i];
@@ -666,6 +799,16 @@ static void WriteOutputPortals( uEntity_t* e )
 		{
 			Write1DMatrix( procFile, 3, ( *w )[j].ToFloatPtr() );
 		}
+		if( bprocFile )
+		{
+			bprocFile->WriteInt( w->GetNumPoints() );
+			bprocFile->WriteInt( iap->area0 );
+			bprocFile->WriteInt( iap->area1 );
+			for( j = 0 ; j < w->GetNumPoints() ; j++ )
+			{
+				WriteBinaryFloats( bprocFile, 3, ( *w )[j].ToFloatPtr() );
+			}
+		}
 		procFile->WriteFloatString( "\n" );
 	}
 
@@ -737,6 +880,23 @@ void WriteOutputFile()
 
 	procFile->WriteFloatString( "%s\n\n", PROC_FILE_ID );
 
+	// optionally write a binary copy that the renderer can load without any parsing
+	bprocFile = NULL;
+	if( dmapGlobals.binaryProc )
+	{
+		idStr bpath;
+
+		sprintf( bpath, "%s." BPROC_FILE_EXT, dmapGlobals.mapFileBase );
+		common->Printf( "writing %s\n", bpath.c_str() );
+		bprocFile = fileSystem->OpenFileWrite( bpath, "fs_devpath" );
+		if( !bprocFile )
+		{
+			common->Error( "Error opening %s", bpath.c_str() );
+		}
+		bprocFile->WriteInt( BPROC_FILE_ID );
+		bprocFile->WriteInt( BPROC_FILE_VERSION );
+	}
+
 	// write the entity models and information, writing entities first
 	for( i = dmapGlobals.num_entities - 1 ; i >= 0 ; i-- )
 	{
@@ -761,6 +921,12 @@ void WriteOutputFile()
 
 		procFile->WriteFloatString( "shadowModel { /* name = */ \"_prelight_%s\"\n\n", light->name );
 		WriteShadowTriangles( light->shadowTris );
+		if( bprocFile )
+		{
+			bprocFile->WriteInt( BPROC_CHUNK_SHADOW_MODEL );
+			bprocFile->WriteString( va( "_prelight_%s", light->name ) );
+			WriteBinaryShadowTriangles( light->shadowTris );
+		}
 		procFile->WriteFloatString( "}\n\n" );
 
 		R_FreeStaticTriSurf( light->shadowTris );
@@ -768,4 +934,11 @@ void WriteOutputFile()
 	}
 
 	fileSystem->CloseFile( procFile );
+
+	if( bprocFile )
+	{
+		bprocFile->WriteInt( BPROC_CHUNK_END );
+		fileSystem->CloseFile( bprocFile );
+		bprocFile = NULL;
+	}
 }